@@ -0,0 +1,135 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/batch.h"
+#include <benchmark/benchmark.h>
+#include <optional>
+#include <vector>
+
+using namespace cr::math;
+
+template<size_t N>
+static std::vector<square_matrix<float, N>> random_matrices(size_t count) {
+    std::vector<square_matrix<float, N>> res(count);
+    unsigned seed = 1;
+    for (auto& mat : res) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                seed = seed * 1664525u + 1013904223u;
+                mat.access(i, j) = float(seed >> 8) / float(1 << 24) + (i == j ? float(N) : 0.0f);
+            }
+        }
+    }
+    return res;
+}
+
+template<size_t N>
+static void bm_inverse_each(benchmark::State& state) {
+    auto in = random_matrices<N>(state.range(0));
+    std::vector<std::optional<square_matrix<float, N>>> out(in.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < in.size(); i++) {
+            out[i] = inverse(in[i]);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<size_t N>
+static void bm_inverse_all(benchmark::State& state) {
+    auto in = random_matrices<N>(state.range(0));
+    std::vector<std::optional<square_matrix<float, N>>> out(in.size());
+    for (auto _ : state) {
+        inverse_all(in, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<size_t N>
+static void bm_multiply_each(benchmark::State& state) {
+    auto lhs = random_matrices<N>(state.range(0));
+    auto rhs = random_matrices<N>(state.range(0));
+    std::vector<square_matrix<float, N>> out(lhs.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < lhs.size(); i++) {
+            out[i] = lhs[i] * rhs[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<size_t N>
+static void bm_multiply_all(benchmark::State& state) {
+    auto lhs = random_matrices<N>(state.range(0));
+    auto rhs = random_matrices<N>(state.range(0));
+    std::vector<square_matrix<float, N>> out(lhs.size());
+    for (auto _ : state) {
+        multiply_all(lhs, rhs, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// data already kept in batch layout, no packing
+template<size_t N>
+static void bm_inverse_batch(benchmark::State& state) {
+    auto in = random_matrices<N>(state.range(0));
+    std::vector<square_matrix_batch<float, N>> batches;
+    for (size_t i = 0; i < in.size(); i += default_lanes<float>) {
+        batches.push_back(load_batch<default_lanes<float>>(in, i));
+    }
+    for (auto _ : state) {
+        for (auto& batch : batches) {
+            auto res = inverse(batch);
+            benchmark::DoNotOptimize(res);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<size_t N>
+static void bm_multiply_batch(benchmark::State& state) {
+    auto in = random_matrices<N>(state.range(0));
+    std::vector<square_matrix_batch<float, N>> batches;
+    for (size_t i = 0; i < in.size(); i += default_lanes<float>) {
+        batches.push_back(load_batch<default_lanes<float>>(in, i));
+    }
+    std::vector<square_matrix_batch<float, N>> out(batches.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < batches.size(); i++) {
+            out[i] = batches[i] * batches[i];
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+template<size_t N>
+static void bm_transform_all(benchmark::State& state) {
+    auto mats = random_matrices<N>(state.range(0));
+    std::vector<cvector<float, N>> vectors(mats.size(), cvector<float, N>{});
+    std::vector<cvector<float, N>> out(mats.size());
+    for (auto _ : state) {
+        transform_all(mats, vectors, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_inverse_each<3>)->Arg(4096);
+BENCHMARK(bm_inverse_all<3>)->Arg(4096);
+BENCHMARK(bm_inverse_batch<3>)->Arg(4096);
+BENCHMARK(bm_inverse_each<4>)->Arg(4096);
+BENCHMARK(bm_inverse_all<4>)->Arg(4096);
+BENCHMARK(bm_inverse_batch<4>)->Arg(4096);
+BENCHMARK(bm_multiply_each<3>)->Arg(4096);
+BENCHMARK(bm_multiply_all<3>)->Arg(4096);
+BENCHMARK(bm_multiply_batch<3>)->Arg(4096);
+BENCHMARK(bm_multiply_each<4>)->Arg(4096);
+BENCHMARK(bm_multiply_all<4>)->Arg(4096);
+BENCHMARK(bm_multiply_batch<4>)->Arg(4096);
+BENCHMARK(bm_transform_all<4>)->Arg(4096);
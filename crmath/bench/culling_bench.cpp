@@ -0,0 +1,148 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/culling.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace cr::math;
+
+// objects spread over an area nine times the view, so most of them are culled
+static std::vector<aabb> random_boxes(size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-1920, 3840);
+    std::uniform_real_distribution<float> size(4, 64);
+    std::vector<aabb> boxes;
+    for (size_t i = 0; i < count; i++) {
+        float x = position(rng);
+        float y = position(rng);
+        boxes.push_back({{x, y}, {x + size(rng), y + size(rng)}});
+    }
+    return boxes;
+}
+
+static const aabb view{{0, 0}, {1920, 1080}};
+
+// array of structures with a branch per object, what a draw loop testing each shape does
+static void bm_cull_aabb2_scalar(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    std::vector<uint32_t> out(boxes.size());
+    for (auto _ : state) {
+        size_t count = 0;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            if (boxes[i].intersects(view)) {
+                out[count++] = i;
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+
+static void bm_cull_aabb2(benchmark::State& state) {
+    aabb2_batch batch;
+    for (const auto& box : random_boxes(size_t(state.range(0)))) {
+        batch.push_back(box);
+    }
+    std::vector<uint32_t> out(batch.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cull(batch, view, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch.size()));
+}
+
+static void bm_cull_circle(benchmark::State& state) {
+    circle_batch batch;
+    for (const auto& box : random_boxes(size_t(state.range(0)))) {
+        batch.push_back(box.center(), box.extent()[0] / 2);
+    }
+    std::vector<uint32_t> out(batch.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cull(batch, view, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch.size()));
+}
+
+static square_matrix<float, 4> perspective() {
+    float n = 0.1f;
+    float f = 1000.0f;
+    return {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, f / (f - n), -f * n / (f - n), 0, 0, 1, 0};
+}
+
+static void bm_cull_aabb3_scalar(benchmark::State& state) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-500, 500);
+    std::vector<std::pair<cvector<float, 3>, cvector<float, 3>>> boxes;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        cvector<float, 3> min{position(rng), position(rng), position(rng)};
+        boxes.push_back({min, {min[0] + 2, min[1] + 2, min[2] + 2}});
+    }
+    auto f = frustum::from_matrix(perspective());
+    std::vector<uint32_t> out(boxes.size());
+    for (auto _ : state) {
+        size_t count = 0;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            bool inside = true;
+            for (const auto& plane : f.planes) {
+                float distance = plane[3];
+                for (size_t axis = 0; axis < 3; axis++) {
+                    distance += plane[axis] * (plane[axis] > 0 ? boxes[i].second[axis] : boxes[i].first[axis]);
+                }
+                if (distance < 0) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) {
+                out[count++] = i;
+            }
+        }
+        benchmark::DoNotOptimize(out.data());
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+
+static void bm_cull_aabb3(benchmark::State& state) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-500, 500);
+    aabb3_batch batch;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        cvector<float, 3> min{position(rng), position(rng), position(rng)};
+        batch.push_back(min, {min[0] + 2, min[1] + 2, min[2] + 2});
+    }
+    auto f = frustum::from_matrix(perspective());
+    std::vector<uint32_t> out(batch.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cull(batch, f, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch.size()));
+}
+
+static void bm_cull_sphere(benchmark::State& state) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-500, 500);
+    sphere_batch batch;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        batch.push_back({position(rng), position(rng), position(rng)}, 1.7f);
+    }
+    auto f = frustum::from_matrix(perspective());
+    std::vector<uint32_t> out(batch.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cull(batch, f, out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch.size()));
+}
+
+BENCHMARK(bm_cull_aabb2_scalar)->Arg(10000);
+BENCHMARK(bm_cull_aabb2)->Arg(10000);
+BENCHMARK(bm_cull_circle)->Arg(10000);
+BENCHMARK(bm_cull_aabb3_scalar)->Arg(10000);
+BENCHMARK(bm_cull_aabb3)->Arg(10000);
+BENCHMARK(bm_cull_sphere)->Arg(10000);
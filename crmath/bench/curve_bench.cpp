@@ -0,0 +1,40 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/curve.h"
+#include <benchmark/benchmark.h>
+
+using namespace cr::math;
+
+// the same S curve drawn range(0) pixels wide, the vertex count follows the size on screen
+static void bm_flatten_cubic(benchmark::State& state) {
+    float size = float(state.range(0));
+    cubic_bezier curve{{0, 0}, {0, size}, {size, 0}, {size, size}};
+    std::vector<curve_point> points;
+    for (auto _ : state) {
+        points.clear();
+        flatten(curve, 0.25f, points);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.counters["vertices"] = double(points.size());
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+
+static void bm_flatten_catmull_rom(benchmark::State& state) {
+    std::vector<curve_point> control;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        control.push_back({float(i) * 10, i % 2 == 0 ? 20.0f : -20.0f});
+    }
+    std::vector<curve_point> points;
+    for (auto _ : state) {
+        points.clear();
+        flatten_catmull_rom(control, 0.25f, points);
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.counters["vertices"] = double(points.size());
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+
+BENCHMARK(bm_flatten_cubic)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(bm_flatten_catmull_rom)->Arg(6)->Arg(1000);
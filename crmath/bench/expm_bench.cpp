@@ -0,0 +1,70 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/expm.h"
+#include <benchmark/benchmark.h>
+
+using namespace cr::math;
+
+// damped chain of coupled oscillators, x = (positions, velocities)
+template<size_t N>
+static square_matrix<double, N> oscillator_chain() {
+    constexpr size_t half = N / 2;
+    square_matrix<double, N> A{};
+    for (size_t i = 0; i < half; i++) {
+        A.access(i, half + i) = 1;
+        A.access(half + i, i) = -2;
+        if (i > 0) A.access(half + i, i - 1) = 1;
+        if (i + 1 < half) A.access(half + i, i + 1) = 1;
+        A.access(half + i, half + i) = -0.1;
+    }
+    return A;
+}
+
+template<size_t N>
+static void bm_expm(benchmark::State& state) {
+    auto A = oscillator_chain<N>() * 0.5;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(A);
+        auto res = expm(A);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<size_t N>
+static void bm_step_rk4(benchmark::State& state) {
+    auto A = oscillator_chain<N>();
+    cvector<double, N> b{};
+    b.access(N - 1, 0) = 1;
+    cvector<double, N> x{};
+    auto f = [&](const cvector<double, N>& s) { return A * s + b; };
+    for (auto _ : state) {
+        x = rk4(x, 0.01, f);
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+template<size_t N>
+static void bm_step_discretized(benchmark::State& state) {
+    auto A = oscillator_chain<N>();
+    cvector<double, N> b{};
+    b.access(N - 1, 0) = 1;
+    cvector<double, N> x{};
+    cached_discretization<double, N> discretization;
+    for (auto _ : state) {
+        x = discretization(A, b, 0.01)(x);
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+BENCHMARK(bm_expm<2>);
+BENCHMARK(bm_expm<4>);
+BENCHMARK(bm_expm<8>);
+BENCHMARK(bm_expm<16>);
+BENCHMARK(bm_step_rk4<2>);
+BENCHMARK(bm_step_rk4<8>);
+BENCHMARK(bm_step_rk4<16>);
+BENCHMARK(bm_step_discretized<2>);
+BENCHMARK(bm_step_discretized<8>);
+BENCHMARK(bm_step_discretized<16>);
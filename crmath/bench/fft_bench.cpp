@@ -0,0 +1,103 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/fft.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace cr::math;
+
+static std::vector<std::complex<double>> signal(size_t n) {
+    std::vector<std::complex<double>> res(n);
+    for (size_t i = 0; i < n; i++) {
+        res[i] = {std::sin(0.1 * double(i)), std::cos(0.37 * double(i))};
+    }
+    return res;
+}
+
+// the O(n^2) product with the dense DFT matrix, what crmath offered before
+template<size_t N>
+static void bm_dft_matrix(benchmark::State& state) {
+    auto dft = std::make_unique<square_matrix<std::complex<double>, N>>();
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            dft->access(i, j) = std::polar(1.0, -2.0 * std::numbers::pi * double(i * j % N) / double(N));
+        }
+    }
+    cvector<std::complex<double>, N> x;
+    auto data = signal(N);
+    for (size_t i = 0; i < N; i++) {
+        x[i] = data[i];
+    }
+    for (auto _ : state) {
+        auto res = *dft * x;
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<size_t N>
+static void bm_fft_cvector(benchmark::State& state) {
+    cvector<std::complex<double>, N> x;
+    auto data = signal(N);
+    for (size_t i = 0; i < N; i++) {
+        x[i] = data[i];
+    }
+    for (auto _ : state) {
+        auto res = fft(x);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+static void bm_fft(benchmark::State& state) {
+    auto data = signal(state.range(0));
+    auto plan = fft_plan<double>::get(data.size());
+    std::vector<std::complex<double>> out(data.size());
+    for (auto _ : state) {
+        plan->forward(data, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_fft_parallel(benchmark::State& state) {
+    auto data = signal(state.range(0));
+    auto plan = fft_plan<double>::get(data.size());
+    std::vector<std::complex<double>> out(data.size());
+    for (auto _ : state) {
+        plan->forward(data, out, fft_options{.threads = 0});
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_rfft(benchmark::State& state) {
+    std::vector<double> data(state.range(0));
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = std::sin(0.1 * double(i));
+    }
+    for (auto _ : state) {
+        auto res = rfft(std::span<const double>(data));
+        benchmark::DoNotOptimize(res.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_convolve(benchmark::State& state) {
+    std::vector<double> a(state.range(0), 1.0);
+    std::vector<double> b(state.range(0), 0.5);
+    for (auto _ : state) {
+        auto res = convolve(std::span<const double>(a), std::span<const double>(b));
+        benchmark::DoNotOptimize(res.data());
+    }
+}
+
+BENCHMARK(bm_dft_matrix<64>);
+BENCHMARK(bm_dft_matrix<256>);
+BENCHMARK(bm_fft_cvector<64>);
+BENCHMARK(bm_fft_cvector<256>);
+// powers of two, mixed radix and a prime size going through Bluestein
+BENCHMARK(bm_fft)->Arg(1024)->Arg(1000)->Arg(1021)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(bm_fft_parallel)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(bm_rfft)->Arg(1024)->Arg(1 << 16);
+BENCHMARK(bm_convolve)->Arg(256)->Arg(4096);
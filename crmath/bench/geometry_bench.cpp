@@ -0,0 +1,104 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/geometry.h"
+#include <benchmark/benchmark.h>
+#include <vector>
+
+using namespace cr::math;
+
+static void bm_rotation_matrix(benchmark::State& state) {
+    float angle = 0.3f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(angle);
+        auto m = rotation_matrix(angle);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_rotation_matrix_at(benchmark::State& state) {
+    float angle = 0.3f;
+    float x = 10.0f;
+    float y = 20.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(angle);
+        auto m = rotation_matrix_at(angle, x, y);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_rotation_matrix_3d(benchmark::State& state) {
+    float angle = 0.3f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(angle);
+        auto m = rotation_matrix_xy(with_translation, angle) *
+                 rotation_matrix_xz(with_translation, angle) *
+                 rotation_matrix_yz(with_translation, angle);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_scale_matrix(benchmark::State& state) {
+    float s = 2.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(s);
+        auto m = scale_matrix<float>(with_translation, s, s, s);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_translate_matrix(benchmark::State& state) {
+    float x = 1.0f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        auto m = translate_matrix<float>(x, x, x);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_translate_matrix_vector(benchmark::State& state) {
+    cvector<float, 3> position{1.0f, 2.0f, 3.0f};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(position);
+        auto m = translate_matrix(position);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+// the same chain crui builds for every drawn rectangle
+static void bm_model_matrix_2d(benchmark::State& state) {
+    float x = 10.0f;
+    float y = 20.0f;
+    float w = 30.0f;
+    float h = 40.0f;
+    auto window = translate_matrix<float>(-1.0f, 1.0f) * scale_matrix<float>(with_translation, 2.0f / 640, -2.0f / 480);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(x);
+        benchmark::DoNotOptimize(w);
+        square_matrix<float, 3> m = window * translate_matrix<float>(x, y) * scale_matrix<float>(with_translation, w, h);
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+static void bm_transform_points_2d(benchmark::State& state) {
+    auto rotation = rotation_matrix(0.3f);
+    cvector<float, 2> offset{5.0f, 6.0f};
+    std::vector<cvector<float, 2>> points(state.range(0), cvector<float, 2>{1.0f, 2.0f});
+    for (auto _ : state) {
+        for (auto& p : points) {
+            p = rotation * p + offset;
+        }
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_rotation_matrix);
+BENCHMARK(bm_rotation_matrix_at);
+BENCHMARK(bm_rotation_matrix_3d);
+BENCHMARK(bm_scale_matrix);
+BENCHMARK(bm_translate_matrix);
+BENCHMARK(bm_translate_matrix_vector);
+BENCHMARK(bm_model_matrix_2d);
+BENCHMARK(bm_transform_points_2d)->Arg(64)->Arg(4096);
@@ -0,0 +1,367 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/matrix.h"
+#include <benchmark/benchmark.h>
+
+using namespace cr::math;
+
+template<typename T, size_t N, size_t M>
+static matrix<T, N, M> filled_matrix(T offset = 0) {
+    matrix<T, N, M> res;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            // diagonally dominant, so determinant and inverse are well-defined
+            res.access(i, j) = (i == j ? T(N * M) : T(1) / T(1 + i + j)) + offset;
+        }
+    }
+    return res;
+}
+
+template<size_t N>
+static void bm_construct(benchmark::State& state) {
+    for (auto _ : state) {
+        matrix<float, N, N> m{};
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+template<size_t N>
+static void bm_identity(benchmark::State& state) {
+    for (auto _ : state) {
+        auto m = identity<float, N>();
+        benchmark::DoNotOptimize(m);
+    }
+}
+
+template<size_t N>
+static void bm_copy(benchmark::State& state) {
+    auto src = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(src);
+        matrix<float, N, N> copy = src;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+template<size_t N>
+static void bm_add(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto b = filled_matrix<float, N, N>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        auto res = a + b;
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<size_t N>
+static void bm_add_assign(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto b = filled_matrix<float, N, N>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(b);
+        a += b;
+        benchmark::DoNotOptimize(a);
+    }
+}
+
+template<size_t N>
+static void bm_scale(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    float s = 1.5f;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(s);
+        auto res = a * s;
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<size_t N>
+static void bm_multiply(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto b = filled_matrix<float, N, N>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        auto res = a * b;
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * N * N * N);
+}
+
+template<size_t N>
+static void bm_multiply_transposed_lhs(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto b = filled_matrix<float, N, N>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        auto res = a.transposed() * b;
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * N * N * N);
+}
+
+template<size_t N>
+static void bm_multiply_transposed_rhs(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto b = filled_matrix<float, N, N>(1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        auto res = a * b.transposed();
+        benchmark::DoNotOptimize(res);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * N * N * N);
+}
+
+template<size_t N>
+static void bm_multiply_vector(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    auto v = filled_matrix<float, N, 1>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(v);
+        auto res = a * v;
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<typename T, size_t N>
+static void bm_determinant(benchmark::State& state) {
+    auto a = filled_matrix<T, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto res = determinant(a);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+// tridiagonal with determinant N + 1, keeps the exact integer elimination free of overflow
+template<size_t N>
+static void bm_determinant_exact(benchmark::State& state) {
+    matrix<long, N, N> a{};
+    for (size_t i = 0; i < N; i++) {
+        a.access(i, i) = 2;
+        if (i > 0) a.access(i, i - 1) = -1;
+        if (i + 1 < N) a.access(i, i + 1) = -1;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto res = determinant(a);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<typename T, size_t N>
+static void bm_inverse(benchmark::State& state) {
+    auto a = filled_matrix<T, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto res = inverse(a);
+        benchmark::DoNotOptimize(res);
+    }
+}
+
+template<size_t N>
+static void bm_minor_access(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto view = a.minor(N / 2, N / 2);
+        float sum = 0;
+        for (size_t i = 0; i < N - 1; i++) {
+            for (size_t j = 0; j < N - 1; j++) {
+                sum += view.access(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * (N - 1) * (N - 1));
+}
+
+template<size_t N>
+static void bm_submatrix_access(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto view = a.template submatrix<N / 2, N / 2>(0, 0);
+        float sum = 0;
+        for (size_t i = 0; i < N / 2; i++) {
+            for (size_t j = 0; j < N / 2; j++) {
+                sum += view.access(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * (N / 2) * (N / 2));
+}
+
+// the bool mask view that submatrix returned before strided views
+template<size_t N>
+static void bm_submatrix_access_legacy(benchmark::State& state) {
+    using mat = matrix<float, N, N>;
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        typename mat::template matrix_view<N / 2, N / 2, mat> view{a};
+        for (size_t i = 0; i < N / 2; i++) {
+            view.used_rows[i] = true;
+            view.used_columns[i] = true;
+        }
+        float sum = 0;
+        for (size_t i = 0; i < N / 2; i++) {
+            for (size_t j = 0; j < N / 2; j++) {
+                sum += view.access(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * (N / 2) * (N / 2));
+}
+
+template<size_t N>
+static void bm_block_access(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        auto view = a.template block<N / 2, N / 2, N / 4, N / 4>();
+        float sum = 0;
+        for (size_t i = 0; i < N / 2; i++) {
+            for (size_t j = 0; j < N / 2; j++) {
+                sum += view.access(i, j);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * (N / 2) * (N / 2));
+}
+
+template<size_t N>
+static void bm_row_column_access_legacy(benchmark::State& state) {
+    using mat = matrix<float, N, N>;
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        float sum = 0;
+        for (size_t i = 0; i < N; i++) {
+            typename mat::template matrix_view<1, N, mat> row{a};
+            typename mat::template matrix_view<N, 1, mat> column{a};
+            row.used_rows[i] = true;
+            column.used_columns[i] = true;
+            for (size_t j = 0; j < N; j++) {
+                row.used_columns[j] = true;
+                column.used_rows[j] = true;
+            }
+            for (size_t j = 0; j < N; j++) {
+                sum += row.access(0, j) * column.access(j, 0);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * N * N);
+}
+
+template<size_t N>
+static void bm_row_column_access(benchmark::State& state) {
+    auto a = filled_matrix<float, N, N>();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        float sum = 0;
+        for (size_t i = 0; i < N; i++) {
+            auto row = a.row_vector(i);
+            auto column = a.column_vector(i);
+            for (size_t j = 0; j < N; j++) {
+                sum += row.access(0, j) * column.access(j, 0);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * N * N);
+}
+
+template<size_t N>
+static void bm_rk4(benchmark::State& state) {
+    auto A = filled_matrix<float, N, N>() * -0.01f;
+    auto b = filled_matrix<float, N, 1>();
+    auto x = filled_matrix<float, N, 1>();
+    auto f = [&](const cvector<float, N>& s) { return A * s + b; };
+    for (auto _ : state) {
+        x = rk4(x, 0.001f, f);
+        benchmark::DoNotOptimize(x);
+    }
+}
+
+BENCHMARK(bm_construct<2>);
+BENCHMARK(bm_construct<4>);
+BENCHMARK(bm_construct<16>);
+BENCHMARK(bm_identity<4>);
+BENCHMARK(bm_identity<16>);
+BENCHMARK(bm_copy<2>);
+BENCHMARK(bm_copy<4>);
+BENCHMARK(bm_copy<16>);
+
+BENCHMARK(bm_add<2>);
+BENCHMARK(bm_add<4>);
+BENCHMARK(bm_add<16>);
+BENCHMARK(bm_add_assign<4>);
+BENCHMARK(bm_add_assign<16>);
+BENCHMARK(bm_scale<4>);
+BENCHMARK(bm_scale<16>);
+
+BENCHMARK(bm_multiply<2>);
+BENCHMARK(bm_multiply<3>);
+BENCHMARK(bm_multiply<4>);
+BENCHMARK(bm_multiply<8>);
+BENCHMARK(bm_multiply<16>);
+BENCHMARK(bm_multiply_transposed_lhs<2>);
+BENCHMARK(bm_multiply_transposed_lhs<4>);
+BENCHMARK(bm_multiply_transposed_lhs<8>);
+BENCHMARK(bm_multiply_transposed_lhs<16>);
+BENCHMARK(bm_multiply_transposed_rhs<2>);
+BENCHMARK(bm_multiply_transposed_rhs<4>);
+BENCHMARK(bm_multiply_transposed_rhs<8>);
+BENCHMARK(bm_multiply_transposed_rhs<16>);
+BENCHMARK(bm_multiply_vector<4>);
+BENCHMARK(bm_multiply_vector<16>);
+
+BENCHMARK(bm_determinant<double, 2>);
+BENCHMARK(bm_determinant<double, 3>);
+BENCHMARK(bm_determinant<double, 4>);
+BENCHMARK(bm_determinant<double, 6>);
+BENCHMARK(bm_determinant<double, 8>);
+BENCHMARK(bm_determinant<long, 4>);
+BENCHMARK(bm_determinant<long, 8>);
+BENCHMARK(bm_determinant_exact<8>);
+BENCHMARK(bm_determinant_exact<16>);
+BENCHMARK(bm_determinant_exact<20>);
+BENCHMARK(bm_inverse<double, 2>);
+BENCHMARK(bm_inverse<double, 3>);
+BENCHMARK(bm_inverse<double, 4>);
+BENCHMARK(bm_inverse<double, 6>);
+BENCHMARK(bm_inverse<double, 8>);
+
+BENCHMARK(bm_minor_access<4>);
+BENCHMARK(bm_minor_access<8>);
+BENCHMARK(bm_minor_access<16>);
+BENCHMARK(bm_submatrix_access<4>);
+BENCHMARK(bm_submatrix_access<8>);
+BENCHMARK(bm_submatrix_access<16>);
+BENCHMARK(bm_submatrix_access_legacy<4>);
+BENCHMARK(bm_submatrix_access_legacy<8>);
+BENCHMARK(bm_submatrix_access_legacy<16>);
+BENCHMARK(bm_block_access<4>);
+BENCHMARK(bm_block_access<8>);
+BENCHMARK(bm_block_access<16>);
+BENCHMARK(bm_row_column_access<4>);
+BENCHMARK(bm_row_column_access<16>);
+BENCHMARK(bm_row_column_access_legacy<4>);
+BENCHMARK(bm_row_column_access_legacy<16>);
+
+BENCHMARK(bm_rk4<2>);
+BENCHMARK(bm_rk4<4>);
+BENCHMARK(bm_rk4<8>);
@@ -0,0 +1,99 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/matrix_io.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <vector>
+
+using namespace cr::math;
+
+using transform = square_matrix<float, 4>;
+
+static std::filesystem::path bench_file() {
+    return std::filesystem::temp_directory_path() / "crmath_matrix_io_bench.crm";
+}
+
+static std::vector<transform> transforms(size_t count) {
+    std::vector<transform> res(count, identity<float, 4>());
+    for (size_t i = 0; i < count; i++) {
+        res[i].access(0, 3) = float(i);
+    }
+    return res;
+}
+
+static void bm_write_binary(benchmark::State& state) {
+    auto data = transforms(state.range(0));
+    for (auto _ : state) {
+        matrix_writer<float, 4, 4> writer(bench_file());
+        writer.write(data);
+        writer.close();
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * int64_t(sizeof(transform)));
+}
+
+// what persisting through operator<< costs, without even parsing it back
+static void bm_write_text(benchmark::State& state) {
+    auto data = transforms(state.range(0));
+    for (auto _ : state) {
+        std::ostringstream out;
+        for (const auto& mat : data) {
+            out << mat << '\n';
+        }
+        benchmark::DoNotOptimize(out.str().data());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * int64_t(sizeof(transform)));
+}
+
+static void bm_open_mapped(benchmark::State& state) {
+    {
+        matrix_writer<float, 4, 4> writer(bench_file());
+        writer.write(transforms(state.range(0)));
+    }
+    for (auto _ : state) {
+        mapped_matrix_file<float, 4, 4> file(bench_file());
+        benchmark::DoNotOptimize(file.matrices().data());
+    }
+}
+
+static void bm_sum_mapped(benchmark::State& state) {
+    {
+        matrix_writer<float, 4, 4> writer(bench_file());
+        writer.write(transforms(state.range(0)));
+    }
+    for (auto _ : state) {
+        mapped_matrix_file<float, 4, 4> file(bench_file());
+        float sum = 0;
+        for (const auto& mat : file) {
+            sum += mat.access(0, 3);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * int64_t(sizeof(transform)));
+}
+
+static void bm_sum_chunked(benchmark::State& state) {
+    {
+        matrix_writer<float, 4, 4> writer(bench_file());
+        writer.write(transforms(state.range(0)));
+    }
+    std::vector<transform> chunk(4096);
+    for (auto _ : state) {
+        matrix_reader<float, 4, 4> reader(bench_file());
+        float sum = 0;
+        while (size_t count = reader.read(chunk)) {
+            for (size_t i = 0; i < count; i++) {
+                sum += chunk[i].access(0, 3);
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0) * int64_t(sizeof(transform)));
+}
+
+BENCHMARK(bm_write_binary)->Arg(1 << 16);
+BENCHMARK(bm_write_text)->Arg(1 << 16);
+BENCHMARK(bm_open_mapped)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(bm_sum_mapped)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(bm_sum_chunked)->Arg(1 << 16)->Arg(1 << 20);
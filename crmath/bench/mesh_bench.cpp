@@ -0,0 +1,83 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/mesh.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace cr::math;
+
+struct vertex {
+    cvector<float, 3> position;
+    cvector<float, 2> uv;
+};
+
+// triangle soup of a size x size grid in shuffled triangle order, like meshes straight out of an exporter
+static std::vector<vertex> shuffled_grid(size_t size) {
+    std::vector<std::array<vertex, 3>> triangles;
+    auto at = [&](size_t x, size_t y) {
+        return vertex{{float(x), float(y), std::sin(float(x) * 0.1f)}, {float(x) / float(size), float(y) / float(size)}};
+    };
+    for (size_t y = 0; y < size; y++) {
+        for (size_t x = 0; x < size; x++) {
+            triangles.push_back({at(x, y), at(x + 1, y), at(x, y + 1)});
+            triangles.push_back({at(x + 1, y), at(x + 1, y + 1), at(x, y + 1)});
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+    std::vector<vertex> res;
+    for (const auto& triangle: triangles) {
+        res.insert(res.end(), triangle.begin(), triangle.end());
+    }
+    return res;
+}
+
+static void report(benchmark::State& state, const indexed_mesh<vertex>& before, const indexed_mesh<vertex>& after) {
+    auto stats_before = analyze_vertex_cache(before.indices, before.vertices.size());
+    auto stats_after = analyze_vertex_cache(after.indices, after.vertices.size());
+    state.counters["acmr_before"] = stats_before.acmr;
+    state.counters["acmr_after"] = stats_after.acmr;
+    state.counters["atvr_after"] = stats_after.atvr;
+}
+
+static void bm_deduplicate(benchmark::State& state) {
+    auto soup = shuffled_grid(state.range(0));
+    for (auto _ : state) {
+        auto mesh = deduplicate(std::span<const vertex>(soup));
+        benchmark::DoNotOptimize(mesh.indices.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(soup.size()));
+}
+
+static void bm_optimize_vertex_cache(benchmark::State& state) {
+    auto mesh = deduplicate(std::span<const vertex>(shuffled_grid(state.range(0))));
+    indexed_mesh<vertex> optimized;
+    for (auto _ : state) {
+        optimized = mesh;
+        optimize_vertex_cache(optimized.indices, optimized.vertices.size());
+        benchmark::DoNotOptimize(optimized.indices.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(mesh.indices.size() / 3));
+    report(state, mesh, optimized);
+}
+
+static void bm_optimize_full(benchmark::State& state) {
+    auto soup = shuffled_grid(state.range(0));
+    indexed_mesh<vertex> mesh;
+    for (auto _ : state) {
+        mesh = deduplicate(std::span<const vertex>(soup));
+        optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+        optimize_overdraw(std::span<uint32_t>(mesh.indices), std::span<const vertex>(mesh.vertices),
+                          [](const vertex& v) { return v.position; });
+        optimize_vertex_fetch(mesh);
+        auto compact = compact_indices(mesh.indices);
+        benchmark::DoNotOptimize(compact);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(soup.size() / 3));
+    report(state, deduplicate(std::span<const vertex>(soup)), mesh);
+}
+
+BENCHMARK(bm_deduplicate)->Arg(64)->Arg(256);
+BENCHMARK(bm_optimize_vertex_cache)->Arg(64)->Arg(256);
+BENCHMARK(bm_optimize_full)->Arg(64)->Arg(256);
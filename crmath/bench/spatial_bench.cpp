@@ -0,0 +1,219 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/spatial.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+
+using namespace cr::math;
+
+// widget sized boxes scattered over a 4096 x 4096 area
+static std::vector<aabb> random_boxes(size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(0, 4096);
+    std::uniform_real_distribution<float> size(4, 64);
+    std::vector<aabb> boxes;
+    boxes.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        float x = position(rng);
+        float y = position(rng);
+        boxes.push_back({{x, y}, {x + size(rng), y + size(rng)}});
+    }
+    return boxes;
+}
+
+static std::vector<cvector<float, 2>> random_points(size_t count) {
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> position(0, 4096);
+    std::vector<cvector<float, 2>> points;
+    for (size_t i = 0; i < count; i++) {
+        points.push_back({position(rng), position(rng)});
+    }
+    return points;
+}
+
+static std::vector<ray> random_rays(size_t count) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(0, 4096);
+    std::uniform_real_distribution<float> angle(0, 6.2831853f);
+    std::vector<ray> rays;
+    for (size_t i = 0; i < count; i++) {
+        float a = angle(rng);
+        rays.push_back({{position(rng), position(rng)}, {std::cos(a), std::sin(a)}});
+    }
+    return rays;
+}
+
+static uniform_grid make_grid(const std::vector<aabb>& boxes) {
+    uniform_grid grid({{0, 0}, {4096, 4096}}, 64);
+    for (const auto& box : boxes) {
+        grid.insert(box);
+    }
+    return grid;
+}
+
+// what apply_all does today: every event is tested against every widget
+static void bm_point_query_linear(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    auto points = random_points(256);
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& p : points) {
+            for (const auto& box : boxes) {
+                hits += box.contains(p);
+            }
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+
+static void bm_point_query_grid(benchmark::State& state) {
+    auto grid = make_grid(random_boxes(size_t(state.range(0))));
+    auto points = random_points(256);
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& p : points) {
+            grid.query(p, [&](uint32_t) { hits++; });
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+
+static void bm_point_query_bvh(benchmark::State& state) {
+    bvh tree(random_boxes(size_t(state.range(0))));
+    auto points = random_points(256);
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& p : points) {
+            tree.query(p, [&](uint32_t) { hits++; });
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(points.size()));
+}
+
+// a 1920 x 1080 viewport, what off-screen culling asks once per frame
+static void bm_rect_query_linear(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    aabb view{{1000, 1000}, {2920, 2080}};
+    for (auto _ : state) {
+        size_t hits = 0;
+        for (const auto& box : boxes) {
+            hits += box.intersects(view);
+        }
+        benchmark::DoNotOptimize(hits);
+    }
+}
+
+static void bm_rect_query_grid(benchmark::State& state) {
+    auto grid = make_grid(random_boxes(size_t(state.range(0))));
+    aabb view{{1000, 1000}, {2920, 2080}};
+    for (auto _ : state) {
+        size_t hits = 0;
+        grid.query(view, [&](uint32_t) { hits++; });
+        benchmark::DoNotOptimize(hits);
+    }
+}
+
+static void bm_rect_query_bvh(benchmark::State& state) {
+    bvh tree(random_boxes(size_t(state.range(0))));
+    aabb view{{1000, 1000}, {2920, 2080}};
+    for (auto _ : state) {
+        size_t hits = 0;
+        tree.query(view, [&](uint32_t) { hits++; });
+        benchmark::DoNotOptimize(hits);
+    }
+}
+
+static void bm_raycast_linear(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    auto rays = random_rays(64);
+    for (auto _ : state) {
+        for (const auto& r : rays) {
+            float best = std::numeric_limits<float>::infinity();
+            for (const auto& box : boxes) {
+                if (auto t = intersect(r, box, best)) {
+                    best = *t;
+                }
+            }
+            benchmark::DoNotOptimize(best);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(rays.size()));
+}
+
+static void bm_raycast_grid(benchmark::State& state) {
+    auto grid = make_grid(random_boxes(size_t(state.range(0))));
+    auto rays = random_rays(64);
+    for (auto _ : state) {
+        for (const auto& r : rays) {
+            benchmark::DoNotOptimize(grid.raycast(r));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(rays.size()));
+}
+
+static void bm_raycast_bvh(benchmark::State& state) {
+    bvh tree(random_boxes(size_t(state.range(0))));
+    auto rays = random_rays(64);
+    for (auto _ : state) {
+        for (const auto& r : rays) {
+            benchmark::DoNotOptimize(tree.raycast(r));
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(rays.size()));
+}
+
+// every object moves a little, as in an animated scene
+static void bm_grid_update(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    auto grid = make_grid(boxes);
+    float offset = 0;
+    for (auto _ : state) {
+        offset = offset > 100 ? 0 : offset + 1;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            grid.update(i, {{boxes[i].min[0] + offset, boxes[i].min[1]}, {boxes[i].max[0] + offset, boxes[i].max[1]}});
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+
+static void bm_bvh_build(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    bvh tree;
+    for (auto _ : state) {
+        tree.build(boxes);
+        benchmark::DoNotOptimize(tree.bounds());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+
+static void bm_bvh_refit(benchmark::State& state) {
+    auto boxes = random_boxes(size_t(state.range(0)));
+    bvh tree(boxes);
+    float offset = 0;
+    for (auto _ : state) {
+        offset = offset > 10 ? 0 : offset + 1;
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            tree.refit(i, {{boxes[i].min[0] + offset, boxes[i].min[1]}, {boxes[i].max[0] + offset, boxes[i].max[1]}});
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(boxes.size()));
+}
+
+BENCHMARK(bm_point_query_linear)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_point_query_grid)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_point_query_bvh)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_rect_query_linear)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_rect_query_grid)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_rect_query_bvh)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_raycast_linear)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_raycast_grid)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_raycast_bvh)->Arg(1000)->Arg(10000);
+BENCHMARK(bm_grid_update)->Arg(10000);
+BENCHMARK(bm_bvh_build)->Arg(10000);
+BENCHMARK(bm_bvh_refit)->Arg(10000);
@@ -0,0 +1,92 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/geometry.h"
+#include "crmath/transform_tree.h"
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace cr::math;
+
+// random hierarchy, every node hangs below one of the nodes added before it
+static transform_tree random_tree(size_t count) {
+    std::mt19937 rng(1);
+    transform_tree tree;
+    tree.reserve(count);
+    tree.add();
+    for (size_t i = 1; i < count; i++) {
+        auto parent = transform_tree::node(std::uniform_int_distribution<size_t>(i > 64 ? i - 64 : 0, i - 1)(rng));
+        tree.add(parent, translate_matrix<float>(1.0f, 0.0f, 0.0f) * rotation_matrix_xy(with_translation, 0.01f));
+    }
+    tree.update();
+    return tree;
+}
+
+static void bm_multiply_4x4_generic(benchmark::State& state) {
+    auto a = rotation_matrix_xy(with_translation, 0.3f);
+    auto b = translate_matrix<float>(1.0f, 2.0f, 3.0f);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        square_matrix<float, 4> c = a * b;
+        benchmark::DoNotOptimize(c);
+    }
+}
+
+static void bm_multiply_4x4_rows(benchmark::State& state) {
+    auto a = rotation_matrix_xy(with_translation, 0.3f);
+    auto b = translate_matrix<float>(1.0f, 2.0f, 3.0f);
+    square_matrix<float, 4> c;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(b);
+        impl::multiply_4x4(a.raw(), b.raw(), c.raw());
+        benchmark::DoNotOptimize(c);
+    }
+}
+
+// what recomputing every world matrix every frame costs
+static void bm_update_everything(benchmark::State& state) {
+    auto tree = random_tree(state.range(0));
+    std::vector<square_matrix<float, 4>> worlds(tree.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < tree.size(); i++) {
+            auto parent = tree.parent(transform_tree::node(i));
+            worlds[i] = parent == transform_tree::no_parent ? tree.local(transform_tree::node(i))
+                                                            : worlds[parent] * tree.local(transform_tree::node(i));
+        }
+        benchmark::DoNotOptimize(worlds.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_update_all_dirty(benchmark::State& state) {
+    auto tree = random_tree(state.range(0));
+    for (auto _ : state) {
+        tree.set_local(0, identity<float, 4>());
+        benchmark::DoNotOptimize(tree.update());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// a few leaves move per frame, the common case for a mostly static scene
+static void bm_update_few_dirty(benchmark::State& state) {
+    auto tree = random_tree(state.range(0));
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<transform_tree::node> pick(transform_tree::node(tree.size() * 9 / 10),
+                                                             transform_tree::node(tree.size() - 1));
+    for (auto _ : state) {
+        for (size_t i = 0; i < 16; i++) {
+            tree.set_local(pick(rng), translate_matrix<float>(0.0f, 1.0f, 0.0f));
+        }
+        benchmark::DoNotOptimize(tree.update());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_multiply_4x4_generic);
+BENCHMARK(bm_multiply_4x4_rows);
+BENCHMARK(bm_update_everything)->Arg(10000);
+BENCHMARK(bm_update_all_dirty)->Arg(10000);
+BENCHMARK(bm_update_few_dirty)->Arg(10000);
@@ -0,0 +1,52 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crmath/triangulate.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <numbers>
+
+using namespace cr::math;
+
+// star shaped polygon, every other vertex is reflex
+static std::vector<cvector<float, 2>> star(size_t count, float cx = 0, float cy = 0, float radius = 100) {
+    std::vector<cvector<float, 2>> res;
+    for (size_t i = 0; i < count; i++) {
+        float angle = 2 * std::numbers::pi_v<float> * float(i) / float(count);
+        float r = i % 2 == 0 ? radius : radius * 0.6f;
+        res.push_back({cx + r * std::cos(angle), cy + r * std::sin(angle)});
+    }
+    return res;
+}
+
+static void bm_triangulate_star(benchmark::State& state) {
+    auto vertices = star(size_t(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(triangulate(vertices));
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// a disc with range(0) small square holes
+static void bm_triangulate_holes(benchmark::State& state) {
+    auto vertices = star(64, 0, 0, 1000);
+    std::vector<uint32_t> hole_starts;
+    auto side = int64_t(std::ceil(std::sqrt(double(state.range(0)))));
+    for (int64_t i = 0; i < state.range(0); i++) {
+        float x = float(i % side - side / 2) * 40;
+        float y = float(i / side - side / 2) * 40;
+        hole_starts.push_back(uint32_t(vertices.size()));
+        vertices.push_back({x, y});
+        vertices.push_back({x + 10, y});
+        vertices.push_back({x + 10, y + 10});
+        vertices.push_back({x, y + 10});
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(triangulate(vertices, hole_starts));
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(vertices.size()));
+}
+
+BENCHMARK(bm_triangulate_star)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK(bm_triangulate_holes)->Arg(4)->Arg(64);
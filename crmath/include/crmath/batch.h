@@ -0,0 +1,400 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <cassert>
+#include <optional>
+#include <ranges>
+
+namespace cr::math {
+
+/**
+ * @brief L values of T that are computed on together, one lane per independent matrix
+ * @details all operators work lane by lane on fixed size arrays, so the compiler turns them into SIMD instructions.
+ * Scalars convert implicitly and are broadcast to all lanes, which lets matrix<lanes<T, L>, N, M> reuse the
+ * generic matrix operators.
+ */
+template<typename T, size_t L>
+struct alignas(sizeof(T) * L <= 64 ? sizeof(T) * L : 64) lanes {
+    static_assert(L > 0 && (L & (L - 1)) == 0, "Lane count must be a power of two");
+    // deliberately no Type member, the scalar matrix operators would otherwise treat lanes as a matrix
+    using value_type = T;
+
+    T value[L]{};
+
+    constexpr lanes() = default;
+
+    constexpr lanes(T scalar) {
+        for (size_t l = 0; l < L; l++) {
+            value[l] = scalar;
+        }
+    }
+
+    [[nodiscard]] static constexpr size_t size() {
+        return L;
+    }
+
+    [[nodiscard]] constexpr T& operator[](size_t l) {
+        return value[l];
+    }
+
+    [[nodiscard]] constexpr const T& operator[](size_t l) const {
+        return value[l];
+    }
+
+    constexpr lanes& operator+=(const lanes& rhs) {
+        for (size_t l = 0; l < L; l++) {
+            value[l] += rhs.value[l];
+        }
+        return *this;
+    }
+
+    constexpr lanes& operator-=(const lanes& rhs) {
+        for (size_t l = 0; l < L; l++) {
+            value[l] -= rhs.value[l];
+        }
+        return *this;
+    }
+
+    constexpr lanes& operator*=(const lanes& rhs) {
+        for (size_t l = 0; l < L; l++) {
+            value[l] *= rhs.value[l];
+        }
+        return *this;
+    }
+
+    constexpr lanes& operator/=(const lanes& rhs) {
+        for (size_t l = 0; l < L; l++) {
+            value[l] /= rhs.value[l];
+        }
+        return *this;
+    }
+
+    friend constexpr lanes operator+(const lanes& lhs, const lanes& rhs) {
+        lanes res = lhs;
+        return res += rhs;
+    }
+
+    friend constexpr lanes operator-(const lanes& lhs, const lanes& rhs) {
+        lanes res = lhs;
+        return res -= rhs;
+    }
+
+    friend constexpr lanes operator*(const lanes& lhs, const lanes& rhs) {
+        lanes res = lhs;
+        return res *= rhs;
+    }
+
+    friend constexpr lanes operator/(const lanes& lhs, const lanes& rhs) {
+        lanes res = lhs;
+        return res /= rhs;
+    }
+
+    friend constexpr lanes operator-(const lanes& rhs) {
+        lanes res;
+        for (size_t l = 0; l < L; l++) {
+            res.value[l] = -rhs.value[l];
+        }
+        return res;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const lanes& rhs) {
+        os << '<';
+        for (size_t l = 0; l < L; l++) {
+            os << rhs.value[l];
+            if (l != L - 1) {
+                os << ", ";
+            }
+        }
+        os << '>';
+        return os;
+    }
+};
+
+// one AVX register worth of lanes
+template<typename T>
+constexpr size_t default_lanes = 32 / sizeof(T) > 0 ? 32 / sizeof(T) : 1;
+
+/**
+ * @brief L matrices of size N x M stored interleaved (AoSoA), element (i, j) of all matrices is contiguous
+ * @details every matrix operation on a batch computes all L results at once
+ */
+template<typename T, size_t N, size_t M, size_t L = default_lanes<T>>
+using matrix_batch = matrix<lanes<T, L>, N, M>;
+
+template<typename T, size_t N, size_t L = default_lanes<T>>
+using square_matrix_batch = matrix_batch<T, N, N, L>;
+
+template<typename T, size_t N, size_t L = default_lanes<T>>
+using cvector_batch = matrix_batch<T, N, 1, L>;
+
+template<typename T, size_t N, size_t M, size_t L>
+constexpr matrix<T, N, M> get_lane(const matrix<lanes<T, L>, N, M>& batch, size_t lane) {
+    matrix<T, N, M> res;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            res.access(i, j) = batch.access(i, j)[lane];
+        }
+    }
+    return res;
+}
+
+template<typename T, size_t N, size_t M, size_t L>
+constexpr void set_lane(matrix<lanes<T, L>, N, M>& batch, size_t lane, const matrix<T, N, M>& mat) {
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            batch.access(i, j)[lane] = mat.access(i, j);
+        }
+    }
+}
+
+/**
+ * @brief packs up to L matrices starting at first into a batch, missing lanes are zero
+ */
+template<size_t L, std::ranges::contiguous_range Range>
+constexpr auto load_batch(const Range& src, size_t first = 0) {
+    using MatType = std::ranges::range_value_t<Range>;
+    matrix<lanes<typename MatType::Type, L>, MatType::rows(), MatType::columns()> res{};
+    size_t size = std::ranges::size(src);
+    size_t count = first < size ? std::min(L, size - first) : 0;
+    for (size_t l = 0; l < count; l++) {
+        set_lane(res, l, std::ranges::data(src)[first + l]);
+    }
+    return res;
+}
+
+/**
+ * @brief unpacks the lanes of a batch into dst starting at first, lanes past the end of dst are dropped
+ */
+template<typename T, size_t N, size_t M, size_t L, std::ranges::contiguous_range Range>
+constexpr void store_batch(const matrix<lanes<T, L>, N, M>& batch, Range&& dst, size_t first = 0) {
+    size_t size = std::ranges::size(dst);
+    size_t count = first < size ? std::min(L, size - first) : 0;
+    for (size_t l = 0; l < count; l++) {
+        std::ranges::data(dst)[first + l] = get_lane(batch, l);
+    }
+}
+
+/**
+ * @brief product of two batches, the lane loop is innermost so every multiply-add covers all L matrices
+ */
+template<typename T, size_t N, size_t K, size_t M, size_t L>
+constexpr matrix<lanes<T, L>, N, M> operator*(const matrix<lanes<T, L>, N, K>& lhs, const matrix<lanes<T, L>, K, M>& rhs) {
+    matrix<lanes<T, L>, N, M> res;
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < M; j++) {
+            lanes<T, L> sum{};
+            for (size_t k = 0; k < K; k++) {
+                const auto& a = lhs.access(i, k);
+                const auto& b = rhs.access(k, j);
+                for (size_t l = 0; l < L; l++) {
+                    sum[l] += a[l] * b[l];
+                }
+            }
+            res.access(i, j) = sum;
+        }
+    }
+    return res;
+}
+
+namespace impl {
+
+// det [[a, b], [c, d]]
+template<typename T, size_t L>
+constexpr lanes<T, L> det2(const lanes<T, L>& a, const lanes<T, L>& b, const lanes<T, L>& c, const lanes<T, L>& d) {
+    lanes<T, L> res;
+    for (size_t l = 0; l < L; l++) {
+        res[l] = a[l] * d[l] - b[l] * c[l];
+    }
+    return res;
+}
+
+template<typename T, size_t N, size_t L>
+constexpr void batch_adjugate(const matrix<lanes<T, L>, N, N>& m, matrix<lanes<T, L>, N, N>& adj, lanes<T, L>& det) {
+    auto a = [&](size_t i, size_t j) -> const lanes<T, L>& { return m.access(i, j); };
+    if constexpr (N == 1) {
+        adj.access(0, 0) = T(1);
+        det = a(0, 0);
+    } else if constexpr (N == 2) {
+        adj.access(0, 0) = a(1, 1);
+        adj.access(0, 1) = -a(0, 1);
+        adj.access(1, 0) = -a(1, 0);
+        adj.access(1, 1) = a(0, 0);
+        det = det2(a(0, 0), a(0, 1), a(1, 0), a(1, 1));
+    } else if constexpr (N == 3) {
+        adj.access(0, 0) = det2(a(1, 1), a(1, 2), a(2, 1), a(2, 2));
+        adj.access(0, 1) = det2(a(0, 2), a(0, 1), a(2, 2), a(2, 1));
+        adj.access(0, 2) = det2(a(0, 1), a(0, 2), a(1, 1), a(1, 2));
+        adj.access(1, 0) = det2(a(1, 2), a(1, 0), a(2, 2), a(2, 0));
+        adj.access(1, 1) = det2(a(0, 0), a(0, 2), a(2, 0), a(2, 2));
+        adj.access(1, 2) = det2(a(0, 2), a(0, 0), a(1, 2), a(1, 0));
+        adj.access(2, 0) = det2(a(1, 0), a(1, 1), a(2, 0), a(2, 1));
+        adj.access(2, 1) = det2(a(0, 1), a(0, 0), a(2, 1), a(2, 0));
+        adj.access(2, 2) = det2(a(0, 0), a(0, 1), a(1, 0), a(1, 1));
+        det = a(0, 0) * adj.access(0, 0) + a(0, 1) * adj.access(1, 0) + a(0, 2) * adj.access(2, 0);
+    } else {
+        // Laplace expansion along the first two and the last two rows, the 2x2 minors are shared by all cofactors
+        auto s0 = det2(a(0, 0), a(0, 1), a(1, 0), a(1, 1));
+        auto s1 = det2(a(0, 0), a(0, 2), a(1, 0), a(1, 2));
+        auto s2 = det2(a(0, 0), a(0, 3), a(1, 0), a(1, 3));
+        auto s3 = det2(a(0, 1), a(0, 2), a(1, 1), a(1, 2));
+        auto s4 = det2(a(0, 1), a(0, 3), a(1, 1), a(1, 3));
+        auto s5 = det2(a(0, 2), a(0, 3), a(1, 2), a(1, 3));
+        auto c5 = det2(a(2, 2), a(2, 3), a(3, 2), a(3, 3));
+        auto c4 = det2(a(2, 1), a(2, 3), a(3, 1), a(3, 3));
+        auto c3 = det2(a(2, 1), a(2, 2), a(3, 1), a(3, 2));
+        auto c2 = det2(a(2, 0), a(2, 3), a(3, 0), a(3, 3));
+        auto c1 = det2(a(2, 0), a(2, 2), a(3, 0), a(3, 2));
+        auto c0 = det2(a(2, 0), a(2, 1), a(3, 0), a(3, 1));
+        adj.access(0, 0) = a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3;
+        adj.access(0, 1) = -a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3;
+        adj.access(0, 2) = a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3;
+        adj.access(0, 3) = -a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3;
+        adj.access(1, 0) = -a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1;
+        adj.access(1, 1) = a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1;
+        adj.access(1, 2) = -a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1;
+        adj.access(1, 3) = a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1;
+        adj.access(2, 0) = a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0;
+        adj.access(2, 1) = -a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0;
+        adj.access(2, 2) = a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0;
+        adj.access(2, 3) = -a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0;
+        adj.access(3, 0) = -a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0;
+        adj.access(3, 1) = a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0;
+        adj.access(3, 2) = -a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0;
+        adj.access(3, 3) = a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0;
+        det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    }
+}
+
+}// namespace impl
+
+/**
+ * @brief determinants of all L matrices, closed form up to 4x4, cofactor expansion on lanes above
+ */
+template<typename T, size_t N, size_t L>
+constexpr lanes<T, L> determinant(const matrix<lanes<T, L>, N, N>& batch) {
+    if constexpr (N <= 4) {
+        matrix<lanes<T, L>, N, N> adj;
+        lanes<T, L> det;
+        impl::batch_adjugate(batch, adj, det);
+        return det;
+    } else {
+        lanes<T, L> res{};
+        for (size_t i = 0; i < N; i++) {
+            auto cofactor = batch.access(0, i) * determinant(matrix_modifiable<decltype(batch.minor(0, i))>(batch.minor(0, i)));
+            res += i % 2 == 0 ? cofactor : -cofactor;
+        }
+        return res;
+    }
+}
+
+template<typename T, size_t N, size_t L>
+struct batch_inverse_result {
+    square_matrix_batch<T, N, L> value;
+    // valid[l] is false if matrix l is singular, its inverse is left zero
+    bool valid[L];
+};
+
+/**
+ * @brief inverts all L matrices of a batch at once
+ * @details singular lanes do not stop the others, they are reported in valid instead of an empty optional
+ */
+template<typename T, size_t N, size_t L>
+constexpr batch_inverse_result<T, N, L> inverse(const matrix<lanes<T, L>, N, N>& batch) {
+    matrix<lanes<T, L>, N, N> adj;
+    lanes<T, L> det;
+    if constexpr (N <= 4) {
+        impl::batch_adjugate(batch, adj, det);
+    } else {
+        adj = adjugate(batch);
+        det = determinant(batch);
+    }
+    lanes<T, L> inv_det;
+    batch_inverse_result<T, N, L> res;
+    for (size_t l = 0; l < L; l++) {
+        res.valid[l] = det[l] != T(0);
+        inv_det[l] = res.valid[l] ? T(1) / det[l] : T(0);
+    }
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            res.value.access(i, j) = adj.access(i, j) * inv_det;
+        }
+    }
+    return res;
+}
+
+namespace impl {
+
+template<typename Range>
+using batch_value_type = typename std::ranges::range_value_t<Range>::Type;
+
+template<typename T, size_t L>
+constexpr size_t batch_lanes = L > 0 ? L : default_lanes<T>;
+
+}// namespace impl
+
+/**
+ * @brief out[i] = lhs[i] * rhs[i], computed L products at a time
+ * @details lhs and rhs have to be at least as long as out. The *_all functions pack and unpack every chunk, which costs
+ * about as much as a 4x4 product. Data that is processed every frame should stay in matrix_batch layout instead.
+ */
+template<size_t L = 0, std::ranges::contiguous_range Lhs, std::ranges::contiguous_range Rhs,
+         std::ranges::contiguous_range Out>
+void multiply_all(const Lhs& lhs, const Rhs& rhs, Out&& out) {
+    constexpr size_t lane_count = impl::batch_lanes<impl::batch_value_type<Lhs>, L>;
+    size_t count = std::ranges::size(out);
+    assert(std::ranges::size(lhs) >= count && std::ranges::size(rhs) >= count);
+    for (size_t i = 0; i < count; i += lane_count) {
+        store_batch(load_batch<lane_count>(lhs, i) * load_batch<lane_count>(rhs, i), out, i);
+    }
+}
+
+/**
+ * @brief out[i] = mats[i] * vectors[i], e.g. to transform one vertex per skinning matrix
+ */
+template<size_t L = 0, std::ranges::contiguous_range Mats, std::ranges::contiguous_range Vecs,
+         std::ranges::contiguous_range Out>
+void transform_all(const Mats& mats, const Vecs& vectors, Out&& out) {
+    multiply_all<L>(mats, vectors, out);
+}
+
+template<size_t L = 0, std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+void determinant_all(const In& in, Out&& out) {
+    using T = impl::batch_value_type<In>;
+    constexpr size_t lane_count = impl::batch_lanes<T, L>;
+    size_t count = std::ranges::size(in);
+    assert(std::ranges::size(out) >= count);
+    for (size_t i = 0; i < count; i += lane_count) {
+        auto det = determinant(load_batch<lane_count>(in, i));
+        for (size_t l = 0; l < lane_count && i + l < count; l++) {
+            std::ranges::data(out)[i + l] = det[l];
+        }
+    }
+}
+
+/**
+ * @brief out[i] = inverse(in[i]) for ranges of matrices, where out holds std::optional like inverse returns
+ */
+template<size_t L = 0, std::ranges::contiguous_range In, std::ranges::contiguous_range Out>
+void inverse_all(const In& in, Out&& out) {
+    using T = impl::batch_value_type<In>;
+    constexpr size_t lane_count = impl::batch_lanes<T, L>;
+    size_t count = std::ranges::size(in);
+    assert(std::ranges::size(out) >= count);
+    for (size_t i = 0; i < count; i += lane_count) {
+        auto res = inverse(load_batch<lane_count>(in, i));
+        for (size_t l = 0; l < lane_count && i + l < count; l++) {
+            if (res.valid[l]) {
+                std::ranges::data(out)[i + l] = get_lane(res.value, l);
+            } else {
+                std::ranges::data(out)[i + l] = std::nullopt;
+            }
+        }
+    }
+}
+
+}// namespace cr::math
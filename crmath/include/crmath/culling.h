@@ -0,0 +1,326 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include "spatial.h"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace cr::math {
+
+/*
+ * Bulk visibility tests. Bounds are stored as structure of arrays, so a test loads 4 objects per component at once,
+ * and the survivors are written as a compacted list of indices without a branch per object.
+ */
+
+struct aabb2_batch {
+    std::vector<float> min_x, min_y, max_x, max_y;
+
+    void reserve(size_t count) {
+        min_x.reserve(count);
+        min_y.reserve(count);
+        max_x.reserve(count);
+        max_y.reserve(count);
+    }
+
+    void push_back(const aabb& box) {
+        min_x.push_back(box.min[0]);
+        min_y.push_back(box.min[1]);
+        max_x.push_back(box.max[0]);
+        max_y.push_back(box.max[1]);
+    }
+
+    void clear() {
+        min_x.clear();
+        min_y.clear();
+        max_x.clear();
+        max_y.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return min_x.size();
+    }
+};
+
+struct circle_batch {
+    std::vector<float> x, y, radius;
+
+    void reserve(size_t count) {
+        x.reserve(count);
+        y.reserve(count);
+        radius.reserve(count);
+    }
+
+    void push_back(const cvector<float, 2>& center, float r) {
+        x.push_back(center[0]);
+        y.push_back(center[1]);
+        radius.push_back(r);
+    }
+
+    void clear() {
+        x.clear();
+        y.clear();
+        radius.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return x.size();
+    }
+};
+
+struct aabb3_batch {
+    std::vector<float> min_x, min_y, min_z, max_x, max_y, max_z;
+
+    void reserve(size_t count) {
+        for (auto* v : {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z}) {
+            v->reserve(count);
+        }
+    }
+
+    void push_back(const cvector<float, 3>& min, const cvector<float, 3>& max) {
+        min_x.push_back(min[0]);
+        min_y.push_back(min[1]);
+        min_z.push_back(min[2]);
+        max_x.push_back(max[0]);
+        max_y.push_back(max[1]);
+        max_z.push_back(max[2]);
+    }
+
+    void clear() {
+        for (auto* v : {&min_x, &min_y, &min_z, &max_x, &max_y, &max_z}) {
+            v->clear();
+        }
+    }
+
+    [[nodiscard]] size_t size() const {
+        return min_x.size();
+    }
+};
+
+struct sphere_batch {
+    std::vector<float> x, y, z, radius;
+
+    void reserve(size_t count) {
+        for (auto* v : {&x, &y, &z, &radius}) {
+            v->reserve(count);
+        }
+    }
+
+    void push_back(const cvector<float, 3>& center, float r) {
+        x.push_back(center[0]);
+        y.push_back(center[1]);
+        z.push_back(center[2]);
+        radius.push_back(r);
+    }
+
+    void clear() {
+        for (auto* v : {&x, &y, &z, &radius}) {
+            v->clear();
+        }
+    }
+
+    [[nodiscard]] size_t size() const {
+        return x.size();
+    }
+};
+
+/**
+ * @brief depth range of clip space, OpenGL uses -1..1 and Vulkan 0..1
+ */
+enum class clip_depth {
+    negative_one_to_one,
+    zero_to_one,
+};
+
+/**
+ * @brief the six planes of a view volume, a point p is inside if a * x + b * y + c * z + d >= 0 for every plane
+ * @details the normals are normalized, so the plane equation gives the signed distance for sphere tests
+ */
+struct frustum {
+    enum side { left, right, bottom, top, near, far };
+
+    float planes[6][4];
+
+    /**
+     * @brief extracts the planes of clip space from a (projection * view) matrix that transforms column vectors
+     */
+    static frustum from_matrix(const square_matrix<float, 4>& m, clip_depth depth = clip_depth::zero_to_one) {
+        frustum res{};
+        for (size_t j = 0; j < 4; j++) {
+            res.planes[left][j] = m[3][j] + m[0][j];
+            res.planes[right][j] = m[3][j] - m[0][j];
+            res.planes[bottom][j] = m[3][j] + m[1][j];
+            res.planes[top][j] = m[3][j] - m[1][j];
+            res.planes[near][j] = depth == clip_depth::zero_to_one ? m[2][j] : m[3][j] + m[2][j];
+            res.planes[far][j] = m[3][j] - m[2][j];
+        }
+        for (auto& plane : res.planes) {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0) {
+                for (auto& v : plane) {
+                    v /= length;
+                }
+            }
+        }
+        return res;
+    }
+
+    [[nodiscard]] bool contains(const cvector<float, 3>& p) const {
+        for (const auto& plane : planes) {
+            if (plane[0] * p[0] + plane[1] * p[1] + plane[2] * p[2] + plane[3] < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+namespace impl {
+
+// GCC vector extensions at the SSE2 / NEON width every target has, wider types would change the calling ABI
+using cull_float = float __attribute__((vector_size(16)));
+using cull_mask = int32_t __attribute__((vector_size(16)));
+constexpr size_t cull_width = sizeof(cull_float) / sizeof(float);
+
+// loads count <= cull_width floats, the missing lanes are zero
+inline cull_float load_lanes(const float* p, size_t count) {
+    cull_float v{};
+    std::memcpy(&v, p, count * sizeof(float));
+    return v;
+}
+
+inline cull_float broadcast(float v) {
+    return cull_float{} + v;
+}
+
+// appends first + k for every set lane k, the index is always written and the count only advances for set lanes
+inline size_t compact(const cull_mask& mask, uint32_t first, size_t lanes, uint32_t* out, size_t count) {
+    for (size_t k = 0; k < lanes; k++) {
+        out[count] = first + uint32_t(k);
+        count += size_t(mask[k] & 1);
+    }
+    return count;
+}
+
+// test(i, lanes) returns the visibility mask of objects [i, i + lanes)
+template<typename Test>
+size_t cull_blocks(size_t size, std::span<uint32_t> out, Test&& test) {
+    assert(out.size() >= size);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + cull_width <= size; i += cull_width) {
+        count = compact(test(i, cull_width), uint32_t(i), cull_width, out.data(), count);
+    }
+    if (i < size) {
+        count = compact(test(i, size - i), uint32_t(i), size - i, out.data(), count);
+    }
+    return count;
+}
+
+}// namespace impl
+
+/**
+ * @brief writes the indices of all boxes that intersect view to out, which needs room for every box
+ * @return number of visible boxes, out[0, count) holds their indices in ascending order
+ */
+inline size_t cull(const aabb2_batch& batch, const aabb& view, std::span<uint32_t> out) {
+    auto view_min_x = impl::broadcast(view.min[0]);
+    auto view_min_y = impl::broadcast(view.min[1]);
+    auto view_max_x = impl::broadcast(view.max[0]);
+    auto view_max_y = impl::broadcast(view.max[1]);
+    return impl::cull_blocks(batch.size(), out, [&](size_t i, size_t lanes) {
+        auto min_x = impl::load_lanes(batch.min_x.data() + i, lanes);
+        auto min_y = impl::load_lanes(batch.min_y.data() + i, lanes);
+        auto max_x = impl::load_lanes(batch.max_x.data() + i, lanes);
+        auto max_y = impl::load_lanes(batch.max_y.data() + i, lanes);
+        return (min_x <= view_max_x) & (max_x >= view_min_x) & (min_y <= view_max_y) & (max_y >= view_min_y);
+    });
+}
+
+/**
+ * @brief writes the indices of all circles that intersect view to out, exact at the corners of view
+ */
+inline size_t cull(const circle_batch& batch, const aabb& view, std::span<uint32_t> out) {
+    auto view_min_x = impl::broadcast(view.min[0]);
+    auto view_min_y = impl::broadcast(view.min[1]);
+    auto view_max_x = impl::broadcast(view.max[0]);
+    auto view_max_y = impl::broadcast(view.max[1]);
+    auto zero = impl::broadcast(0);
+    return impl::cull_blocks(batch.size(), out, [&](size_t i, size_t lanes) {
+        auto x = impl::load_lanes(batch.x.data() + i, lanes);
+        auto y = impl::load_lanes(batch.y.data() + i, lanes);
+        auto r = impl::load_lanes(batch.radius.data() + i, lanes);
+        // distance from the center to the closest point of view, zero inside
+        auto below_x = view_min_x - x;
+        auto above_x = x - view_max_x;
+        auto below_y = view_min_y - y;
+        auto above_y = y - view_max_y;
+        auto dx = below_x > above_x ? below_x : above_x;
+        auto dy = below_y > above_y ? below_y : above_y;
+        dx = dx > zero ? dx : zero;
+        dy = dy > zero ? dy : zero;
+        return dx * dx + dy * dy <= r * r;
+    });
+}
+
+/**
+ * @brief writes the indices of all boxes that are not completely outside one plane of f to out
+ * @details conservative like every plane test: a large box near a corner of the frustum can be kept while outside
+ */
+inline size_t cull(const aabb3_batch& batch, const frustum& f, std::span<uint32_t> out) {
+    return impl::cull_blocks(batch.size(), out, [&](size_t i, size_t lanes) {
+        impl::cull_float min[3] = {impl::load_lanes(batch.min_x.data() + i, lanes),
+                                   impl::load_lanes(batch.min_y.data() + i, lanes),
+                                   impl::load_lanes(batch.min_z.data() + i, lanes)};
+        impl::cull_float max[3] = {impl::load_lanes(batch.max_x.data() + i, lanes),
+                                   impl::load_lanes(batch.max_y.data() + i, lanes),
+                                   impl::load_lanes(batch.max_z.data() + i, lanes)};
+        auto inside = impl::cull_mask{} - 1;
+        for (const auto& plane : f.planes) {
+            // the corner furthest along the normal decides, which corner that is depends only on the plane
+            auto distance = impl::broadcast(plane[3]);
+            for (size_t axis = 0; axis < 3; axis++) {
+                distance += plane[axis] * (plane[axis] > 0 ? max[axis] : min[axis]);
+            }
+            inside &= distance >= impl::broadcast(0);
+        }
+        return inside;
+    });
+}
+
+/**
+ * @brief writes the indices of all spheres that are not completely outside one plane of f to out
+ */
+inline size_t cull(const sphere_batch& batch, const frustum& f, std::span<uint32_t> out) {
+    return impl::cull_blocks(batch.size(), out, [&](size_t i, size_t lanes) {
+        auto x = impl::load_lanes(batch.x.data() + i, lanes);
+        auto y = impl::load_lanes(batch.y.data() + i, lanes);
+        auto z = impl::load_lanes(batch.z.data() + i, lanes);
+        auto negative_radius = -impl::load_lanes(batch.radius.data() + i, lanes);
+        auto inside = impl::cull_mask{} - 1;
+        for (const auto& plane : f.planes) {
+            auto distance = plane[0] * x + plane[1] * y + plane[2] * z + plane[3];
+            inside &= distance >= negative_radius;
+        }
+        return inside;
+    });
+}
+
+/**
+ * @brief indices of the visible objects of batch, for callers that do not keep an index buffer around
+ */
+template<typename Batch, typename View>
+std::vector<uint32_t> cull(const Batch& batch, const View& view) {
+    std::vector<uint32_t> res(batch.size());
+    res.resize(cull(batch, view, std::span<uint32_t>(res)));
+    return res;
+}
+
+}// namespace cr::math
@@ -0,0 +1,143 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <vector>
+
+namespace cr::math {
+
+/*
+ * Curves in the plane and their flattening into polylines.
+ * The tolerance is the largest distance the polyline may have from the curve, in the units of the control points.
+ * For control points in pixels that makes the number of vertices follow the size of the curve on screen.
+ */
+
+using curve_point = cvector<float, 2>;
+
+struct quadratic_bezier {
+    curve_point p0, p1, p2;
+
+    [[nodiscard]] constexpr curve_point at(float t) const {
+        float s = 1 - t;
+        return p0 * (s * s) + p1 * (2 * s * t) + p2 * (t * t);
+    }
+};
+
+struct cubic_bezier {
+    curve_point p0, p1, p2, p3;
+
+    [[nodiscard]] constexpr curve_point at(float t) const {
+        float s = 1 - t;
+        return p0 * (s * s * s) + p1 * (3 * s * s * t) + p2 * (3 * s * t * t) + p3 * (t * t * t);
+    }
+};
+
+/**
+ * @brief uniform Catmull-Rom segment from p1 to p2, p0 and p3 only set the tangents
+ */
+struct catmull_rom {
+    curve_point p0, p1, p2, p3;
+
+    /**
+     * @brief the same curve as a cubic Bézier, which is how it is evaluated and flattened
+     */
+    [[nodiscard]] constexpr cubic_bezier to_bezier() const {
+        return {p1, p1 + (p2 - p0) * (1.0f / 6), p2 - (p3 - p1) * (1.0f / 6), p2};
+    }
+
+    [[nodiscard]] constexpr curve_point at(float t) const {
+        return to_bezier().at(t);
+    }
+};
+
+namespace impl {
+
+inline float length(const curve_point& v) {
+    return std::sqrt(v[0] * v[0] + v[1] * v[1]);
+}
+
+// Wang's formula: uniform steps in t with this many segments keep a degree n Bézier within tolerance of its polyline,
+// max_second_difference is the largest |p[i] - 2 p[i + 1] + p[i + 2]| of the control points
+inline size_t segment_count(size_t degree, float max_second_difference, float tolerance) {
+    float n = std::sqrt(float(degree * (degree - 1)) * max_second_difference / (8 * tolerance));
+    // caps degenerate input like an infinite control point or a zero tolerance
+    return std::clamp<size_t>(size_t(std::ceil(std::min(n, 65536.0f))), 1, 65536);
+}
+
+template<typename Curve>
+void flatten_uniform(const Curve& curve, size_t segments, std::vector<curve_point>& out) {
+    // the first point is shared with the end of the previous curve in a chain
+    size_t first = out.empty() || !(out.back() == curve.at(0)) ? 0 : 1;
+    out.reserve(out.size() + segments + 1 - first);
+    float step = 1.0f / float(segments);
+    for (size_t i = first; i < segments; i++) {
+        out.push_back(curve.at(float(i) * step));
+    }
+    out.push_back(curve.at(1));
+}
+
+}// namespace impl
+
+/**
+ * @brief number of line segments flatten() uses for curve
+ */
+inline size_t segment_count(const quadratic_bezier& curve, float tolerance) {
+    return impl::segment_count(2, impl::length(curve.p0 - curve.p1 * 2 + curve.p2), tolerance);
+}
+
+inline size_t segment_count(const cubic_bezier& curve, float tolerance) {
+    float d0 = impl::length(curve.p0 - curve.p1 * 2 + curve.p2);
+    float d1 = impl::length(curve.p1 - curve.p2 * 2 + curve.p3);
+    return impl::segment_count(3, std::max(d0, d1), tolerance);
+}
+
+inline size_t segment_count(const catmull_rom& curve, float tolerance) {
+    return segment_count(curve.to_bezier(), tolerance);
+}
+
+/**
+ * @brief appends a polyline within tolerance of curve to out
+ * @details consecutive calls build one contiguous strip, a start point equal to the last point in out is not repeated
+ */
+inline void flatten(const quadratic_bezier& curve, float tolerance, std::vector<curve_point>& out) {
+    impl::flatten_uniform(curve, segment_count(curve, tolerance), out);
+}
+
+inline void flatten(const cubic_bezier& curve, float tolerance, std::vector<curve_point>& out) {
+    impl::flatten_uniform(curve, segment_count(curve, tolerance), out);
+}
+
+inline void flatten(const catmull_rom& curve, float tolerance, std::vector<curve_point>& out) {
+    flatten(curve.to_bezier(), tolerance, out);
+}
+
+/**
+ * @brief appends a polyline through all points, smoothed with a Catmull-Rom spline
+ * @details the first and last point are repeated to get tangents at the ends
+ */
+inline void flatten_catmull_rom(std::span<const curve_point> points, float tolerance, std::vector<curve_point>& out) {
+    if (points.size() < 2) {
+        out.insert(out.end(), points.begin(), points.end());
+        return;
+    }
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        const auto& p0 = points[i == 0 ? 0 : i - 1];
+        const auto& p3 = points[std::min(i + 2, points.size() - 1)];
+        flatten(catmull_rom{p0, points[i], points[i + 1], p3}, tolerance, out);
+    }
+}
+
+template<typename Curve>
+std::vector<curve_point> flatten(const Curve& curve, float tolerance) {
+    std::vector<curve_point> res;
+    flatten(curve, tolerance, res);
+    return res;
+}
+
+}// namespace cr::math
@@ -0,0 +1,257 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace cr::math {
+
+namespace impl {
+
+template<typename T>
+using real_type = decltype(std::abs(std::declval<T>()));
+
+template<typename T, size_t N>
+constexpr real_type<T> norm_1(const square_matrix<T, N>& mat) {
+    real_type<T> res = 0;
+    for (size_t j = 0; j < N; j++) {
+        real_type<T> column = 0;
+        for (size_t i = 0; i < N; i++) {
+            column += std::abs(mat.access(i, j));
+        }
+        res = std::max(res, column);
+    }
+    return res;
+}
+
+// solves lhs * X = rhs with LU decomposition and partial pivoting, lhs is assumed to be regular
+template<typename T, size_t N, size_t M>
+constexpr matrix<T, N, M> solve(square_matrix<T, N> lhs, matrix<T, N, M> rhs) {
+    for (size_t k = 0; k < N; k++) {
+        size_t pivot = k;
+        for (size_t i = k + 1; i < N; i++) {
+            if (std::abs(lhs.access(i, k)) > std::abs(lhs.access(pivot, k))) {
+                pivot = i;
+            }
+        }
+        if (pivot != k) {
+            for (size_t j = 0; j < N; j++) {
+                std::swap(lhs.access(k, j), lhs.access(pivot, j));
+            }
+            for (size_t j = 0; j < M; j++) {
+                std::swap(rhs.access(k, j), rhs.access(pivot, j));
+            }
+        }
+        for (size_t i = k + 1; i < N; i++) {
+            T factor = lhs.access(i, k) / lhs.access(k, k);
+            for (size_t j = k + 1; j < N; j++) {
+                lhs.access(i, j) -= factor * lhs.access(k, j);
+            }
+            for (size_t j = 0; j < M; j++) {
+                rhs.access(i, j) -= factor * rhs.access(k, j);
+            }
+        }
+    }
+    for (size_t k = N; k-- > 0;) {
+        for (size_t j = 0; j < M; j++) {
+            T value = rhs.access(k, j);
+            for (size_t i = k + 1; i < N; i++) {
+                value -= lhs.access(k, i) * rhs.access(i, j);
+            }
+            rhs.access(k, j) = value / lhs.access(k, k);
+        }
+    }
+    return rhs;
+}
+
+// Pade coefficients b_0..b_m of the [m/m] approximant of exp, see Higham, "The Scaling and Squaring Method for the Matrix Exponential Revisited" (2005)
+constexpr std::array<double, 4> pade3{120., 60., 12., 1.};
+constexpr std::array<double, 6> pade5{30240., 15120., 3360., 420., 30., 1.};
+constexpr std::array<double, 8> pade7{17297280., 8648640., 1995840., 277200., 25200., 1512., 56., 1.};
+constexpr std::array<double, 10> pade9{17643225600., 8821612800., 2075673600., 302702400., 30270240.,
+                                       2162160., 110880., 3960., 90., 1.};
+constexpr std::array<double, 14> pade13{64764752532480000., 32382376266240000., 7771770303897600.,
+                                        1187353796428800., 129060195264000., 10559470521600.,
+                                        670442572800., 33522128640., 1323241920., 40840800.,
+                                        960960., 16380., 182., 1.};
+
+// largest 1-norms for which the [m/m] approximant is accurate to unit roundoff
+constexpr std::array<double, 5> theta_double{1.495585217958292e-2, 2.539398330063230e-1, 9.504178996162932e-1,
+                                             2.097847961257068e0, 5.371920351148152e0};
+constexpr std::array<double, 3> theta_float{4.258730016922831e-1, 1.880152677804762e0, 3.925724783138660e0};
+
+// U and V of the approximant r_m(A) = (V - U)^-1 (V + U) for m <= 9
+template<typename T, size_t N, size_t M>
+constexpr void pade_terms(const square_matrix<T, N>& A, const std::array<double, M>& b,
+                          square_matrix<T, N>& U, square_matrix<T, N>& V) {
+    auto A2 = A * A;
+    square_matrix<T, N> power = identity<T, N>();
+    square_matrix<T, N> odd{};
+    V = square_matrix<T, N>{};
+    for (size_t k = 0; 2 * k < M; k++) {
+        if (k > 0) {
+            power = power * A2;
+        }
+        V += power * T(b[2 * k]);
+        odd += power * T(b[2 * k + 1]);
+    }
+    U = A * odd;
+}
+
+template<typename T, size_t N>
+constexpr void pade13_terms(const square_matrix<T, N>& A, square_matrix<T, N>& U, square_matrix<T, N>& V) {
+    const auto& b = pade13;
+    auto I = identity<T, N>();
+    auto A2 = A * A;
+    auto A4 = A2 * A2;
+    auto A6 = A4 * A2;
+    U = A * (A6 * (A6 * T(b[13]) + A4 * T(b[11]) + A2 * T(b[9])) +
+             A6 * T(b[7]) + A4 * T(b[5]) + A2 * T(b[3]) + I * T(b[1]));
+    V = A6 * (A6 * T(b[12]) + A4 * T(b[10]) + A2 * T(b[8])) +
+        A6 * T(b[6]) + A4 * T(b[4]) + A2 * T(b[2]) + I * T(b[0]);
+}
+
+}// namespace impl
+
+/**
+ * @brief matrix exponential e^A using Pade approximation with scaling and squaring
+ * @details picks the smallest Pade degree that is accurate for the norm of A (3, 5, 7 for single precision,
+ * up to 13 otherwise) and scales A by a power of two if even the largest degree is not enough
+ */
+template<square_matrix_concept MatType>
+constexpr matrix_modifiable<MatType> expm(const MatType& mat) {
+    using T = typename MatType::Type;
+    constexpr size_t N = MatType::rows();
+    using real = impl::real_type<T>;
+    square_matrix<T, N> A = mat;
+    square_matrix<T, N> U;
+    square_matrix<T, N> V;
+    auto norm = double(impl::norm_1(A));
+    int squarings = 0;
+
+    if constexpr (sizeof(real) <= sizeof(float)) {
+        const auto& theta = impl::theta_float;
+        if (norm <= theta[0]) {
+            impl::pade_terms(A, impl::pade3, U, V);
+        } else if (norm <= theta[1]) {
+            impl::pade_terms(A, impl::pade5, U, V);
+        } else {
+            if (norm > theta[2]) {
+                squarings = int(std::ceil(std::log2(norm / theta[2])));
+                A /= T(std::ldexp(real(1), squarings));
+            }
+            impl::pade_terms(A, impl::pade7, U, V);
+        }
+    } else {
+        const auto& theta = impl::theta_double;
+        if (norm <= theta[0]) {
+            impl::pade_terms(A, impl::pade3, U, V);
+        } else if (norm <= theta[1]) {
+            impl::pade_terms(A, impl::pade5, U, V);
+        } else if (norm <= theta[2]) {
+            impl::pade_terms(A, impl::pade7, U, V);
+        } else if (norm <= theta[3]) {
+            impl::pade_terms(A, impl::pade9, U, V);
+        } else {
+            if (norm > theta[4]) {
+                squarings = int(std::ceil(std::log2(norm / theta[4])));
+                A /= T(std::ldexp(real(1), squarings));
+            }
+            impl::pade13_terms(A, U, V);
+        }
+    }
+
+    auto res = impl::solve<T, N, N>(V - U, V + U);
+    for (int i = 0; i < squarings; i++) {
+        res = res * res;
+    }
+    return res;
+}
+
+/**
+ * @brief exact zero order hold discretization of x' = A x + B u
+ * @details x(t + dt) = phi * x(t) + gamma * u, with phi = e^(A dt) and gamma = integral_0^dt e^(A s) ds * B.
+ * For the affine system x' = A x + b use B = b and u = 1, which is what step(x) does.
+ */
+template<typename T, size_t N, size_t K>
+struct discrete_system {
+    square_matrix<T, N> phi;
+    matrix<T, N, K> gamma;
+
+    [[nodiscard]] constexpr column_vector<T, N> step(const column_vector<T, N>& x, const column_vector<T, K>& u) const {
+        return phi * x + gamma * u;
+    }
+
+    [[nodiscard]] constexpr column_vector<T, N> step(const column_vector<T, N>& x) const
+        requires(K == 1)
+    {
+        return phi * x + gamma;
+    }
+
+    [[nodiscard]] constexpr column_vector<T, N> operator()(const column_vector<T, N>& x) const
+        requires(K == 1)
+    {
+        return step(x);
+    }
+};
+
+template<typename MatTypeA, typename MatTypeB, typename Scalar>
+    requires(square_matrix_concept<MatTypeA> && MatTypeA::rows() == MatTypeB::rows() &&
+             std::is_convertible_v<Scalar, typename MatTypeA::Type>)
+constexpr discrete_system<typename MatTypeA::Type, MatTypeA::rows(), MatTypeB::columns()>
+discretize(const MatTypeA& A, const MatTypeB& B, Scalar dt) {
+    using T = typename MatTypeA::Type;
+    constexpr size_t N = MatTypeA::rows();
+    constexpr size_t K = MatTypeB::columns();
+    // e^([[A, B], [0, 0]] dt) = [[phi, gamma], [0, I]]
+    square_matrix<T, N + K> augmented{};
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            augmented.access(i, j) = A.access(i, j) * T(dt);
+        }
+        for (size_t j = 0; j < K; j++) {
+            augmented.access(i, N + j) = B.access(i, j) * T(dt);
+        }
+    }
+    auto exponential = expm(augmented);
+    discrete_system<T, N, K> res;
+    res.phi = exponential.template submatrix<N, N>(0, 0);
+    res.gamma = exponential.template submatrix<N, K>(0, N);
+    return res;
+}
+
+/**
+ * @brief discretize with a cache, recomputes only if A, B or dt change
+ * @details intended for fixed step simulations where the system only changes when its parameters do
+ */
+template<typename T, size_t N, size_t K = 1>
+struct cached_discretization {
+    const discrete_system<T, N, K>& operator()(const square_matrix<T, N>& A, const matrix<T, N, K>& B, T dt) {
+        if (!valid || dt != cached_dt || A != cached_A || B != cached_B) {
+            system = discretize(A, B, dt);
+            cached_A = A;
+            cached_B = B;
+            cached_dt = dt;
+            valid = true;
+        }
+        return system;
+    }
+
+    void invalidate() {
+        valid = false;
+    }
+
+private:
+    square_matrix<T, N> cached_A;
+    matrix<T, N, K> cached_B;
+    T cached_dt{};
+    bool valid = false;
+    discrete_system<T, N, K> system;
+};
+
+}// namespace cr::math
@@ -0,0 +1,524 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <concepts>
+#include <memory>
+#include <mutex>
+#include <numbers>
+#include <span>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cr::math {
+
+namespace impl {
+// plain complex product, operator* checks for inf/nan through a library call unless -ffast-math is set
+template<typename T>
+constexpr std::complex<T> multiply(const std::complex<T>& a, const std::complex<T>& b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+}// namespace impl
+
+struct fft_options {
+    // number of threads a single transform may use, 0 uses all hardware threads
+    size_t threads = 1;
+    // transforms smaller than this always run on the calling thread
+    size_t parallel_threshold = size_t(1) << 15;
+};
+
+/**
+ * @brief precomputed factorization and twiddle table of a discrete fourier transform of one size
+ * @details sizes are factored into radix 4, 2, 3, 5 and generic odd radix butterflies (mixed radix decimation in time).
+ * Sizes with a prime factor above max_generic_radix are computed with Bluestein's algorithm
+ * on top of a power of two transform. Plans are immutable and shared, use get() to reuse them.
+ */
+template<std::floating_point T>
+struct fft_plan {
+    using complex = std::complex<T>;
+    static constexpr size_t max_generic_radix = 31;
+
+    explicit fft_plan(size_t n) : n(n) {
+        if (n <= 1) {
+            return;
+        }
+        size_t rest = n;
+        size_t p = 4;
+        do {
+            while (rest % p) {
+                switch (p) {
+                    case 4:
+                        p = 2;
+                        break;
+                    case 2:
+                        p = 3;
+                        break;
+                    default:
+                        p += 2;
+                        break;
+                }
+                if (p * p > rest) {
+                    p = rest;
+                }
+            }
+            rest /= p;
+            factors.push_back(p);
+            factors.push_back(rest);
+        } while (rest > 1);
+
+        twiddles.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            // computed in double, float tables would lose precision for large n
+            twiddles[i] = complex(std::polar(1.0, -2.0 * std::numbers::pi * double(i) / double(n)));
+        }
+
+        bool large_prime = false;
+        for (size_t i = 0; i < factors.size(); i += 2) {
+            large_prime |= factors[i] > max_generic_radix;
+        }
+        if (large_prime) {
+            init_bluestein();
+        }
+    }
+
+    // shared plan for size n, plans are created once per size and type
+    static std::shared_ptr<const fft_plan> get(size_t n) {
+        static std::mutex mutex;
+        static std::unordered_map<size_t, std::shared_ptr<const fft_plan>> plans;
+        {
+            std::lock_guard lock(mutex);
+            if (auto it = plans.find(n); it != plans.end()) {
+                return it->second;
+            }
+        }
+        // constructed without holding the lock, bluestein plans request their power of two plan
+        auto plan = std::make_shared<const fft_plan>(n);
+        std::lock_guard lock(mutex);
+        return plans.try_emplace(n, std::move(plan)).first->second;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return n;
+    }
+
+    // out = DFT(in), in and out must have size() elements and must not overlap
+    void forward(std::span<const complex> in, std::span<complex> out, const fft_options& options = {}) const {
+        if (n <= 1) {
+            std::copy(in.begin(), in.end(), out.begin());
+        } else if (bluestein) {
+            forward_bluestein(in, out, options);
+        } else {
+            work(out.data(), in.data(), 1, factors.data(), thread_count(options));
+        }
+    }
+
+    // in place, the input is copied into a buffer that each thread keeps for its later transforms
+    void forward(std::span<complex> data, const fft_options& options = {}) const {
+        if (n <= 1) {
+            return;
+        }
+        if (bluestein) {
+            // reads all of its input before it writes the output
+            forward_bluestein(data, data, options);
+            return;
+        }
+        thread_local std::vector<complex> in;
+        in.assign(data.begin(), data.end());
+        work(data.data(), in.data(), 1, factors.data(), thread_count(options));
+    }
+
+    // inverse transform, scaled by 1/n so that inverse(forward(x)) == x
+    void inverse(std::span<complex> data, const fft_options& options = {}) const {
+        for (auto& value : data) {
+            value = std::conj(value);
+        }
+        forward(data, options);
+        T scale = T(1) / T(n);
+        for (auto& value : data) {
+            value = std::conj(value) * scale;
+        }
+    }
+
+    [[nodiscard]] const complex& twiddle(size_t i) const {
+        return twiddles[i];
+    }
+
+private:
+    size_t n;
+    // pairs of radix and remaining length
+    std::vector<size_t> factors;
+    std::vector<complex> twiddles;
+
+    struct bluestein_data {
+        // w_k = e^(-i pi k^2 / n)
+        std::vector<complex> chirp;
+        // transform of the conjugated chirp, wrapped around to size m
+        std::vector<complex> filter;
+        std::shared_ptr<const fft_plan> plan;
+    };
+    std::unique_ptr<bluestein_data> bluestein;
+
+    [[nodiscard]] size_t thread_count(const fft_options& options) const {
+        if (n < options.parallel_threshold) {
+            return 1;
+        }
+        return options.threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : options.threads;
+    }
+
+    void init_bluestein() {
+        bluestein = std::make_unique<bluestein_data>();
+        size_t m = 1;
+        while (m < 2 * n - 1) {
+            m *= 2;
+        }
+        bluestein->plan = get(m);
+        bluestein->chirp.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            // k^2 mod 2n keeps the angle small
+            auto k2 = (k * k) % (2 * n);
+            bluestein->chirp[k] = complex(std::polar(1.0, -std::numbers::pi * double(k2) / double(n)));
+        }
+        bluestein->filter.assign(m, complex{});
+        bluestein->filter[0] = std::conj(bluestein->chirp[0]);
+        for (size_t k = 1; k < n; k++) {
+            bluestein->filter[k] = std::conj(bluestein->chirp[k]);
+            bluestein->filter[m - k] = std::conj(bluestein->chirp[k]);
+        }
+        bluestein->plan->forward(std::span(bluestein->filter));
+    }
+
+    void forward_bluestein(std::span<const complex> in, std::span<complex> out, const fft_options& options) const {
+        const auto& chirp = bluestein->chirp;
+        const auto& filter = bluestein->filter;
+        size_t m = filter.size();
+        // the power of two transforms below are in place and use their own buffer
+        thread_local std::vector<complex> buffer;
+        buffer.assign(m, complex{});
+        for (size_t k = 0; k < n; k++) {
+            buffer[k] = impl::multiply(in[k], chirp[k]);
+        }
+        bluestein->plan->forward(std::span(buffer), options);
+        for (size_t k = 0; k < m; k++) {
+            buffer[k] = impl::multiply(buffer[k], filter[k]);
+        }
+        bluestein->plan->inverse(std::span(buffer), options);
+        for (size_t k = 0; k < n; k++) {
+            out[k] = impl::multiply(buffer[k], chirp[k]);
+        }
+    }
+
+    void work(complex* out, const complex* in, size_t stride, const size_t* factor, size_t threads) const {
+        size_t p = factor[0];
+        size_t m = factor[1];
+        if (m == 1) {
+            for (size_t q = 0; q < p; q++) {
+                out[q] = in[q * stride];
+            }
+        } else if (threads > 1) {
+            // the p sub-transforms are independent, distribute them over the available threads
+            size_t groups = std::min(threads, p);
+            size_t sub_threads = std::max<size_t>(1, threads / p);
+            auto run_group = [=, this](size_t group) {
+                for (size_t q = group; q < p; q += groups) {
+                    work(out + q * m, in + q * stride, stride * p, factor + 2, sub_threads);
+                }
+            };
+            std::vector<std::jthread> workers;
+            workers.reserve(groups - 1);
+            for (size_t group = 1; group < groups; group++) {
+                workers.emplace_back(run_group, group);
+            }
+            run_group(0);
+        } else {
+            for (size_t q = 0; q < p; q++) {
+                work(out + q * m, in + q * stride, stride * p, factor + 2, 1);
+            }
+        }
+
+        switch (p) {
+            case 2:
+                butterfly2(out, stride, m);
+                break;
+            case 3:
+                butterfly3(out, stride, m);
+                break;
+            case 4:
+                butterfly4(out, stride, m);
+                break;
+            case 5:
+                butterfly5(out, stride, m);
+                break;
+            default:
+                butterfly_generic(out, stride, m, p);
+                break;
+        }
+    }
+
+    void butterfly2(complex* out, size_t stride, size_t m) const {
+        for (size_t k = 0; k < m; k++) {
+            complex t = impl::multiply(out[k + m], twiddles[k * stride]);
+            out[k + m] = out[k] - t;
+            out[k] += t;
+        }
+    }
+
+    void butterfly3(complex* out, size_t stride, size_t m) const {
+        T epi3 = twiddles[stride * m].imag();
+        for (size_t k = 0; k < m; k++) {
+            complex s1 = impl::multiply(out[k + m], twiddles[k * stride]);
+            complex s2 = impl::multiply(out[k + 2 * m], twiddles[2 * k * stride]);
+            complex s3 = s1 + s2;
+            complex s0 = (s1 - s2) * epi3;
+            complex half = out[k] - s3 * T(0.5);
+            out[k] += s3;
+            out[k + m] = {half.real() - s0.imag(), half.imag() + s0.real()};
+            out[k + 2 * m] = {half.real() + s0.imag(), half.imag() - s0.real()};
+        }
+    }
+
+    void butterfly4(complex* out, size_t stride, size_t m) const {
+        for (size_t k = 0; k < m; k++) {
+            complex s0 = impl::multiply(out[k + m], twiddles[k * stride]);
+            complex s1 = impl::multiply(out[k + 2 * m], twiddles[2 * k * stride]);
+            complex s2 = impl::multiply(out[k + 3 * m], twiddles[3 * k * stride]);
+            complex s5 = out[k] - s1;
+            complex s4 = out[k] + s1;
+            complex s3 = s0 + s2;
+            complex s6 = s0 - s2;
+            out[k] = s4 + s3;
+            out[k + 2 * m] = s4 - s3;
+            out[k + m] = {s5.real() + s6.imag(), s5.imag() - s6.real()};
+            out[k + 3 * m] = {s5.real() - s6.imag(), s5.imag() + s6.real()};
+        }
+    }
+
+    void butterfly5(complex* out, size_t stride, size_t m) const {
+        complex ya = twiddles[stride * m];
+        complex yb = twiddles[stride * 2 * m];
+        for (size_t k = 0; k < m; k++) {
+            complex s0 = out[k];
+            complex s1 = impl::multiply(out[k + m], twiddles[k * stride]);
+            complex s2 = impl::multiply(out[k + 2 * m], twiddles[2 * k * stride]);
+            complex s3 = impl::multiply(out[k + 3 * m], twiddles[3 * k * stride]);
+            complex s4 = impl::multiply(out[k + 4 * m], twiddles[4 * k * stride]);
+            complex s7 = s1 + s4;
+            complex s10 = s1 - s4;
+            complex s8 = s2 + s3;
+            complex s9 = s2 - s3;
+            out[k] = s0 + s7 + s8;
+            complex s5 = s0 + s7 * ya.real() + s8 * yb.real();
+            complex s6 = {s10.imag() * ya.imag() + s9.imag() * yb.imag(), -(s10.real() * ya.imag() + s9.real() * yb.imag())};
+            out[k + m] = s5 - s6;
+            out[k + 4 * m] = s5 + s6;
+            complex s11 = s0 + s7 * yb.real() + s8 * ya.real();
+            complex s12 = {s9.imag() * ya.imag() - s10.imag() * yb.imag(), s10.real() * yb.imag() - s9.real() * ya.imag()};
+            out[k + 2 * m] = s11 + s12;
+            out[k + 3 * m] = s11 - s12;
+        }
+    }
+
+    void butterfly_generic(complex* out, size_t stride, size_t m, size_t p) const {
+        std::array<complex, max_generic_radix> scratch;
+        for (size_t u = 0; u < m; u++) {
+            for (size_t q = 0; q < p; q++) {
+                scratch[q] = out[u + q * m];
+            }
+            for (size_t q = 0; q < p; q++) {
+                size_t k = u + q * m;
+                size_t index = 0;
+                complex sum = scratch[0];
+                for (size_t r = 1; r < p; r++) {
+                    index += stride * k;
+                    if (index >= n) {
+                        index %= n;
+                    }
+                    sum += impl::multiply(scratch[r], twiddles[index]);
+                }
+                out[k] = sum;
+            }
+        }
+    }
+};
+
+/// in place forward transform of contiguous data of any length
+template<std::floating_point T>
+void fft(std::span<std::complex<T>> data, const fft_options& options = {}) {
+    fft_plan<T>::get(data.size())->forward(data, options);
+}
+
+/// in place inverse transform, scaled by 1/n
+template<std::floating_point T>
+void ifft(std::span<std::complex<T>> data, const fft_options& options = {}) {
+    fft_plan<T>::get(data.size())->inverse(data, options);
+}
+
+template<std::floating_point T, size_t N>
+cvector<std::complex<T>, N> fft(const cvector<std::complex<T>, N>& vec, const fft_options& options = {}) {
+    cvector<std::complex<T>, N> res = vec;
+    fft(std::span<std::complex<T>>(res.raw(), N), options);
+    return res;
+}
+
+template<std::floating_point T, size_t N>
+cvector<std::complex<T>, N> ifft(const cvector<std::complex<T>, N>& vec, const fft_options& options = {}) {
+    cvector<std::complex<T>, N> res = vec;
+    ifft(std::span<std::complex<T>>(res.raw(), N), options);
+    return res;
+}
+
+namespace impl {
+// e^(-2 pi i k / n) for k < n / 2, applied by rfft and irfft on top of the half size transform. Computed here instead
+// of taken from the plan of size n, which would be a whole Bluestein plan when n / 2 is a large prime
+template<std::floating_point T>
+std::shared_ptr<const std::vector<std::complex<T>>> real_twiddles(size_t n) {
+    static std::mutex mutex;
+    static std::unordered_map<size_t, std::shared_ptr<const std::vector<std::complex<T>>>> tables;
+    std::lock_guard lock(mutex);
+    auto& table = tables[n];
+    if (!table) {
+        auto values = std::make_shared<std::vector<std::complex<T>>>(n / 2);
+        for (size_t k = 0; k < n / 2; k++) {
+            (*values)[k] = std::complex<T>(std::polar(1.0, -2.0 * std::numbers::pi * double(k) / double(n)));
+        }
+        table = std::move(values);
+    }
+    return table;
+}
+}// namespace impl
+
+/**
+ * @brief transform of real input, returns the n / 2 + 1 non-redundant bins
+ * @details even sizes are computed as a complex transform of half the size
+ */
+template<std::floating_point T>
+std::vector<std::complex<T>> rfft(std::span<const T> data, const fft_options& options = {}) {
+    using complex = std::complex<T>;
+    size_t n = data.size();
+    if (n == 0) {
+        return {};
+    }
+    if (n % 2 != 0) {
+        std::vector<complex> full(data.begin(), data.end());
+        fft(std::span(full), options);
+        full.resize(n / 2 + 1);
+        return full;
+    }
+    size_t half = n / 2;
+    std::vector<complex> packed(half);
+    for (size_t k = 0; k < half; k++) {
+        packed[k] = {data[2 * k], data[2 * k + 1]};
+    }
+    fft(std::span(packed), options);
+    auto twiddles = impl::real_twiddles<T>(n);
+    std::vector<complex> res(half + 1);
+    for (size_t k = 0; k <= half; k++) {
+        complex z = packed[k % half];
+        complex z_mirror = std::conj(packed[(half - k) % half]);
+        complex even = (z + z_mirror) * T(0.5);
+        complex odd = (z - z_mirror) * complex(0, T(-0.5));
+        res[k] = even + impl::multiply(k == half ? complex(-1) : (*twiddles)[k], odd);
+    }
+    return res;
+}
+
+/// inverse of rfft, n is the length of the real signal
+template<std::floating_point T>
+std::vector<T> irfft(std::span<const std::complex<T>> spectrum, size_t n, const fft_options& options = {}) {
+    using complex = std::complex<T>;
+    if (n == 0) {
+        return {};
+    }
+    std::vector<T> res(n);
+    if (n % 2 != 0) {
+        std::vector<complex> full(n);
+        for (size_t k = 0; k < n; k++) {
+            full[k] = k <= n / 2 ? spectrum[k] : std::conj(spectrum[n - k]);
+        }
+        ifft(std::span(full), options);
+        for (size_t k = 0; k < n; k++) {
+            res[k] = full[k].real();
+        }
+        return res;
+    }
+    size_t half = n / 2;
+    auto twiddles = impl::real_twiddles<T>(n);
+    std::vector<complex> packed(half);
+    for (size_t k = 0; k < half; k++) {
+        complex x = spectrum[k];
+        complex x_mirror = std::conj(spectrum[half - k]);
+        complex even = (x + x_mirror) * T(0.5);
+        complex odd = impl::multiply((x - x_mirror) * T(0.5), std::conj((*twiddles)[k]));
+        packed[k] = even + complex(-odd.imag(), odd.real());
+    }
+    ifft(std::span(packed), options);
+    for (size_t k = 0; k < half; k++) {
+        res[2 * k] = packed[k].real();
+        res[2 * k + 1] = packed[k].imag();
+    }
+    return res;
+}
+
+namespace impl {
+inline size_t convolution_size(size_t size) {
+    size_t res = 1;
+    while (res < size) {
+        res *= 2;
+    }
+    return std::max<size_t>(res, 2);
+}
+}// namespace impl
+
+/// linear convolution of two real sequences, the result has a.size() + b.size() - 1 elements
+template<std::floating_point T>
+std::vector<T> convolve(std::span<const T> a, std::span<const T> b, const fft_options& options = {}) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    size_t size = a.size() + b.size() - 1;
+    size_t n = impl::convolution_size(size);
+    std::vector<T> padded(n);
+    std::copy(a.begin(), a.end(), padded.begin());
+    auto spectrum_a = rfft(std::span<const T>(padded), options);
+    std::fill(padded.begin(), padded.end(), T(0));
+    std::copy(b.begin(), b.end(), padded.begin());
+    auto spectrum_b = rfft(std::span<const T>(padded), options);
+    for (size_t k = 0; k < spectrum_a.size(); k++) {
+        spectrum_a[k] = impl::multiply(spectrum_a[k], spectrum_b[k]);
+    }
+    auto res = irfft(std::span<const std::complex<T>>(spectrum_a), n, options);
+    res.resize(size);
+    return res;
+}
+
+/// linear convolution of two complex sequences, the result has a.size() + b.size() - 1 elements
+template<std::floating_point T>
+std::vector<std::complex<T>> convolve(std::span<const std::complex<T>> a, std::span<const std::complex<T>> b,
+                                      const fft_options& options = {}) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    size_t size = a.size() + b.size() - 1;
+    size_t n = impl::convolution_size(size);
+    std::vector<std::complex<T>> padded_a(n);
+    std::vector<std::complex<T>> padded_b(n);
+    std::copy(a.begin(), a.end(), padded_a.begin());
+    std::copy(b.begin(), b.end(), padded_b.begin());
+    fft(std::span(padded_a), options);
+    fft(std::span(padded_b), options);
+    for (size_t k = 0; k < n; k++) {
+        padded_a[k] = impl::multiply(padded_a[k], padded_b[k]);
+    }
+    ifft(std::span(padded_a), options);
+    padded_a.resize(size);
+    return padded_a;
+}
+
+}// namespace cr::math
@@ -5,7 +5,9 @@
 #pragma once
 
 #include <complex>
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <optional>
 #include <ostream>
 #include <type_traits>
@@ -41,6 +43,9 @@ struct matrix;
 template<typename MatrixType>
 struct matrix_transposed_view;
 
+template<typename T, size_t R, size_t C, size_t RowStride, size_t ColStride, size_t Offset = 0>
+struct strided_view;
+
 template<typename MatType>
 using matrix_modifiable = matrix<typename MatType::Type, MatType::rows(), MatType::columns()>;
 
@@ -65,11 +70,17 @@ concept rvector_type = requires {
 template<typename VecType>
 concept vector_type = cvector_type<VecType> || rvector_type<VecType>;
 
-template<cvector_type Vec>
-constexpr size_t vector_size() { return Vec::rows(); }
-
-template<rvector_type Vec>
-constexpr size_t vector_size() { return Vec::columns(); }
+template<vector_type Vec>
+constexpr size_t vector_size() {
+    if constexpr (cvector_type<Vec> && rvector_type<Vec>) {
+        // matrices satisfy both concepts, the vector runs along the dimension that isn't 1
+        return Vec::rows() == 1 ? Vec::columns() : Vec::rows();
+    } else if constexpr (cvector_type<Vec>) {
+        return Vec::rows();
+    } else {
+        return Vec::columns();
+    }
+}
 
 auto rk4(auto x_curr, auto dt, auto f) {
     auto k1 = f(x_curr);
@@ -80,7 +91,7 @@ auto rk4(auto x_curr, auto dt, auto f) {
 }
 
 template<modifiable_matrix MatType, typename Rhs>
-[[nodiscard]] constexpr MatType& operator+=(MatType& lhs, const Rhs& rhs) {
+constexpr MatType& operator+=(MatType& lhs, const Rhs& rhs) {
     for (size_t i = 0; i < MatType::rows(); i++) {
         for (size_t j = 0; j < MatType::columns(); j++) {
             lhs.access(i, j) += rhs.access(i, j);
@@ -90,7 +101,7 @@ template<modifiable_matrix MatType, typename Rhs>
 }
 
 template<modifiable_matrix MatType, typename Rhs>
-[[nodiscard]] constexpr MatType& operator-=(MatType& lhs, const Rhs& rhs) {
+constexpr MatType& operator-=(MatType& lhs, const Rhs& rhs) {
     for (size_t i = 0; i < MatType::rows(); i++) {
         for (size_t j = 0; j < MatType::columns(); j++) {
             lhs.access(i, j) -= rhs.access(i, j);
@@ -101,7 +112,7 @@ template<modifiable_matrix MatType, typename Rhs>
 
 template<modifiable_matrix MatType, typename Scalar>
     requires std::is_convertible_v<Scalar, typename MatType::Type>
-[[nodiscard]] constexpr MatType& operator*=(MatType& lhs, const Scalar& scalar) {
+constexpr MatType& operator*=(MatType& lhs, const Scalar& scalar) {
     for (size_t i = 0; i < MatType::rows(); i++) {
         for (size_t j = 0; j < MatType::columns(); j++) {
             lhs.access(i, j) *= scalar;
@@ -112,7 +123,7 @@ template<modifiable_matrix MatType, typename Scalar>
 
 template<modifiable_matrix MatType, typename Scalar>
     requires std::is_convertible_v<Scalar, typename MatType::Type>
-[[nodiscard]] constexpr MatType& operator/=(MatType& lhs, const Scalar& scalar) {
+constexpr MatType& operator/=(MatType& lhs, const Scalar& scalar) {
     for (size_t i = 0; i < MatType::rows(); i++) {
         for (size_t j = 0; j < MatType::columns(); j++) {
             lhs.access(i, j) /= scalar;
@@ -305,6 +316,89 @@ constexpr auto length(const MatType& mat) {
     return std::sqrt(res);
 }
 
+namespace impl {
+
+template<typename T>
+concept bareiss_type = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+// intermediate values of the Bareiss elimination are minors of the input, so they need room for products of two entries
+template<typename T>
+using bareiss_wide_type =
+#ifdef __SIZEOF_INT128__
+        std::conditional_t<(sizeof(T) < sizeof(int64_t)), int64_t, __int128>;
+#else
+        int64_t;
+#endif
+
+/**
+ * @brief fraction free gaussian elimination (Bareiss), exact for integers in O(n^3)
+ * @details every division is exact, because after step k each entry is a (k + 1) x (k + 1) minor of the input.
+ * In checked mode every product and difference is tested for overflow of the wide type and the result
+ * is tested to fit into T, std::nullopt is returned otherwise.
+ */
+template<bool checked, typename MatType>
+constexpr std::optional<typename MatType::Type> bareiss_determinant(const MatType& mat) {
+    using T = typename MatType::Type;
+    using W = bareiss_wide_type<T>;
+    constexpr size_t N = MatType::rows();
+    W a[N][N]{};
+    for (size_t i = 0; i < N; i++) {
+        for (size_t j = 0; j < N; j++) {
+            a[i][j] = W(mat.access(i, j));
+        }
+    }
+    bool negate = false;
+    W previous = 1;
+    for (size_t k = 0; k + 1 < N; k++) {
+        if (a[k][k] == 0) {
+            size_t pivot = k + 1;
+            while (pivot < N && a[pivot][k] == 0) {
+                pivot++;
+            }
+            if (pivot == N) {
+                return T(0);
+            }
+            for (size_t j = k; j < N; j++) {
+                std::swap(a[k][j], a[pivot][j]);
+            }
+            negate = !negate;
+        }
+        for (size_t i = k + 1; i < N; i++) {
+            for (size_t j = k + 1; j < N; j++) {
+                if constexpr (checked) {
+                    W lhs;
+                    W rhs;
+                    W diff;
+                    if (__builtin_mul_overflow(a[i][j], a[k][k], &lhs) ||
+                        __builtin_mul_overflow(a[i][k], a[k][j], &rhs) ||
+                        __builtin_sub_overflow(lhs, rhs, &diff)) {
+                        return std::nullopt;
+                    }
+                    a[i][j] = diff / previous;
+                } else {
+                    a[i][j] = (a[i][j] * a[k][k] - a[i][k] * a[k][j]) / previous;
+                }
+            }
+        }
+        previous = a[k][k];
+    }
+    W res = negate ? -a[N - 1][N - 1] : a[N - 1][N - 1];
+    if constexpr (checked) {
+        if (res < W(std::numeric_limits<T>::min()) || res > W(std::numeric_limits<T>::max())) {
+            return std::nullopt;
+        }
+    }
+    return T(res);
+}
+
+}// namespace impl
+
+/**
+ * @brief determinant of a square matrix
+ * @details integral matrices from 3x3 on use the exact Bareiss elimination, everything else cofactor expansion.
+ * Signed integer overflow in any intermediate value is undefined behaviour, checked_determinant is the only safe choice
+ * for inputs that might overflow.
+ */
 template<typename MatType>
     requires square_matrix_concept<MatType>
 constexpr typename MatType::Type determinant(const MatType& mat) {
@@ -312,15 +406,27 @@ constexpr typename MatType::Type determinant(const MatType& mat) {
         return mat[0];
     } else if constexpr (MatType::rows() == 2) {
         return mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0];
+    } else if constexpr (impl::bareiss_type<typename MatType::Type>) {
+        return *impl::bareiss_determinant<false>(mat);
     } else {
         typename MatType::Type res = 0;
         for (size_t i = 0; i < MatType::rows(); i++) {
-            res += mat[0][i] * determinant(mat.minor(0, i));
+            auto cofactor = mat[0][i] * determinant(mat.minor(0, i));
+            res += i % 2 == 0 ? cofactor : -cofactor;
         }
         return res;
     }
 }
 
+/**
+ * @brief exact determinant of an integral matrix, std::nullopt if it or any intermediate value overflows
+ */
+template<typename MatType>
+    requires(square_matrix_concept<MatType> && impl::bareiss_type<typename MatType::Type>)
+constexpr std::optional<typename MatType::Type> checked_determinant(const MatType& mat) {
+    return impl::bareiss_determinant<true>(mat);
+}
+
 template<typename MatType>
 constexpr auto transposed(const MatType& mat) {
     return mat.transposed();
@@ -374,45 +480,11 @@ struct matrix {
 
     matrix() = default;
 
-    matrix(const matrix& other) {
-        for (size_t i = 0; i < N; i++) {
-            for (size_t j = 0; j < M; j++) {
-                access(i, j) = other.access(i, j);
-            }
-        }
-    }
-
-    matrix(matrix&& other) noexcept {
-        for (size_t i = 0; i < N; i++) {
-            for (size_t j = 0; j < M; j++) {
-                access(i, j) = std::move(other.access(i, j));
-            }
-        }
-    }
-
-    matrix& operator=(const matrix& other) {
-        if (this == &other) {
-            return *this;
-        }
-        for (size_t i = 0; i < N; i++) {
-            for (size_t j = 0; j < M; j++) {
-                access(i, j) = other.access(i, j);
-            }
-        }
-        return *this;
-    }
-
-    matrix& operator=(matrix&& other) noexcept {
-        if (this == &other) {
-            return *this;
-        }
-        for (size_t i = 0; i < N; i++) {
-            for (size_t j = 0; j < M; j++) {
-                access(i, j) = std::move(other.access(i, j));
-            }
-        }
-        return *this;
-    }
+    // defaulted so matrices of trivially copyable types are trivially copyable and can be stored as raw bytes
+    constexpr matrix(const matrix& other) = default;
+    constexpr matrix(matrix&& other) noexcept = default;
+    constexpr matrix& operator=(const matrix& other) = default;
+    constexpr matrix& operator=(matrix&& other) noexcept = default;
 
     template<typename MatType>
         requires same_size_matrix<MatType, matrix>
@@ -426,7 +498,7 @@ struct matrix {
 
     template<typename... ArgT>
         requires(sizeof...(ArgT) == N * M)
-    matrix(ArgT&&... args) : data{static_cast<Type>(args)...} {
+    constexpr matrix(ArgT&&... args) : data{static_cast<Type>(args)...} {
     }
 
     [[nodiscard]] static constexpr size_t rows() {
@@ -438,22 +510,22 @@ struct matrix {
     }
 
     Type* raw() {
-        return &data[0][0];
+        return data;
     }
 
     const Type* raw() const {
-        return &data[0][0];
+        return data;
     }
 
     struct row_view {
-        row_view(size_t row, matrix& mat) : row(row), mat(mat) {}
+        constexpr row_view(size_t row, matrix& mat) : row(row), mat(mat) {}
 
         [[nodiscard]] constexpr T& operator[](size_t i) {
-            return mat.data[row][i];
+            return mat.data[row * M + i];
         }
 
         [[nodiscard]] constexpr const T& operator[](size_t i) const {
-            return mat.data[row][i];
+            return mat.data[row * M + i];
         }
 
     private:
@@ -462,10 +534,10 @@ struct matrix {
     };
 
     struct const_row_view {
-        const_row_view(size_t row, const matrix& mat) : row(row), mat(mat) {}
+        constexpr const_row_view(size_t row, const matrix& mat) : row(row), mat(mat) {}
 
         [[nodiscard]] constexpr const T& operator[](size_t i) const {
-            return mat.data[row][i];
+            return mat.data[row * M + i];
         }
 
     private:
@@ -494,16 +566,16 @@ struct matrix {
     }
 
     [[nodiscard]] constexpr T& access(size_t i, size_t j) {
-        return data[i][j];
+        return data[i * M + j];
     }
 
-    [[nodiscard]] constexpr T access(size_t i, size_t j) const {
-        return data[i][j];
+    [[nodiscard]] constexpr const T& access(size_t i, size_t j) const {
+        return data[i * M + j];
     }
 
     template<size_t ROW_COUNT, size_t COLUMN_COUNT, typename MatrixType>
     struct matrix_view {
-        explicit matrix_view(MatrixType& mat) : mat(mat) {}
+        constexpr explicit matrix_view(MatrixType& mat) : mat(mat) {}
 
         //using MatrixType = matrix<T, N, M>;
         using Type = T;
@@ -520,7 +592,7 @@ struct matrix {
         template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
             requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
         [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) {
-            typename MatrixType::template matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, MatrixType> res;
+            typename MatrixType::template matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, MatrixType> res{mat};
             for (size_t i = 0; i < SUB_ROW_COUNT; i++) {
                 res.used_rows[get_row(i + row)] = true;
             }
@@ -533,7 +605,7 @@ struct matrix {
         template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
             requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
         [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) const {
-            typename MatrixType::template matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, const MatrixType> res;
+            typename MatrixType::template matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, const MatrixType> res{mat};
             for (size_t i = 0; i < SUB_ROW_COUNT; i++) {
                 res.used_rows[get_row(i + row)] = true;
             }
@@ -562,10 +634,10 @@ struct matrix {
         [[nodiscard]] constexpr auto minor(size_t row, size_t column) {
             static_assert(rows() > 1 && columns() > 1, "Matrix must be at least 2x2");
             matrix_view<rows() - 1, columns() - 1, MatrixType> res{mat};
-            for (size_t i = 0; i < rows() - 1; i++) {
+            for (size_t i = 0; i < rows(); i++) {
                 res.used_rows[get_row(i)] = i != row;
             }
-            for (size_t i = 0; i < columns() - 1; i++) {
+            for (size_t i = 0; i < columns(); i++) {
                 res.used_columns[get_column(i)] = i != column;
             }
             return res;
@@ -574,32 +646,32 @@ struct matrix {
         [[nodiscard]] constexpr auto minor(size_t row, size_t column) const {
             static_assert(rows() > 1 && columns() > 1, "Matrix must be at least 2x2");
             matrix_view<rows() - 1, columns() - 1, const MatrixType> res{mat};
-            for (size_t i = 0; i < rows() - 1; i++) {
+            for (size_t i = 0; i < rows(); i++) {
                 res.used_rows[get_row(i)] = i != row;
             }
-            for (size_t i = 0; i < columns() - 1; i++) {
+            for (size_t i = 0; i < columns(); i++) {
                 res.used_columns[get_column(i)] = i != column;
             }
             return res;
         }
 
         constexpr matrix_transposed_view<matrix_view> transposed() {
-            return {*this};
+            return matrix_transposed_view<matrix_view>{*this};
         }
 
         constexpr matrix_transposed_view<const matrix_view> transposed() const {
-            return {*this};
+            return matrix_transposed_view<const matrix_view>{*this};
         }
 
         struct row_view {
-            row_view(size_t row, matrix_view& mat_view) : row(row), mat_view(mat_view) {}
+            constexpr row_view(size_t row, matrix_view& mat_view) : row(row), mat_view(mat_view) {}
 
             [[nodiscard]] constexpr T& operator[](size_t i) {
-                return mat_view.mat.data[row][mat_view.get_column(i)];
+                return mat_view.mat.access(row, mat_view.get_column(i));
             }
 
             [[nodiscard]] constexpr const T& operator[](size_t i) const {
-                return mat_view.mat.data[row][mat_view.get_column(i)];
+                return mat_view.mat.access(row, mat_view.get_column(i));
             }
 
         private:
@@ -608,10 +680,10 @@ struct matrix {
         };
 
         struct const_row_view {
-            const_row_view(size_t row, const matrix_view& mat_view) : row(row), mat_view(mat_view) {}
+            constexpr const_row_view(size_t row, const matrix_view& mat_view) : row(row), mat_view(mat_view) {}
 
             [[nodiscard]] constexpr const T& operator[](size_t i) const {
-                return mat_view.mat.data[row][mat_view.get_column(i)];
+                return mat_view.mat.access(row, mat_view.get_column(i));
             }
 
         private:
@@ -681,27 +753,28 @@ struct matrix {
     template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
         requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
     [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) {
-        matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, matrix> res{*this};
-        for (size_t i = 0; i < N; i++) {
-            res.used_rows[i + row] = true;
-        }
-        for (size_t i = 0; i < M; i++) {
-            res.used_columns[i + column] = true;
-        }
-        return res;
+        return strided_view<T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, M, 1>{data + row * M + column};
     }
 
     template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
         requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
     [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) const {
-        matrix_view<SUB_ROW_COUNT, SUB_COLUMN_COUNT, const matrix> res{*this};
-        for (size_t i = 0; i < N; i++) {
-            res.used_rows[i + row] = true;
-        }
-        for (size_t i = 0; i < M; i++) {
-            res.used_columns[i + column] = true;
-        }
-        return res;
+        return strided_view<const T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, M, 1>{data + row * M + column};
+    }
+
+    /**
+     * @brief submatrix at a compile time position, the offset becomes part of the view type
+     */
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT, size_t ROW, size_t COLUMN>
+        requires(ROW + SUB_ROW_COUNT <= rows() && COLUMN + SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto block() {
+        return strided_view<T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, M, 1, ROW * M + COLUMN>{data};
+    }
+
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT, size_t ROW, size_t COLUMN>
+        requires(ROW + SUB_ROW_COUNT <= rows() && COLUMN + SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto block() const {
+        return strided_view<const T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, M, 1, ROW * M + COLUMN>{data};
     }
 
     constexpr auto row_vector(size_t row) {
@@ -753,14 +826,22 @@ struct matrix {
     }
 
 private:
-    T data[N][M]{};
+    // one flat array, so strided views may step across rows with plain pointer arithmetic, also at compile time
+    T data[N * M]{};
 };
 
 template<typename MatrixType>
 struct matrix_transposed_view {
     using Type = typename MatrixType::Type;
+    // a reference for matrices, a copy for views, so transposing a temporary view does not dangle
+    using RefType = std::conditional_t<std::is_const_v<MatrixType> &&
+                                               std::is_reference_v<typename MatrixType::TransposeRefType>,
+                                       const std::remove_reference_t<typename MatrixType::TransposeRefType>&,
+                                       typename MatrixType::TransposeRefType>;
 
-    explicit matrix_transposed_view(typename MatrixType::TransposeRefType& ref) : mat(ref) {}
+    template<typename Ref>
+        requires std::is_constructible_v<RefType, Ref&>
+    constexpr explicit matrix_transposed_view(Ref& ref) : mat(ref) {}
 
     [[nodiscard]] static constexpr size_t rows() {
         return MatrixType::columns();
@@ -771,7 +852,7 @@ struct matrix_transposed_view {
     }
 
     struct row_view {
-        row_view(size_t column, const typename MatrixType::TransposeRefType mat) : column(column), mat(mat) {}
+        row_view(size_t column, RefType& mat) : column(column), mat(mat) {}
 
         [[nodiscard]] constexpr Type& operator[](size_t i) {
             return mat[i][column];
@@ -783,11 +864,11 @@ struct matrix_transposed_view {
 
     private:
         size_t column;
-        typename MatrixType::TransposeRefType& mat;
+        RefType& mat;
     };
 
     struct const_row_view {
-        const_row_view(size_t column, const typename MatrixType::TransposeRefType mat) : column(column), mat(mat) {}
+        const_row_view(size_t column, const RefType mat) : column(column), mat(mat) {}
 
         [[nodiscard]] constexpr const Type& operator[](size_t i) const {
             return mat[i][column];
@@ -795,7 +876,7 @@ struct matrix_transposed_view {
 
     private:
         size_t column;
-        const typename MatrixType::TransposeRefType mat;
+        const RefType mat;
     };
 
     [[nodiscard]] constexpr decltype(auto) operator[](size_t i) {
@@ -828,12 +909,12 @@ struct matrix_transposed_view {
 
     template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
     [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) {
-        return mat.template submatrix<SUB_COLUMN_COUNT, SUB_ROW_COUNT>(column, row);
+        return mat.template submatrix<SUB_COLUMN_COUNT, SUB_ROW_COUNT>(column, row).transposed();
     }
 
     template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
     [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) const {
-        return mat.template submatrix<SUB_COLUMN_COUNT, SUB_ROW_COUNT>(column, row);
+        return mat.template submatrix<SUB_COLUMN_COUNT, SUB_ROW_COUNT>(column, row).transposed();
     }
 
 
@@ -862,9 +943,124 @@ struct matrix_transposed_view {
     }
 
 private:
-    typename MatrixType::TransposeRefType& mat;
+    RefType mat;
 };
 
+/**
+ * @brief view of R x C elements at base[Offset + i * RowStride + j * ColStride]
+ * @details a single pointer with the layout in the type, so every access is plain pointer arithmetic.
+ * Rows, columns, submatrices and blocks of a matrix are strided views, transposing swaps the strides.
+ */
+template<typename T, size_t R, size_t C, size_t RowStride, size_t ColStride, size_t Offset>
+struct strided_view {
+    using Type = std::remove_const_t<T>;
+    using TransposeRefType = strided_view;
+
+    constexpr explicit strided_view(T* base) : base(base) {}
+
+    [[nodiscard]] static constexpr size_t rows() {
+        return R;
+    }
+
+    [[nodiscard]] static constexpr size_t columns() {
+        return C;
+    }
+
+    [[nodiscard]] constexpr T& access(size_t i, size_t j) {
+        return base[Offset + i * RowStride + j * ColStride];
+    }
+
+    [[nodiscard]] constexpr const Type& access(size_t i, size_t j) const {
+        return base[Offset + i * RowStride + j * ColStride];
+    }
+
+    [[nodiscard]] constexpr decltype(auto) operator[](size_t i) {
+        if constexpr (rows() == 1) {
+            return access(0, i);
+        } else if constexpr (columns() == 1) {
+            return access(i, 0);
+        } else {
+            return submatrix<1, C>(i, 0);
+        }
+    }
+
+    [[nodiscard]] constexpr decltype(auto) operator[](size_t i) const {
+        if constexpr (rows() == 1) {
+            return access(0, i);
+        } else if constexpr (columns() == 1) {
+            return access(i, 0);
+        } else {
+            return submatrix<1, C>(i, 0);
+        }
+    }
+
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
+        requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) {
+        return strided_view<T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, RowStride, ColStride>{
+                base + Offset + row * RowStride + column * ColStride};
+    }
+
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT>
+        requires(SUB_ROW_COUNT <= rows() && SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto submatrix(size_t row, size_t column) const {
+        return strided_view<const T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, RowStride, ColStride>{
+                base + Offset + row * RowStride + column * ColStride};
+    }
+
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT, size_t ROW, size_t COLUMN>
+        requires(ROW + SUB_ROW_COUNT <= rows() && COLUMN + SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto block() {
+        return strided_view<T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, RowStride, ColStride,
+                            Offset + ROW * RowStride + COLUMN * ColStride>{base};
+    }
+
+    template<size_t SUB_ROW_COUNT, size_t SUB_COLUMN_COUNT, size_t ROW, size_t COLUMN>
+        requires(ROW + SUB_ROW_COUNT <= rows() && COLUMN + SUB_COLUMN_COUNT <= columns())
+    [[nodiscard]] constexpr auto block() const {
+        return strided_view<const T, SUB_ROW_COUNT, SUB_COLUMN_COUNT, RowStride, ColStride,
+                            Offset + ROW * RowStride + COLUMN * ColStride>{base};
+    }
+
+    constexpr auto row_vector(size_t row) {
+        return submatrix<1, columns()>(row, 0);
+    }
+
+    constexpr auto row_vector(size_t row) const {
+        return submatrix<1, columns()>(row, 0);
+    }
+
+    constexpr auto column_vector(size_t column) {
+        return submatrix<rows(), 1>(0, column);
+    }
+
+    constexpr auto column_vector(size_t column) const {
+        return submatrix<rows(), 1>(0, column);
+    }
+
+    // a minor is not strided, it is copied out of the view
+    [[nodiscard]] constexpr auto minor(size_t row, size_t column) const {
+        static_assert(rows() > 1 && columns() > 1, "Matrix must be at least 2x2");
+        matrix<Type, R - 1, C - 1> res;
+        for (size_t i = 0; i < R - 1; i++) {
+            for (size_t j = 0; j < C - 1; j++) {
+                res.access(i, j) = access(i < row ? i : i + 1, j < column ? j : j + 1);
+            }
+        }
+        return res;
+    }
+
+    constexpr auto transposed() const {
+        return strided_view<T, C, R, ColStride, RowStride, Offset>{base};
+    }
+
+private:
+    T* base;
+};
+
+static_assert(std::is_trivially_copyable_v<matrix<float, 4, 4>>);
+static_assert(sizeof(matrix<float, 4, 4>) == 16 * sizeof(float));
+
 template<typename T, size_t N>
 using square_matrix = matrix<T, N, N>;
 
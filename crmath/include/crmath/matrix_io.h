@@ -0,0 +1,368 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cr::math {
+
+/*
+ * Binary container for arrays of matrix<T, N, M>:
+ * a 64 byte header followed by count matrices as raw bytes in native byte order, starting at data_offset.
+ * The data is 64 byte aligned in the file, so a mapped file can be used as a span of matrices directly.
+ */
+
+enum class element_type : uint32_t {
+    int8 = 1,
+    int16,
+    int32,
+    int64,
+    uint8,
+    uint16,
+    uint32,
+    uint64,
+    float32,
+    float64,
+    complex_float32,
+    complex_float64,
+};
+
+namespace impl {
+
+template<typename T>
+constexpr element_type element_type_of() {
+    if constexpr (std::is_same_v<T, int8_t>) return element_type::int8;
+    else if constexpr (std::is_same_v<T, int16_t>) return element_type::int16;
+    else if constexpr (std::is_same_v<T, int32_t>) return element_type::int32;
+    else if constexpr (std::is_same_v<T, int64_t>) return element_type::int64;
+    else if constexpr (std::is_same_v<T, uint8_t>) return element_type::uint8;
+    else if constexpr (std::is_same_v<T, uint16_t>) return element_type::uint16;
+    else if constexpr (std::is_same_v<T, uint32_t>) return element_type::uint32;
+    else if constexpr (std::is_same_v<T, uint64_t>) return element_type::uint64;
+    else if constexpr (std::is_same_v<T, float>) return element_type::float32;
+    else if constexpr (std::is_same_v<T, double>) return element_type::float64;
+    else if constexpr (std::is_same_v<T, std::complex<float>>) return element_type::complex_float32;
+    else if constexpr (std::is_same_v<T, std::complex<double>>) return element_type::complex_float64;
+    else static_assert(!sizeof(T), "Unsupported matrix element type");
+}
+
+}// namespace impl
+
+struct matrix_file_header {
+    static constexpr char expected_magic[8] = {'C', 'R', 'M', 'A', 'T', 'R', 'I', 'X'};
+    static constexpr uint32_t current_version = 1;
+    // written as 0x01020304, reads differently if the file comes from a machine with another byte order
+    static constexpr uint32_t byte_order_mark = 0x01020304;
+    static constexpr uint64_t data_alignment = 64;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    element_type type;
+    uint32_t element_size;
+    uint32_t rows;
+    uint32_t columns;
+    uint64_t count;
+    uint64_t data_offset;
+    char reserved[16];
+
+    template<typename T, size_t N, size_t M>
+    static constexpr matrix_file_header make(uint64_t count) {
+        matrix_file_header res{};
+        std::copy(std::begin(expected_magic), std::end(expected_magic), res.magic);
+        res.version = current_version;
+        res.byte_order = byte_order_mark;
+        res.type = impl::element_type_of<T>();
+        res.element_size = sizeof(T);
+        res.rows = N;
+        res.columns = M;
+        res.count = count;
+        res.data_offset = data_alignment;
+        return res;
+    }
+
+    /**
+     * @brief checks that the header describes matrix<T, N, M>, throws std::runtime_error otherwise
+     */
+    template<typename T, size_t N, size_t M>
+    void validate() const {
+        if (std::memcmp(magic, expected_magic, sizeof(magic)) != 0) {
+            throw std::runtime_error("Not a matrix file");
+        }
+        if (version != current_version) {
+            throw std::runtime_error("Unsupported matrix file version " + std::to_string(version));
+        }
+        if (byte_order != byte_order_mark) {
+            throw std::runtime_error("Matrix file has a different byte order");
+        }
+        if (type != impl::element_type_of<T>() || element_size != sizeof(T) || rows != N || columns != M) {
+            throw std::runtime_error("Matrix file contains " + std::to_string(rows) + "x" + std::to_string(columns) +
+                                     " matrices of another type");
+        }
+        if (data_offset < sizeof(matrix_file_header) || data_offset % data_alignment != 0) {
+            throw std::runtime_error("Matrix file has an invalid data offset");
+        }
+    }
+};
+static_assert(sizeof(matrix_file_header) == 64);
+static_assert(std::is_trivially_copyable_v<matrix_file_header>);
+
+/**
+ * @brief reads only the header, e.g. to find out which matrix type a file holds
+ */
+inline matrix_file_header read_matrix_file_header(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    matrix_file_header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Failed to read matrix file header of " + path.string());
+    }
+    return header;
+}
+
+/**
+ * @brief streaming writer, matrices are appended as they come and the count is patched in on close
+ */
+template<typename T, size_t N, size_t M>
+class matrix_writer {
+    static_assert(std::is_trivially_copyable_v<matrix<T, N, M>>);
+
+public:
+    explicit matrix_writer(const std::filesystem::path& path) : file(path, std::ios::binary | std::ios::trunc) {
+        if (!file) {
+            throw std::runtime_error("Failed to open " + path.string() + " for writing");
+        }
+        auto header = matrix_file_header::make<T, N, M>(0);
+        char padding[matrix_file_header::data_alignment]{};
+        std::memcpy(padding, &header, sizeof(header));
+        file.write(padding, sizeof(padding));
+    }
+
+    matrix_writer(const matrix_writer&) = delete;
+    matrix_writer& operator=(const matrix_writer&) = delete;
+    matrix_writer(matrix_writer&&) noexcept = default;
+
+    /**
+     * @brief closes the file written so far, like the destructor but throwing on failure, and takes over other's
+     */
+    matrix_writer& operator=(matrix_writer&& other) {
+        if (this != &other) {
+            if (file.is_open()) {
+                close();
+            }
+            file = std::move(other.file);
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+
+    ~matrix_writer() {
+        if (file.is_open()) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+
+    void write(const matrix<T, N, M>& mat) {
+        write(std::span<const matrix<T, N, M>>(&mat, 1));
+    }
+
+    void write(std::span<const matrix<T, N, M>> mats) {
+        file.write(reinterpret_cast<const char*>(mats.data()), std::streamsize(mats.size_bytes()));
+        if (!file) {
+            throw std::runtime_error("Failed to write matrices");
+        }
+        count += mats.size();
+    }
+
+    [[nodiscard]] uint64_t size() const {
+        return count;
+    }
+
+    /**
+     * @brief writes the final count into the header, the file is only readable after this
+     */
+    void close() {
+        auto header = matrix_file_header::make<T, N, M>(count);
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.close();
+        if (file.fail()) {
+            throw std::runtime_error("Failed to finish matrix file");
+        }
+    }
+
+private:
+    std::ofstream file;
+    uint64_t count = 0;
+};
+
+/**
+ * @brief read only memory mapping of a matrix file, the matrices are used in place without parsing or copying
+ * @details pages are loaded on first access, so opening takes the same time for any file size
+ */
+template<typename T, size_t N, size_t M>
+class mapped_matrix_file {
+    static_assert(std::is_trivially_copyable_v<matrix<T, N, M>>);
+
+public:
+    explicit mapped_matrix_file(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + path.string());
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || size_t(info.st_size) < sizeof(matrix_file_header)) {
+            ::close(fd);
+            throw std::runtime_error(path.string() + " is too small for a matrix file");
+        }
+        length = size_t(info.st_size);
+        mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            mapping = nullptr;
+            throw std::runtime_error("Failed to map " + path.string());
+        }
+        try {
+            header().template validate<T, N, M>();
+            // written without sums or products of header fields, so a corrupt header cannot wrap around the check
+            if (header().data_offset > length ||
+                header().count > (length - header().data_offset) / sizeof(matrix<T, N, M>)) {
+                throw std::runtime_error(path.string() + " is truncated");
+            }
+        } catch (...) {
+            ::munmap(mapping, length);
+            throw;
+        }
+    }
+
+    mapped_matrix_file(const mapped_matrix_file&) = delete;
+    mapped_matrix_file& operator=(const mapped_matrix_file&) = delete;
+
+    mapped_matrix_file(mapped_matrix_file&& other) noexcept
+        : mapping(std::exchange(other.mapping, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    mapped_matrix_file& operator=(mapped_matrix_file&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            mapping = std::exchange(other.mapping, nullptr);
+            length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_matrix_file() {
+        unmap();
+    }
+
+    [[nodiscard]] const matrix_file_header& header() const {
+        return *static_cast<const matrix_file_header*>(mapping);
+    }
+
+    [[nodiscard]] std::span<const matrix<T, N, M>> matrices() const {
+        auto* first = static_cast<const std::byte*>(mapping) + header().data_offset;
+        return {reinterpret_cast<const matrix<T, N, M>*>(first), size_t(header().count)};
+    }
+
+    [[nodiscard]] size_t size() const {
+        return size_t(header().count);
+    }
+
+    [[nodiscard]] const matrix<T, N, M>& operator[](size_t i) const {
+        return matrices()[i];
+    }
+
+    [[nodiscard]] auto begin() const {
+        return matrices().begin();
+    }
+
+    [[nodiscard]] auto end() const {
+        return matrices().end();
+    }
+
+    /**
+     * @brief hints the kernel to read ahead, for one pass over the whole file
+     */
+    void advise_sequential() const {
+        // advice values are not flags, each one needs its own call
+        ::madvise(mapping, length, MADV_SEQUENTIAL);
+        ::madvise(mapping, length, MADV_WILLNEED);
+    }
+
+private:
+    void unmap() {
+        if (mapping != nullptr) {
+            ::munmap(mapping, length);
+            mapping = nullptr;
+        }
+    }
+
+    void* mapping = nullptr;
+    size_t length = 0;
+};
+
+/**
+ * @brief reads a matrix file in chunks into caller provided memory, for files that are processed once
+ */
+template<typename T, size_t N, size_t M>
+class matrix_reader {
+    static_assert(std::is_trivially_copyable_v<matrix<T, N, M>>);
+
+public:
+    explicit matrix_reader(const std::filesystem::path& path) : file(path, std::ios::binary) {
+        if (!file.read(reinterpret_cast<char*>(&header_data), sizeof(header_data))) {
+            throw std::runtime_error("Failed to read matrix file header of " + path.string());
+        }
+        header_data.template validate<T, N, M>();
+        file.seekg(std::streamoff(header_data.data_offset));
+        remaining_count = header_data.count;
+    }
+
+    [[nodiscard]] const matrix_file_header& header() const {
+        return header_data;
+    }
+
+    [[nodiscard]] uint64_t remaining() const {
+        return remaining_count;
+    }
+
+    /**
+     * @brief fills out with the next matrices and returns how many were read, 0 at the end of the file
+     */
+    size_t read(std::span<matrix<T, N, M>> out) {
+        size_t count = size_t(std::min<uint64_t>(out.size(), remaining_count));
+        if (count == 0) {
+            return 0;
+        }
+        if (!file.read(reinterpret_cast<char*>(out.data()), std::streamsize(count * sizeof(matrix<T, N, M>)))) {
+            throw std::runtime_error("Matrix file is truncated");
+        }
+        remaining_count -= count;
+        return count;
+    }
+
+private:
+    std::ifstream file;
+    matrix_file_header header_data{};
+    uint64_t remaining_count = 0;
+};
+
+}// namespace cr::math
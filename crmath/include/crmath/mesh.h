@@ -0,0 +1,380 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cr::math {
+
+/*
+ * Preprocessing for indexed triangle lists, meant to run once when a mesh is loaded:
+ * deduplicate -> optimize_vertex_cache -> optimize_overdraw (optional) -> optimize_vertex_fetch -> compact_indices.
+ * Vertices are compared bytewise, so padding in a vertex type has to be zero initialized.
+ */
+
+template<typename Vertex>
+struct indexed_mesh {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+struct vertex_cache_statistics {
+    // vertices the GPU had to transform, counting repeats
+    size_t transformed = 0;
+    // average cache miss ratio, transformed vertices per triangle, between 0.5 and 3
+    float acmr = 0;
+    // average transformed to vertex ratio, 1 is optimal
+    float atvr = 0;
+};
+
+namespace impl {
+
+inline uint64_t hash_bytes(const void* data, size_t size) {
+    auto* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+constexpr size_t forsyth_cache_size = 32;
+
+constexpr size_t forsyth_max_valence = 32;
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation" (2006), tabulated since it is evaluated per cache entry and step
+struct forsyth_score_table {
+    float cache[forsyth_cache_size];
+    float valence[forsyth_max_valence];
+
+    forsyth_score_table() {
+        for (size_t i = 0; i < forsyth_cache_size; i++) {
+            // the last triangle gets a fixed score so it is not simply repeated
+            cache[i] = i < 3 ? 0.75f : std::pow(1.0f - float(i - 3) / float(forsyth_cache_size - 3), 1.5f);
+        }
+        for (size_t i = 0; i < forsyth_max_valence; i++) {
+            // prefer vertices with few triangles left, they can be finished and leave the cache
+            valence[i] = 2.0f / std::sqrt(float(i + 1));
+        }
+    }
+
+    [[nodiscard]] float operator()(int cache_position, uint32_t remaining_triangles) const {
+        if (remaining_triangles == 0) {
+            return -1.0f;
+        }
+        float score = cache_position >= 0 ? cache[cache_position] : 0.0f;
+        return score + (remaining_triangles <= forsyth_max_valence ? valence[remaining_triangles - 1]
+                                                                   : 2.0f / std::sqrt(float(remaining_triangles)));
+    }
+};
+
+}// namespace impl
+
+/**
+ * @brief merges bytewise identical vertices and rewrites the indices to the unique ones
+ * @details vertices keep the order of their first occurrence
+ */
+template<typename Vertex>
+indexed_mesh<Vertex> deduplicate(std::span<const Vertex> vertices, std::span<const uint32_t> indices) {
+    static_assert(std::is_trivially_copyable_v<Vertex>, "Vertices are compared and hashed as bytes");
+    indexed_mesh<Vertex> res;
+    res.indices.reserve(indices.size());
+    size_t table_size = std::bit_ceil(std::max<size_t>(vertices.size() * 2, 16));
+    std::vector<uint32_t> table(table_size, ~0u);
+    std::vector<uint32_t> remap(vertices.size(), ~0u);
+    for (auto index: indices) {
+        if (remap[index] == ~0u) {
+            const auto& vertex = vertices[index];
+            size_t slot = impl::hash_bytes(&vertex, sizeof(Vertex)) & (table_size - 1);
+            // linear probing on ids of unique vertices
+            while (table[slot] != ~0u && std::memcmp(&res.vertices[table[slot]], &vertex, sizeof(Vertex)) != 0) {
+                slot = (slot + 1) & (table_size - 1);
+            }
+            if (table[slot] == ~0u) {
+                table[slot] = uint32_t(res.vertices.size());
+                res.vertices.push_back(vertex);
+            }
+            remap[index] = table[slot];
+        }
+        res.indices.push_back(remap[index]);
+    }
+    return res;
+}
+
+/**
+ * @brief builds an indexed mesh from a triangle soup, three vertices per triangle
+ */
+template<typename Vertex>
+indexed_mesh<Vertex> deduplicate(std::span<const Vertex> vertices) {
+    std::vector<uint32_t> indices(vertices.size());
+    std::iota(indices.begin(), indices.end(), 0u);
+    return deduplicate(vertices, std::span<const uint32_t>(indices));
+}
+
+/**
+ * @brief simulates a FIFO post transform cache of cache_size entries
+ * @details all statistics are 0 for less than one triangle
+ */
+inline vertex_cache_statistics analyze_vertex_cache(std::span<const uint32_t> indices, size_t vertex_count,
+                                                    size_t cache_size = 16) {
+    vertex_cache_statistics res;
+    if (indices.size() < 3 || vertex_count == 0) {
+        return res;
+    }
+    // a vertex is cached while fewer than cache_size misses happened since it was loaded
+    std::vector<size_t> loaded_at(vertex_count, 0);
+    size_t timestamp = cache_size + 1;
+    for (auto index: indices) {
+        if (timestamp - loaded_at[index] > cache_size) {
+            loaded_at[index] = timestamp++;
+            res.transformed++;
+        }
+    }
+    res.acmr = float(res.transformed) / float(indices.size() / 3);
+    res.atvr = float(res.transformed) / float(vertex_count);
+    return res;
+}
+
+/**
+ * @brief reorders the triangles for the post transform vertex cache, in place
+ * @details greedy algorithm from Tom Forsyth, it does not depend on the exact cache size of the GPU
+ */
+inline void optimize_vertex_cache(std::span<uint32_t> indices, size_t vertex_count) {
+    constexpr size_t cache_size = impl::forsyth_cache_size;
+    size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // triangles of every vertex, the first remaining[v] entries of a range are the ones not emitted yet
+    std::vector<uint32_t> remaining(vertex_count, 0);
+    for (auto index: indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> offsets(vertex_count + 1, 0);
+    for (size_t v = 0; v < vertex_count; v++) {
+        offsets[v + 1] = offsets[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t t = 0; t < triangle_count; t++) {
+            for (size_t k = 0; k < 3; k++) {
+                adjacency[cursor[indices[3 * t + k]]++] = uint32_t(t);
+            }
+        }
+    }
+
+    static const impl::forsyth_score_table vertex_score_of;
+    std::vector<int> cache_position(vertex_count, -1);
+    std::vector<float> vertex_score(vertex_count);
+    for (size_t v = 0; v < vertex_count; v++) {
+        vertex_score[v] = vertex_score_of(-1, remaining[v]);
+    }
+    std::vector<float> triangle_score(triangle_count);
+    std::vector<bool> emitted(triangle_count, false);
+    auto score_of = [&](size_t t) {
+        return vertex_score[indices[3 * t]] + vertex_score[indices[3 * t + 1]] + vertex_score[indices[3 * t + 2]];
+    };
+    size_t best = 0;
+    for (size_t t = 0; t < triangle_count; t++) {
+        triangle_score[t] = score_of(t);
+        if (triangle_score[t] > triangle_score[best]) {
+            best = t;
+        }
+    }
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    uint32_t cache[cache_size + 3];
+    uint32_t new_cache[cache_size + 3];
+    size_t cache_count = 0;
+    size_t next_unemitted = 0;
+
+    while (result.size() < indices.size()) {
+        if (best == triangle_count) {
+            // nothing in the cache has triangles left, continue with the next triangle in input order
+            while (emitted[next_unemitted]) {
+                next_unemitted++;
+            }
+            best = next_unemitted;
+        }
+        uint32_t tri[3] = {indices[3 * best], indices[3 * best + 1], indices[3 * best + 2]};
+        emitted[best] = true;
+        for (auto v: tri) {
+            result.push_back(v);
+            auto begin = adjacency.begin() + offsets[v];
+            auto last = begin + remaining[v] - 1;
+            std::iter_swap(std::find(begin, last, uint32_t(best)), last);
+            remaining[v]--;
+        }
+
+        // the triangle moves to the front, everything else moves back
+        size_t new_count = 0;
+        for (auto v: tri) {
+            new_cache[new_count++] = v;
+        }
+        for (size_t i = 0; i < cache_count; i++) {
+            auto v = cache[i];
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                new_cache[new_count++] = v;
+            }
+        }
+        for (size_t i = 0; i < new_count; i++) {
+            auto v = new_cache[i];
+            cache_position[v] = i < cache_size ? int(i) : -1;
+            vertex_score[v] = vertex_score_of(cache_position[v], remaining[v]);
+        }
+
+        best = triangle_count;
+        float best_score = -1.0f;
+        for (size_t i = 0; i < new_count; i++) {
+            auto v = new_cache[i];
+            for (uint32_t a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                auto t = adjacency[a];
+                triangle_score[t] = score_of(t);
+                if (triangle_score[t] > best_score) {
+                    best_score = triangle_score[t];
+                    best = t;
+                }
+            }
+        }
+        cache_count = std::min(new_count, cache_size);
+        std::copy(new_cache, new_cache + cache_count, cache);
+    }
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+/**
+ * @brief reorders clusters of a cache optimized index buffer so that outward facing parts are drawn first
+ * @details clusters start wherever the simulated cache misses all three vertices, so the cache efficiency
+ * inside a cluster is kept. Clusters are sorted by how far they face away from the mesh center,
+ * following Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007).
+ * position has to return a cvector<float, 3> for a vertex.
+ */
+template<typename Vertex, typename PositionFunc>
+void optimize_overdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, PositionFunc position,
+                       size_t cache_size = 16) {
+    size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+    std::vector<size_t> cluster_begin;
+    {
+        std::vector<size_t> loaded_at(vertices.size(), 0);
+        size_t timestamp = cache_size + 1;
+        for (size_t t = 0; t < triangle_count; t++) {
+            size_t misses = 0;
+            for (size_t k = 0; k < 3; k++) {
+                auto index = indices[3 * t + k];
+                if (timestamp - loaded_at[index] > cache_size) {
+                    loaded_at[index] = timestamp++;
+                    misses++;
+                }
+            }
+            if (t == 0 || misses == 3) {
+                cluster_begin.push_back(t);
+            }
+        }
+        cluster_begin.push_back(triangle_count);
+    }
+
+    cvector<float, 3> mesh_center{};
+    for (const auto& vertex: vertices) {
+        mesh_center += position(vertex);
+    }
+    mesh_center /= float(vertices.size());
+
+    size_t cluster_count = cluster_begin.size() - 1;
+    std::vector<float> sort_key(cluster_count);
+    for (size_t c = 0; c < cluster_count; c++) {
+        cvector<float, 3> center{};
+        cvector<float, 3> normal{};
+        float area = 0;
+        for (size_t t = cluster_begin[c]; t < cluster_begin[c + 1]; t++) {
+            cvector<float, 3> p0 = position(vertices[indices[3 * t]]);
+            cvector<float, 3> p1 = position(vertices[indices[3 * t + 1]]);
+            cvector<float, 3> p2 = position(vertices[indices[3 * t + 2]]);
+            cvector<float, 3> e1 = p1 - p0;
+            cvector<float, 3> e2 = p2 - p0;
+            // cross product, its length is twice the triangle area
+            cvector<float, 3> n{e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            float twice_area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            center += (p0 + p1 + p2) * (twice_area / 3.0f);
+            normal += n;
+            area += twice_area;
+        }
+        if (area > 0) {
+            center /= area;
+        }
+        cvector<float, 3> offset = center - mesh_center;
+        sort_key[c] = offset[0] * normal[0] + offset[1] * normal[1] + offset[2] * normal[2];
+    }
+
+    std::vector<size_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sort_key[a] > sort_key[b]; });
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (auto c: order) {
+        result.insert(result.end(), indices.begin() + 3 * cluster_begin[c], indices.begin() + 3 * cluster_begin[c + 1]);
+    }
+    std::copy(result.begin(), result.end(), indices.begin());
+}
+
+/**
+ * @brief reorders vertices by first use in the index buffer and drops unused ones, in place
+ * @return the new vertex count, vertices past it are left unspecified
+ */
+template<typename Vertex>
+size_t optimize_vertex_fetch(std::span<Vertex> vertices, std::span<uint32_t> indices) {
+    std::vector<uint32_t> remap(vertices.size(), ~0u);
+    uint32_t next = 0;
+    for (auto& index: indices) {
+        if (remap[index] == ~0u) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+    std::vector<Vertex> reordered(next);
+    for (size_t v = 0; v < vertices.size(); v++) {
+        if (remap[v] != ~0u) {
+            reordered[remap[v]] = vertices[v];
+        }
+    }
+    std::copy(reordered.begin(), reordered.end(), vertices.begin());
+    return next;
+}
+
+template<typename Vertex>
+void optimize_vertex_fetch(indexed_mesh<Vertex>& mesh) {
+    mesh.vertices.resize(optimize_vertex_fetch(std::span<Vertex>(mesh.vertices), std::span<uint32_t>(mesh.indices)));
+}
+
+/**
+ * @brief 16 bit copy of the indices for vk::IndexType::eUint16, halves the index buffer
+ * @details std::nullopt if an index does not fit, 0xFFFF is left out because it restarts primitives
+ */
+inline std::optional<std::vector<uint16_t>> compact_indices(std::span<const uint32_t> indices) {
+    std::vector<uint16_t> res(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        if (indices[i] >= 0xFFFF) {
+            return std::nullopt;
+        }
+        res[i] = uint16_t(indices[i]);
+    }
+    return res;
+}
+
+}// namespace cr::math
@@ -0,0 +1,652 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace cr::math {
+
+/**
+ * @brief axis aligned box in 2D, min and max are inclusive
+ * @details a default constructed box is empty: it contains nothing and merging anything into it yields that thing
+ */
+struct aabb {
+    static constexpr float inf = std::numeric_limits<float>::infinity();
+
+    cvector<float, 2> min{inf, inf};
+    cvector<float, 2> max{-inf, -inf};
+
+    constexpr aabb() = default;
+    constexpr aabb(const cvector<float, 2>& min, const cvector<float, 2>& max) : min(min), max(max) {}
+
+    /**
+     * @brief box that contains everything, for objects that must never be culled
+     */
+    static constexpr aabb everything() {
+        return {{-inf, -inf}, {inf, inf}};
+    }
+
+    [[nodiscard]] constexpr bool empty() const {
+        return min[0] > max[0] || min[1] > max[1];
+    }
+
+    [[nodiscard]] constexpr bool contains(const cvector<float, 2>& p) const {
+        return p[0] >= min[0] && p[0] <= max[0] && p[1] >= min[1] && p[1] <= max[1];
+    }
+
+    [[nodiscard]] constexpr bool contains(const aabb& other) const {
+        return other.min[0] >= min[0] && other.max[0] <= max[0] && other.min[1] >= min[1] && other.max[1] <= max[1];
+    }
+
+    [[nodiscard]] constexpr bool intersects(const aabb& other) const {
+        return other.min[0] <= max[0] && other.max[0] >= min[0] && other.min[1] <= max[1] && other.max[1] >= min[1];
+    }
+
+    constexpr void expand(const cvector<float, 2>& p) {
+        min = {std::min(min[0], p[0]), std::min(min[1], p[1])};
+        max = {std::max(max[0], p[0]), std::max(max[1], p[1])};
+    }
+
+    constexpr void expand(const aabb& other) {
+        min = {std::min(min[0], other.min[0]), std::min(min[1], other.min[1])};
+        max = {std::max(max[0], other.max[0]), std::max(max[1], other.max[1])};
+    }
+
+    [[nodiscard]] constexpr aabb merged(const aabb& other) const {
+        aabb res = *this;
+        res.expand(other);
+        return res;
+    }
+
+    [[nodiscard]] constexpr cvector<float, 2> center() const {
+        return {(min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f};
+    }
+
+    [[nodiscard]] constexpr cvector<float, 2> extent() const {
+        return {max[0] - min[0], max[1] - min[1]};
+    }
+
+    /**
+     * @brief the 2D analogue of the surface area, proportional to the chance that a random ray hits the box
+     */
+    [[nodiscard]] constexpr float half_perimeter() const {
+        return empty() ? 0.0f : (max[0] - min[0]) + (max[1] - min[1]);
+    }
+
+    bool operator==(const aabb& other) const {
+        return min == other.min && max == other.max;
+    }
+};
+
+struct ray {
+    cvector<float, 2> origin;
+    // does not have to be normalized, hit distances are in multiples of it
+    cvector<float, 2> direction;
+
+    [[nodiscard]] constexpr cvector<float, 2> at(float t) const {
+        return {origin[0] + direction[0] * t, origin[1] + direction[1] * t};
+    }
+};
+
+struct ray_hit {
+    uint32_t id;
+    float t;
+};
+
+namespace impl {
+
+// ray with the reciprocal direction precomputed, a zero component becomes an infinity and the slab test still works
+struct prepared_ray {
+    float origin[2];
+    float inv_direction[2];
+
+    explicit prepared_ray(const ray& r)
+        : origin{r.origin[0], r.origin[1]}, inv_direction{1.0f / r.direction[0], 1.0f / r.direction[1]} {}
+
+    // entry distance into box if it is hit within [0, max_t]
+    [[nodiscard]] std::optional<float> intersect(const aabb& box, float max_t) const {
+        float t0 = 0.0f;
+        float t1 = max_t;
+        for (size_t axis = 0; axis < 2; axis++) {
+            float near = (box.min[axis] - origin[axis]) * inv_direction[axis];
+            float far = (box.max[axis] - origin[axis]) * inv_direction[axis];
+            if (near > far) {
+                std::swap(near, far);
+            }
+            // NaN from 0 * inf (origin on the slab border with a parallel ray) must not shrink the interval
+            t0 = near > t0 ? near : t0;
+            t1 = far < t1 ? far : t1;
+        }
+        if (t0 > t1) {
+            return std::nullopt;
+        }
+        return t0;
+    }
+};
+
+// callbacks may return void to see every result, or bool where false stops the query
+template<typename F>
+bool report(F& f, uint32_t id) {
+    if constexpr (std::is_same_v<std::invoke_result_t<F&, uint32_t>, bool>) {
+        return f(id);
+    } else {
+        f(id);
+        return true;
+    }
+}
+
+}// namespace impl
+
+/**
+ * @brief intersection of a ray with a box
+ * @return distance along the ray at which it enters the box, 0 if it starts inside
+ */
+inline std::optional<float> intersect(const ray& r, const aabb& box,
+                                      float max_t = std::numeric_limits<float>::infinity()) {
+    return impl::prepared_ray(r).intersect(box, max_t);
+}
+
+/**
+ * @brief uniform grid over a fixed area, for objects that move or change every frame
+ * @details every object is listed in each cell its box overlaps, so insert, update and remove only touch those cells
+ * and an update within the same cells is just a store. Objects outside the grid area are kept in the border cells:
+ * point and rect queries still find them, rays are only traced inside the grid area.
+ * Cells should be about as large as a typical object.
+ */
+class uniform_grid {
+public:
+    using id = uint32_t;
+
+    uniform_grid(const aabb& area, float cell_size)
+        : area(area), cell_size(cell_size), inv_cell_size(1.0f / cell_size),
+          cells_x(std::max<int32_t>(1, int32_t(std::ceil((area.max[0] - area.min[0]) / cell_size)))),
+          cells_y(std::max<int32_t>(1, int32_t(std::ceil((area.max[1] - area.min[1]) / cell_size)))),
+          cells(size_t(cells_x) * size_t(cells_y)) {
+        assert(!area.empty() && cell_size > 0);
+    }
+
+    /**
+     * @brief adds an object, ids of removed objects are reused
+     */
+    id insert(const aabb& box) {
+        id object;
+        if (free_ids.empty()) {
+            object = id(entries.size());
+            entries.emplace_back();
+        } else {
+            object = free_ids.back();
+            free_ids.pop_back();
+        }
+        auto& e = entries[object];
+        e.box = box;
+        e.cells = cell_range_of(box);
+        e.alive = true;
+        add_to_cells(object, e.cells);
+        live++;
+        return object;
+    }
+
+    void update(id object, const aabb& box) {
+        auto& e = entries[object];
+        assert(e.alive);
+        auto range = cell_range_of(box);
+        e.box = box;
+        if (range == e.cells) {
+            return;
+        }
+        remove_from_cells(object, e.cells);
+        add_to_cells(object, range);
+        e.cells = range;
+    }
+
+    void remove(id object) {
+        auto& e = entries[object];
+        assert(e.alive);
+        remove_from_cells(object, e.cells);
+        e.alive = false;
+        free_ids.push_back(object);
+        live--;
+    }
+
+    void clear() {
+        for (auto& cell : cells) {
+            cell.clear();
+        }
+        entries.clear();
+        free_ids.clear();
+        live = 0;
+    }
+
+    [[nodiscard]] const aabb& bounds(id object) const {
+        return entries[object].box;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return live;
+    }
+
+    /**
+     * @brief calls f(id) for every object whose box contains p
+     */
+    template<typename F>
+    void query(const cvector<float, 2>& p, F&& f) const {
+        for (id object : cells[cell_index(cell_x(p[0]), cell_y(p[1]))]) {
+            if (entries[object].box.contains(p) && !impl::report(f, object)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief calls f(id) once for every object whose box intersects box
+     */
+    template<typename F>
+    void query(const aabb& box, F&& f) const {
+        if (box.empty()) {
+            return;
+        }
+        auto range = cell_range_of(box);
+        for (int32_t y = range.y0; y <= range.y1; y++) {
+            for (int32_t x = range.x0; x <= range.x1; x++) {
+                for (id object : cells[cell_index(x, y)]) {
+                    const auto& e = entries[object];
+                    // objects spanning several cells are only reported from the first cell both ranges share
+                    if (x != std::max(range.x0, e.cells.x0) || y != std::max(range.y0, e.cells.y0)) {
+                        continue;
+                    }
+                    if (e.box.intersects(box) && !impl::report(f, object)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief closest object hit by r within max_t
+     * @details walks the cells along the ray and stops as soon as a hit is closer than the next cell
+     */
+    [[nodiscard]] std::optional<ray_hit> raycast(const ray& r, float max_t = std::numeric_limits<float>::infinity()) const {
+        impl::prepared_ray prepared(r);
+        auto entry = prepared.intersect(area, max_t);
+        if (!entry) {
+            return std::nullopt;
+        }
+        auto start = r.at(*entry);
+        int32_t x = cell_x(start[0]);
+        int32_t y = cell_y(start[1]);
+        int32_t step_x = r.direction[0] > 0 ? 1 : (r.direction[0] < 0 ? -1 : 0);
+        int32_t step_y = r.direction[1] > 0 ? 1 : (r.direction[1] < 0 ? -1 : 0);
+        constexpr float inf = std::numeric_limits<float>::infinity();
+        float next_x = step_x == 0 ? inf
+                                   : (area.min[0] + float(x + (step_x > 0)) * cell_size - r.origin[0]) * prepared.inv_direction[0];
+        float next_y = step_y == 0 ? inf
+                                   : (area.min[1] + float(y + (step_y > 0)) * cell_size - r.origin[1]) * prepared.inv_direction[1];
+        float delta_x = step_x == 0 ? inf : cell_size * std::abs(prepared.inv_direction[0]);
+        float delta_y = step_y == 0 ? inf : cell_size * std::abs(prepared.inv_direction[1]);
+
+        std::optional<ray_hit> best;
+        float best_t = max_t;
+        while (true) {
+            for (id object : cells[cell_index(x, y)]) {
+                if (auto t = prepared.intersect(entries[object].box, best_t); t && (!best || *t < best_t)) {
+                    best = ray_hit{object, *t};
+                    best_t = *t;
+                }
+            }
+            float exit = std::min(next_x, next_y);
+            if (best_t <= exit || exit > max_t) {
+                break;
+            }
+            if (next_x < next_y) {
+                x += step_x;
+                next_x += delta_x;
+                if (x < 0 || x >= cells_x) break;
+            } else {
+                y += step_y;
+                next_y += delta_y;
+                if (y < 0 || y >= cells_y) break;
+            }
+        }
+        return best;
+    }
+
+private:
+    struct cell_range {
+        int32_t x0, y0, x1, y1;
+        bool operator==(const cell_range&) const = default;
+    };
+
+    struct entry {
+        aabb box;
+        cell_range cells{};
+        bool alive = false;
+    };
+
+    [[nodiscard]] int32_t cell_x(float x) const {
+        return std::clamp(int32_t(std::floor((x - area.min[0]) * inv_cell_size)), int32_t(0), cells_x - 1);
+    }
+
+    [[nodiscard]] int32_t cell_y(float y) const {
+        return std::clamp(int32_t(std::floor((y - area.min[1]) * inv_cell_size)), int32_t(0), cells_y - 1);
+    }
+
+    [[nodiscard]] size_t cell_index(int32_t x, int32_t y) const {
+        return size_t(y) * size_t(cells_x) + size_t(x);
+    }
+
+    [[nodiscard]] cell_range cell_range_of(const aabb& box) const {
+        return {cell_x(box.min[0]), cell_y(box.min[1]), cell_x(box.max[0]), cell_y(box.max[1])};
+    }
+
+    void add_to_cells(id object, const cell_range& range) {
+        for (int32_t y = range.y0; y <= range.y1; y++) {
+            for (int32_t x = range.x0; x <= range.x1; x++) {
+                cells[cell_index(x, y)].push_back(object);
+            }
+        }
+    }
+
+    void remove_from_cells(id object, const cell_range& range) {
+        for (int32_t y = range.y0; y <= range.y1; y++) {
+            for (int32_t x = range.x0; x <= range.x1; x++) {
+                auto& cell = cells[cell_index(x, y)];
+                auto it = std::find(cell.begin(), cell.end(), object);
+                assert(it != cell.end());
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+
+    aabb area;
+    float cell_size;
+    float inv_cell_size;
+    int32_t cells_x;
+    int32_t cells_y;
+    std::vector<std::vector<id>> cells;
+    std::vector<entry> entries;
+    std::vector<id> free_ids;
+    size_t live = 0;
+};
+
+/**
+ * @brief bounding volume hierarchy for objects that rarely move, built with the binned surface area heuristic
+ * @details the id of an object is its index in the span passed to build(). refit() moves single objects without a
+ * rebuild, the tree stays correct but gets slower to query the further objects move from where they were built.
+ */
+class bvh {
+public:
+    using id = uint32_t;
+
+    bvh() = default;
+
+    explicit bvh(std::span<const aabb> boxes) {
+        build(boxes);
+    }
+
+    void build(std::span<const aabb> new_boxes) {
+        boxes.assign(new_boxes.begin(), new_boxes.end());
+        nodes.clear();
+        parents.clear();
+        indices.resize(boxes.size());
+        leaf_of.resize(boxes.size());
+        if (boxes.empty()) {
+            return;
+        }
+        std::vector<cvector<float, 2>> centers(boxes.size());
+        for (id i = 0; i < id(boxes.size()); i++) {
+            indices[i] = i;
+            centers[i] = boxes[i].center();
+        }
+        nodes.reserve(2 * boxes.size());
+        parents.reserve(2 * boxes.size());
+        nodes.push_back({{}, 0, id(boxes.size())});
+        parents.push_back(no_node);
+
+        struct work {
+            id node;
+            uint32_t depth;
+        };
+        std::vector<work> stack{{0, 0}};
+        while (!stack.empty()) {
+            auto [index, depth] = stack.back();
+            stack.pop_back();
+            auto first = nodes[index].first;
+            auto count = nodes[index].count;
+            aabb box;
+            aabb center_box;
+            for (id i = first; i < first + count; i++) {
+                box.expand(boxes[indices[i]]);
+                center_box.expand(centers[indices[i]]);
+            }
+            nodes[index].box = box;
+
+            auto split = depth + 1 < max_depth && count > max_leaf_size ? find_split(first, count, box, center_box, centers)
+                                                                        : std::nullopt;
+            if (!split) {
+                for (id i = first; i < first + count; i++) {
+                    leaf_of[indices[i]] = index;
+                }
+                continue;
+            }
+            auto middle = std::partition(indices.begin() + first, indices.begin() + first + count, [&](id object) {
+                return bin_of(centers[object][split->axis], center_box, split->axis) < split->bin;
+            });
+            auto left_count = id(middle - (indices.begin() + first));
+            auto left = id(nodes.size());
+            nodes.push_back({{}, first, left_count});
+            nodes.push_back({{}, first + left_count, count - left_count});
+            parents.push_back(index);
+            parents.push_back(index);
+            nodes[index].first = left;
+            nodes[index].count = 0;
+            stack.push_back({left, depth + 1});
+            stack.push_back({left + 1, depth + 1});
+        }
+    }
+
+    /**
+     * @brief moves one object and updates the boxes of its ancestors
+     */
+    void refit(id object, const aabb& box) {
+        boxes[object] = box;
+        auto index = leaf_of[object];
+        aabb leaf_box;
+        for (id i = nodes[index].first; i < nodes[index].first + nodes[index].count; i++) {
+            leaf_box.expand(boxes[indices[i]]);
+        }
+        nodes[index].box = leaf_box;
+        for (index = parents[index]; index != no_node; index = parents[index]) {
+            auto merged = nodes[nodes[index].first].box.merged(nodes[nodes[index].first + 1].box);
+            if (merged == nodes[index].box) {
+                break;
+            }
+            nodes[index].box = merged;
+        }
+    }
+
+    [[nodiscard]] const aabb& bounds(id object) const {
+        return boxes[object];
+    }
+
+    [[nodiscard]] aabb bounds() const {
+        return nodes.empty() ? aabb{} : nodes[0].box;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return boxes.size();
+    }
+
+    /**
+     * @brief calls f(id) for every object whose box contains p
+     */
+    template<typename F>
+    void query(const cvector<float, 2>& p, F&& f) const {
+        traverse([&](const aabb& box) { return box.contains(p); }, f);
+    }
+
+    /**
+     * @brief calls f(id) for every object whose box intersects box
+     */
+    template<typename F>
+    void query(const aabb& box, F&& f) const {
+        traverse([&](const aabb& other) { return other.intersects(box); }, f);
+    }
+
+    /**
+     * @brief closest object hit by r within max_t, children are visited front to back so far subtrees are skipped
+     */
+    [[nodiscard]] std::optional<ray_hit> raycast(const ray& r, float max_t = std::numeric_limits<float>::infinity()) const {
+        if (nodes.empty()) {
+            return std::nullopt;
+        }
+        impl::prepared_ray prepared(r);
+        std::optional<ray_hit> best;
+        float best_t = max_t;
+        if (!prepared.intersect(nodes[0].box, best_t)) {
+            return std::nullopt;
+        }
+        id stack[max_depth + 1];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const auto& n = nodes[stack[--top]];
+            if (n.count > 0) {
+                for (id i = n.first; i < n.first + n.count; i++) {
+                    if (auto t = prepared.intersect(boxes[indices[i]], best_t); t && (!best || *t < best_t)) {
+                        best = ray_hit{indices[i], *t};
+                        best_t = *t;
+                    }
+                }
+                continue;
+            }
+            auto t_left = prepared.intersect(nodes[n.first].box, best_t);
+            auto t_right = prepared.intersect(nodes[n.first + 1].box, best_t);
+            if (t_left && t_right) {
+                // the nearer child is popped first
+                bool left_first = *t_left <= *t_right;
+                stack[top++] = left_first ? n.first + 1 : n.first;
+                stack[top++] = left_first ? n.first : n.first + 1;
+            } else if (t_left) {
+                stack[top++] = n.first;
+            } else if (t_right) {
+                stack[top++] = n.first + 1;
+            }
+        }
+        return best;
+    }
+
+private:
+    static constexpr id no_node = ~id(0);
+    static constexpr uint32_t max_leaf_size = 4;
+    static constexpr uint32_t bin_count = 16;
+    // bounds the traversal stack, deeper subtrees become leaves
+    static constexpr uint32_t max_depth = 48;
+
+    // inner nodes have count 0 and their children at first and first + 1, leaves hold indices[first, first + count)
+    struct node {
+        aabb box;
+        id first;
+        id count;
+    };
+
+    struct split {
+        size_t axis;
+        uint32_t bin;
+    };
+
+    [[nodiscard]] static uint32_t bin_of(float center, const aabb& center_box, size_t axis) {
+        float extent = center_box.max[axis] - center_box.min[axis];
+        auto bin = uint32_t(float(bin_count) * (center - center_box.min[axis]) / extent);
+        return std::min(bin, bin_count - 1);
+    }
+
+    // cheapest split plane between bins by half perimeter times object count, none if a leaf is cheaper
+    [[nodiscard]] std::optional<split> find_split(id first, id count, const aabb& box, const aabb& center_box,
+                                                  const std::vector<cvector<float, 2>>& centers) const {
+        std::optional<split> best;
+        float best_cost = float(count) * box.half_perimeter();
+        for (size_t axis = 0; axis < 2; axis++) {
+            if (center_box.max[axis] <= center_box.min[axis]) {
+                continue;
+            }
+            aabb bin_boxes[bin_count];
+            uint32_t bin_counts[bin_count]{};
+            for (id i = first; i < first + count; i++) {
+                auto bin = bin_of(centers[indices[i]][axis], center_box, axis);
+                bin_boxes[bin].expand(boxes[indices[i]]);
+                bin_counts[bin]++;
+            }
+            // sweep from the right to get the cost of everything right of each plane
+            float right_costs[bin_count];
+            aabb right_box;
+            uint32_t right_count = 0;
+            for (uint32_t bin = bin_count - 1; bin > 0; bin--) {
+                right_box.expand(bin_boxes[bin]);
+                right_count += bin_counts[bin];
+                right_costs[bin] = float(right_count) * right_box.half_perimeter();
+            }
+            aabb left_box;
+            uint32_t left_count = 0;
+            for (uint32_t bin = 1; bin < bin_count; bin++) {
+                left_box.expand(bin_boxes[bin - 1]);
+                left_count += bin_counts[bin - 1];
+                if (left_count == 0 || left_count == count) {
+                    continue;
+                }
+                float cost = float(left_count) * left_box.half_perimeter() + right_costs[bin];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best = split{axis, bin};
+                }
+            }
+        }
+        return best;
+    }
+
+    template<typename Test, typename F>
+    void traverse(Test&& test, F& f) const {
+        if (nodes.empty()) {
+            return;
+        }
+        id stack[max_depth + 1];
+        size_t top = 0;
+        stack[top++] = 0;
+        while (top > 0) {
+            const auto& n = nodes[stack[--top]];
+            if (!test(n.box)) {
+                continue;
+            }
+            if (n.count > 0) {
+                for (id i = n.first; i < n.first + n.count; i++) {
+                    if (test(boxes[indices[i]]) && !impl::report(f, indices[i])) {
+                        return;
+                    }
+                }
+            } else {
+                stack[top++] = n.first + 1;
+                stack[top++] = n.first;
+            }
+        }
+    }
+
+    std::vector<node> nodes;
+    std::vector<id> parents;
+    std::vector<id> indices;
+    std::vector<id> leaf_of;
+    std::vector<aabb> boxes;
+};
+
+}// namespace cr::math
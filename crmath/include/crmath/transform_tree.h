@@ -0,0 +1,151 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace cr::math {
+
+namespace impl {
+
+// c = a * b for row major 4x4 floats, each result row is a sum of rows of b scaled by one element of a,
+// written with vector extensions so every row is a handful of 4 wide multiply-adds
+inline void multiply_4x4(const float* a, const float* b, float* c) {
+    using float4 = float __attribute__((vector_size(16)));
+    float4 rows[4];
+    std::memcpy(rows, b, sizeof(rows));
+    for (size_t i = 0; i < 4; i++) {
+        float4 row = a[4 * i] * rows[0] + a[4 * i + 1] * rows[1] + a[4 * i + 2] * rows[2] + a[4 * i + 3] * rows[3];
+        std::memcpy(c + 4 * i, &row, sizeof(row));
+    }
+}
+
+}// namespace impl
+
+/**
+ * @brief hierarchy of 4x4 transforms with cached world matrices
+ * @details nodes are stored flat with every parent before its children, so a single forward pass updates the world
+ * matrices. Only nodes whose local matrix changed, and their subtrees, are recomputed. The world matrices are one
+ * contiguous array that can be copied into a uniform or storage buffer as is.
+ */
+class transform_tree {
+public:
+    using node = uint32_t;
+    using transform = square_matrix<float, 4>;
+    static constexpr node no_parent = ~node(0);
+
+    void reserve(size_t count) {
+        parents.reserve(count);
+        locals.reserve(count);
+        worlds.reserve(count);
+        dirty.reserve(count);
+    }
+
+    /**
+     * @brief adds a node below parent, which has to exist already, use no_parent for a root
+     */
+    node add(node parent = no_parent, const transform& local = identity<float, 4>()) {
+        assert(parent == no_parent || parent < size());
+        auto id = node(size());
+        parents.push_back(parent);
+        locals.push_back(local);
+        worlds.push_back(local);
+        dirty.push_back(true);
+        first_dirty = std::min(first_dirty, size_t(id));
+        return id;
+    }
+
+    void set_local(node id, const transform& local) {
+        locals[id] = local;
+        dirty[id] = true;
+        first_dirty = std::min(first_dirty, size_t(id));
+    }
+
+    [[nodiscard]] const transform& local(node id) const {
+        return locals[id];
+    }
+
+    /**
+     * @brief world matrix as of the last update()
+     */
+    [[nodiscard]] const transform& world(node id) const {
+        return worlds[id];
+    }
+
+    [[nodiscard]] node parent(node id) const {
+        return parents[id];
+    }
+
+    [[nodiscard]] size_t size() const {
+        return parents.size();
+    }
+
+    /**
+     * @brief recomputes the world matrices of all changed nodes and their descendants
+     * @return number of recomputed world matrices
+     */
+    size_t update() {
+        size_t count = 0;
+        changed_begin = size();
+        changed_end = 0;
+        for (size_t i = first_dirty; i < size(); i++) {
+            node p = parents[i];
+            // parents come first, so their flag is final when the child is visited
+            if (!dirty[i] && (p == no_parent || !dirty[p])) {
+                continue;
+            }
+            dirty[i] = true;
+            if (p == no_parent) {
+                worlds[i] = locals[i];
+            } else {
+                impl::multiply_4x4(worlds[p].raw(), locals[i].raw(), worlds[i].raw());
+            }
+            changed_begin = std::min(changed_begin, i);
+            changed_end = i + 1;
+            count++;
+        }
+        for (size_t i = changed_begin; i < changed_end; i++) {
+            dirty[i] = false;
+        }
+        first_dirty = size();
+        return count;
+    }
+
+    [[nodiscard]] std::span<const transform> world_matrices() const {
+        return worlds;
+    }
+
+    /**
+     * @brief the range of world matrices the last update() changed, to upload only that part
+     */
+    [[nodiscard]] std::span<const transform> changed_world_matrices() const {
+        if (changed_begin >= changed_end) {
+            return {};
+        }
+        return std::span<const transform>(worlds).subspan(changed_begin, changed_end - changed_begin);
+    }
+
+    [[nodiscard]] size_t changed_offset() const {
+        return changed_begin < changed_end ? changed_begin : 0;
+    }
+
+private:
+    std::vector<node> parents;
+    std::vector<transform> locals;
+    std::vector<transform> worlds;
+    // bytes instead of std::vector<bool>, the update loop tests one flag per node
+    std::vector<uint8_t> dirty;
+    size_t first_dirty = 0;
+    size_t changed_begin = 0;
+    size_t changed_end = 0;
+};
+
+}// namespace cr::math
@@ -0,0 +1,539 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace cr::math {
+
+namespace impl {
+
+/*
+ * Ear clipping on a circular doubly linked list of vertices, along the lines of mapbox' earcut.
+ * Holes are first joined to the outer ring by bridge edges, which turns the polygon into a single ring.
+ * When no ear is left (self intersections, degenerate input) the ring is cleaned up, local self intersections are
+ * cut off, and as a last resort the ring is split along a valid diagonal and both halves are clipped on their own.
+ * Larger polygons keep their vertices in a second list sorted along a z-order curve, so the test whether an ear
+ * contains another vertex only looks at the vertices near the ear instead of the whole ring.
+ */
+class ear_clipper {
+public:
+    ear_clipper(std::span<const cvector<float, 2>> vertices, std::span<const uint32_t> hole_starts,
+                std::vector<uint32_t>& triangles)
+        : triangles(triangles) {
+        nodes.reserve(vertices.size() + 2 * hole_starts.size() + 16);
+        auto outer_end = hole_starts.empty() ? uint32_t(vertices.size()) : hole_starts[0];
+        auto outer = linked_list(vertices, 0, outer_end, true);
+        if (outer == none || next(outer) == prev(outer)) {
+            return;
+        }
+        if (!hole_starts.empty()) {
+            outer = eliminate_holes(vertices, hole_starts, outer);
+        }
+        if (vertices.size() > hashing_threshold) {
+            double max_x = grid_min_x = vertices[0][0];
+            double max_y = grid_min_y = vertices[0][1];
+            for (uint32_t i = 1; i < outer_end; i++) {
+                grid_min_x = std::min(grid_min_x, double(vertices[i][0]));
+                grid_min_y = std::min(grid_min_y, double(vertices[i][1]));
+                max_x = std::max(max_x, double(vertices[i][0]));
+                max_y = std::max(max_y, double(vertices[i][1]));
+            }
+            double size = std::max(max_x - grid_min_x, max_y - grid_min_y);
+            inv_size = size != 0 ? 32767 / size : 0;
+        }
+        triangles.reserve(triangles.size() + 3 * (vertices.size() + 2 * hole_starts.size()));
+        clip(outer, 0);
+    }
+
+private:
+    static constexpr uint32_t none = ~uint32_t(0);
+    static constexpr size_t hashing_threshold = 80;
+
+    struct node {
+        uint32_t i;
+        double x, y;
+        uint32_t prev = none;
+        uint32_t next = none;
+        // neighbours in z-order, none at the ends of the list
+        uint32_t prev_z = none;
+        uint32_t next_z = none;
+        uint32_t z = 0;
+        // single vertex holes have to stay even though they are degenerate
+        bool steiner = false;
+    };
+
+    std::vector<node> nodes;
+    std::vector<uint32_t>& triangles;
+    // maps coordinates to the 15 bit grid of the z-order curve, 0 disables the z-order list
+    double grid_min_x = 0, grid_min_y = 0, inv_size = 0;
+
+    uint32_t& prev(uint32_t p) {
+        return nodes[p].prev;
+    }
+
+    uint32_t& next(uint32_t p) {
+        return nodes[p].next;
+    }
+
+    // twice the signed area of the triangle, negative for a convex corner of the outer ring
+    double area(uint32_t p, uint32_t q, uint32_t r) const {
+        const auto &a = nodes[p], &b = nodes[q], &c = nodes[r];
+        return (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+    }
+
+    bool equals(uint32_t a, uint32_t b) const {
+        return nodes[a].x == nodes[b].x && nodes[a].y == nodes[b].y;
+    }
+
+    uint32_t insert_node(uint32_t i, const cvector<float, 2>& v, uint32_t last) {
+        auto p = uint32_t(nodes.size());
+        nodes.push_back({i, double(v[0]), double(v[1])});
+        if (last == none) {
+            prev(p) = p;
+            next(p) = p;
+        } else {
+            next(p) = next(last);
+            prev(p) = last;
+            prev(next(last)) = p;
+            next(last) = p;
+        }
+        return p;
+    }
+
+    void remove_node(uint32_t p) {
+        prev(next(p)) = prev(p);
+        next(prev(p)) = next(p);
+        if (nodes[p].prev_z != none) {
+            nodes[nodes[p].prev_z].next_z = nodes[p].next_z;
+        }
+        if (nodes[p].next_z != none) {
+            nodes[nodes[p].next_z].prev_z = nodes[p].prev_z;
+        }
+    }
+
+    // interleaves the bits of the grid coordinates, nearby points get nearby codes
+    uint32_t z_order(double x, double y) const {
+        auto spread = [](uint32_t v) {
+            v = (v | (v << 8)) & 0x00FF00FF;
+            v = (v | (v << 4)) & 0x0F0F0F0F;
+            v = (v | (v << 2)) & 0x33333333;
+            v = (v | (v << 1)) & 0x55555555;
+            return v;
+        };
+        auto grid = [&](double v, double min) { return uint32_t(std::clamp((v - min) * inv_size, 0.0, 32767.0)); };
+        return spread(grid(x, grid_min_x)) | (spread(grid(y, grid_min_y)) << 1);
+    }
+
+    // builds the z-order list of the ring starting at start
+    void index_curve(uint32_t start) {
+        std::vector<uint32_t> ring;
+        uint32_t p = start;
+        do {
+            nodes[p].z = z_order(nodes[p].x, nodes[p].y);
+            ring.push_back(p);
+            p = next(p);
+        } while (p != start);
+        std::sort(ring.begin(), ring.end(), [&](uint32_t a, uint32_t b) { return nodes[a].z < nodes[b].z; });
+        for (size_t k = 0; k < ring.size(); k++) {
+            nodes[ring[k]].prev_z = k == 0 ? none : ring[k - 1];
+            nodes[ring[k]].next_z = k + 1 == ring.size() ? none : ring[k + 1];
+        }
+    }
+
+    // ring of vertices [start, end) in the requested winding
+    uint32_t linked_list(std::span<const cvector<float, 2>> vertices, uint32_t start, uint32_t end, bool clockwise) {
+        if (start >= end) {
+            return none;
+        }
+        double sum = 0;
+        for (uint32_t i = start, j = end - 1; i < end; j = i++) {
+            sum += (double(vertices[j][0]) - vertices[i][0]) * (double(vertices[i][1]) + vertices[j][1]);
+        }
+        uint32_t last = none;
+        if (clockwise == (sum > 0)) {
+            for (uint32_t i = start; i < end; i++) {
+                last = insert_node(i, vertices[i], last);
+            }
+        } else {
+            for (uint32_t i = end; i-- > start;) {
+                last = insert_node(i, vertices[i], last);
+            }
+        }
+        if (last != none && equals(last, next(last))) {
+            remove_node(last);
+            last = next(last);
+        }
+        return last;
+    }
+
+    // removes duplicate and collinear vertices between start and end
+    uint32_t filter_points(uint32_t start, uint32_t end = none) {
+        if (start == none) {
+            return start;
+        }
+        if (end == none) {
+            end = start;
+        }
+        uint32_t p = start;
+        bool again;
+        do {
+            again = false;
+            if (!nodes[p].steiner && (equals(p, next(p)) || area(prev(p), p, next(p)) == 0)) {
+                remove_node(p);
+                p = end = prev(p);
+                if (p == next(p)) {
+                    break;
+                }
+                again = true;
+            } else {
+                p = next(p);
+            }
+        } while (again || p != end);
+        return end;
+    }
+
+    void clip(uint32_t ear, int pass) {
+        if (ear == none) {
+            return;
+        }
+        if (pass == 0 && inv_size != 0) {
+            index_curve(ear);
+        }
+        uint32_t stop = ear;
+        while (prev(ear) != next(ear)) {
+            uint32_t a = prev(ear);
+            uint32_t c = next(ear);
+            if (inv_size != 0 ? is_ear_hashed(ear) : is_ear(ear)) {
+                triangles.push_back(nodes[a].i);
+                triangles.push_back(nodes[ear].i);
+                triangles.push_back(nodes[c].i);
+                remove_node(ear);
+                // skipping the next vertex gives fewer sliver triangles
+                ear = next(c);
+                stop = next(c);
+                continue;
+            }
+            ear = c;
+            if (ear == stop) {
+                if (pass == 0) {
+                    clip(filter_points(ear), 1);
+                } else if (pass == 1) {
+                    clip(cure_local_intersections(filter_points(ear)), 2);
+                } else {
+                    split_and_clip(ear);
+                }
+                break;
+            }
+        }
+    }
+
+    bool point_in_triangle(double ax, double ay, double bx, double by, double cx, double cy, double px,
+                           double py) const {
+        return (cx - px) * (ay - py) >= (ax - px) * (cy - py) && (ax - px) * (by - py) >= (bx - px) * (ay - py) &&
+               (bx - px) * (cy - py) >= (cx - px) * (by - py);
+    }
+
+    bool is_ear(uint32_t ear) {
+        uint32_t a = prev(ear);
+        uint32_t c = next(ear);
+        if (area(a, ear, c) >= 0) {
+            return false;
+        }
+        const auto &na = nodes[a], &nb = nodes[ear], &nc = nodes[c];
+        double min_x = std::min({na.x, nb.x, nc.x});
+        double min_y = std::min({na.y, nb.y, nc.y});
+        double max_x = std::max({na.x, nb.x, nc.x});
+        double max_y = std::max({na.y, nb.y, nc.y});
+        // no other reflex vertex may lie in the ear
+        for (uint32_t p = next(c); p != a; p = next(p)) {
+            const auto& np = nodes[p];
+            if (np.x >= min_x && np.x <= max_x && np.y >= min_y && np.y <= max_y &&
+                !(np.x == na.x && np.y == na.y) &&
+                point_in_triangle(na.x, na.y, nb.x, nb.y, nc.x, nc.y, np.x, np.y) && area(prev(p), p, next(p)) >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // is_ear, but only the vertices whose z-order code lies within the codes of the ear's bounding box are tested
+    bool is_ear_hashed(uint32_t ear) {
+        uint32_t a = prev(ear);
+        uint32_t c = next(ear);
+        if (area(a, ear, c) >= 0) {
+            return false;
+        }
+        const auto &na = nodes[a], &nb = nodes[ear], &nc = nodes[c];
+        double min_x = std::min({na.x, nb.x, nc.x});
+        double min_y = std::min({na.y, nb.y, nc.y});
+        double max_x = std::max({na.x, nb.x, nc.x});
+        double max_y = std::max({na.y, nb.y, nc.y});
+        uint32_t min_z = z_order(min_x, min_y);
+        uint32_t max_z = z_order(max_x, max_y);
+        auto blocks = [&](uint32_t p) {
+            const auto& np = nodes[p];
+            return p != a && p != c && np.x >= min_x && np.x <= max_x && np.y >= min_y && np.y <= max_y &&
+                   !(np.x == na.x && np.y == na.y) &&
+                   point_in_triangle(na.x, na.y, nb.x, nb.y, nc.x, nc.y, np.x, np.y) &&
+                   area(prev(p), p, next(p)) >= 0;
+        };
+        for (uint32_t p = nodes[ear].prev_z; p != none && nodes[p].z >= min_z; p = nodes[p].prev_z) {
+            if (blocks(p)) {
+                return false;
+            }
+        }
+        for (uint32_t n = nodes[ear].next_z; n != none && nodes[n].z <= max_z; n = nodes[n].next_z) {
+            if (blocks(n)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static int sign(double v) {
+        return v > 0 ? 1 : (v < 0 ? -1 : 0);
+    }
+
+    // q lies on segment pr, for collinear p, q, r
+    bool on_segment(uint32_t p, uint32_t q, uint32_t r) const {
+        const auto &np = nodes[p], &nq = nodes[q], &nr = nodes[r];
+        return nq.x <= std::max(np.x, nr.x) && nq.x >= std::min(np.x, nr.x) && nq.y <= std::max(np.y, nr.y) &&
+               nq.y >= std::min(np.y, nr.y);
+    }
+
+    bool intersects(uint32_t p1, uint32_t q1, uint32_t p2, uint32_t q2) const {
+        int o1 = sign(area(p1, q1, p2));
+        int o2 = sign(area(p1, q1, q2));
+        int o3 = sign(area(p2, q2, p1));
+        int o4 = sign(area(p2, q2, q1));
+        if (o1 != o2 && o3 != o4) {
+            return true;
+        }
+        return (o1 == 0 && on_segment(p1, p2, q1)) || (o2 == 0 && on_segment(p1, q2, q1)) ||
+               (o3 == 0 && on_segment(p2, p1, q2)) || (o4 == 0 && on_segment(p2, q1, q2));
+    }
+
+    // the diagonal ab crosses an edge of the ring
+    bool intersects_polygon(uint32_t a, uint32_t b) {
+        uint32_t p = a;
+        do {
+            uint32_t n = next(p);
+            if (nodes[p].i != nodes[a].i && nodes[n].i != nodes[a].i && nodes[p].i != nodes[b].i &&
+                nodes[n].i != nodes[b].i && intersects(p, n, a, b)) {
+                return true;
+            }
+            p = n;
+        } while (p != a);
+        return false;
+    }
+
+    // the diagonal ab starts into the inside of the polygon at a
+    bool locally_inside(uint32_t a, uint32_t b) {
+        return area(prev(a), a, next(a)) < 0 ? area(a, b, next(a)) >= 0 && area(a, prev(a), b) >= 0
+                                             : area(a, b, prev(a)) < 0 || area(a, next(a), b) < 0;
+    }
+
+    // the middle of the diagonal ab is inside the polygon
+    bool middle_inside(uint32_t a, uint32_t b) {
+        uint32_t p = a;
+        bool inside = false;
+        double px = (nodes[a].x + nodes[b].x) / 2;
+        double py = (nodes[a].y + nodes[b].y) / 2;
+        do {
+            const auto &np = nodes[p], &nn = nodes[next(p)];
+            if (((np.y > py) != (nn.y > py)) && nn.y != np.y && (px < (nn.x - np.x) * (py - np.y) / (nn.y - np.y) + np.x)) {
+                inside = !inside;
+            }
+            p = next(p);
+        } while (p != a);
+        return inside;
+    }
+
+    bool is_valid_diagonal(uint32_t a, uint32_t b) {
+        return nodes[next(a)].i != nodes[b].i && nodes[prev(a)].i != nodes[b].i && !intersects_polygon(a, b) &&
+               ((locally_inside(a, b) && locally_inside(b, a) && middle_inside(a, b) &&
+                 (area(prev(a), a, prev(b)) != 0 || area(a, prev(b), b) != 0)) ||
+                (equals(a, b) && area(prev(a), a, next(a)) > 0 && area(prev(b), b, next(b)) > 0));
+    }
+
+    // links a to b with a bridge, duplicating both, returns the copy of b in the second ring
+    uint32_t split_polygon(uint32_t a, uint32_t b) {
+        auto a2 = uint32_t(nodes.size());
+        nodes.push_back({nodes[a].i, nodes[a].x, nodes[a].y});
+        auto b2 = uint32_t(nodes.size());
+        nodes.push_back({nodes[b].i, nodes[b].x, nodes[b].y});
+        uint32_t an = next(a);
+        uint32_t bp = prev(b);
+        next(a) = b;
+        prev(b) = a;
+        next(a2) = an;
+        prev(an) = a2;
+        next(b2) = a2;
+        prev(a2) = b2;
+        next(bp) = b2;
+        prev(b2) = bp;
+        return b2;
+    }
+
+    // cuts off small self intersecting loops a p p.next b
+    uint32_t cure_local_intersections(uint32_t start) {
+        uint32_t p = start;
+        do {
+            uint32_t a = prev(p);
+            uint32_t b = next(next(p));
+            if (!equals(a, b) && intersects(a, p, next(p), b) && locally_inside(a, b) && locally_inside(b, a)) {
+                triangles.push_back(nodes[a].i);
+                triangles.push_back(nodes[p].i);
+                triangles.push_back(nodes[b].i);
+                remove_node(p);
+                remove_node(next(p));
+                p = start = b;
+            }
+            p = next(p);
+        } while (p != start);
+        return filter_points(p);
+    }
+
+    void split_and_clip(uint32_t start) {
+        uint32_t a = start;
+        do {
+            for (uint32_t b = next(next(a)); b != prev(a); b = next(b)) {
+                if (nodes[a].i != nodes[b].i && is_valid_diagonal(a, b)) {
+                    uint32_t c = split_polygon(a, b);
+                    a = filter_points(a, next(a));
+                    c = filter_points(c, next(c));
+                    clip(a, 0);
+                    clip(c, 0);
+                    return;
+                }
+            }
+            a = next(a);
+        } while (a != start);
+    }
+
+    uint32_t leftmost(uint32_t start) const {
+        uint32_t p = start;
+        uint32_t res = start;
+        do {
+            if (nodes[p].x < nodes[res].x || (nodes[p].x == nodes[res].x && nodes[p].y < nodes[res].y)) {
+                res = p;
+            }
+            p = nodes[p].next;
+        } while (p != start);
+        return res;
+    }
+
+    uint32_t eliminate_holes(std::span<const cvector<float, 2>> vertices, std::span<const uint32_t> hole_starts,
+                             uint32_t outer) {
+        std::vector<uint32_t> queue;
+        for (size_t h = 0; h < hole_starts.size(); h++) {
+            uint32_t start = hole_starts[h];
+            uint32_t end = h + 1 < hole_starts.size() ? hole_starts[h + 1] : uint32_t(vertices.size());
+            auto list = linked_list(vertices, start, end, false);
+            if (list == none) {
+                continue;
+            }
+            if (list == next(list)) {
+                nodes[list].steiner = true;
+            }
+            queue.push_back(leftmost(list));
+        }
+        // holes are bridged from left to right, so every bridge only sees holes that are already part of the ring
+        std::sort(queue.begin(), queue.end(), [&](uint32_t a, uint32_t b) { return nodes[a].x < nodes[b].x; });
+        for (auto hole : queue) {
+            outer = eliminate_hole(hole, outer);
+        }
+        return outer;
+    }
+
+    uint32_t eliminate_hole(uint32_t hole, uint32_t outer) {
+        auto bridge = find_hole_bridge(hole, outer);
+        if (bridge == none) {
+            return outer;
+        }
+        auto bridge_reverse = split_polygon(bridge, hole);
+        filter_points(bridge_reverse, next(bridge_reverse));
+        return filter_points(bridge, next(bridge));
+    }
+
+    bool sector_contains_sector(uint32_t m, uint32_t p) {
+        return area(prev(m), m, prev(p)) < 0 && area(next(p), m, next(m)) < 0;
+    }
+
+    // vertex of the outer ring that the leftmost point of a hole can be connected to (David Eberly's method)
+    uint32_t find_hole_bridge(uint32_t hole, uint32_t outer) {
+        uint32_t p = outer;
+        double hx = nodes[hole].x;
+        double hy = nodes[hole].y;
+        double qx = -std::numeric_limits<double>::infinity();
+        uint32_t m = none;
+        // the closest edge left of the hole point on the ray towards -x
+        do {
+            const auto &np = nodes[p], &nn = nodes[next(p)];
+            if (hy <= np.y && hy >= nn.y && nn.y != np.y) {
+                double x = np.x + (hy - np.y) * (nn.x - np.x) / (nn.y - np.y);
+                if (x <= hx && x > qx) {
+                    qx = x;
+                    m = np.x < nn.x ? p : next(p);
+                    if (x == hx) {
+                        return m;
+                    }
+                }
+            }
+            p = next(p);
+        } while (p != outer);
+        if (m == none) {
+            return none;
+        }
+        // a reflex vertex inside the triangle hole point, intersection, m is a better choice if it is visible
+        uint32_t stop = m;
+        double mx = nodes[m].x;
+        double my = nodes[m].y;
+        double tan_min = std::numeric_limits<double>::infinity();
+        p = m;
+        do {
+            const auto& np = nodes[p];
+            if (hx >= np.x && np.x >= mx && hx != np.x &&
+                point_in_triangle(hy < my ? hx : qx, hy, mx, my, hy < my ? qx : hx, hy, np.x, np.y)) {
+                double tan = std::abs(hy - np.y) / (hx - np.x);
+                if (locally_inside(p, hole) &&
+                    (tan < tan_min ||
+                     (tan == tan_min && (np.x > nodes[m].x || (np.x == nodes[m].x && sector_contains_sector(m, p)))))) {
+                    m = p;
+                    tan_min = tan;
+                }
+            }
+            p = next(p);
+        } while (p != stop);
+        return m;
+    }
+};
+
+}// namespace impl
+
+/**
+ * @brief triangulates a polygon with holes by ear clipping
+ * @param vertices the outer ring followed by all hole rings, each ring in either orientation and without repeating its
+ * first vertex
+ * @param hole_starts index of the first vertex of every hole, ascending
+ * @return three indices into vertices per triangle, ready for an index buffer
+ * @details self intersecting or degenerate input still produces triangles covering the polygon as well as possible.
+ * Polygons with more than 80 vertices use a z-order index for the ear tests, smaller ones are cheaper without it.
+ */
+inline std::vector<uint32_t> triangulate(std::span<const cvector<float, 2>> vertices,
+                                         std::span<const uint32_t> hole_starts = {}) {
+    std::vector<uint32_t> triangles;
+    impl::ear_clipper(vertices, hole_starts, triangles);
+    return triangles;
+}
+
+}// namespace cr::math
@@ -2,8 +2,80 @@
 // Created by nudelerde on 20.05.23.
 //
 
+#include "crmath/batch.h"
 #include "crmath/matrix.h"
+#include "crmath/matrix_io.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <vector>
+
+// batch results lane by lane against the scalar ones. Entries are small integers, so products and determinants are
+// exact and only inverses need a tolerance. Matrix 2 is singular, 11 matrices leave the last chunk of 4 partial.
+template<size_t N>
+static bool check_batch() {
+    using namespace cr::math;
+    constexpr size_t L = 4;
+    using mat = matrix<double, N, N>;
+    std::mt19937 rng(N);
+    std::uniform_int_distribution<int> dist(-5, 5);
+    std::vector<mat> a(11);
+    std::vector<mat> b(11);
+    for (size_t k = 0; k < a.size(); k++) {
+        for (size_t i = 0; i < N; i++) {
+            for (size_t j = 0; j < N; j++) {
+                a[k].access(i, j) = dist(rng);
+                b[k].access(i, j) = dist(rng);
+            }
+        }
+    }
+    for (size_t j = 0; j < N; j++) {
+        a[2].access(N - 1, j) = a[2].access(0, j);
+    }
+
+    bool ok = true;
+    double error = 0;
+    auto compare_inverse = [&](const std::optional<mat>& res, const mat& m) {
+        auto expected = inverse(m);
+        ok = ok && res.has_value() == expected.has_value();
+        if (res && expected) {
+            for (size_t i = 0; i < N; i++) {
+                for (size_t j = 0; j < N; j++) {
+                    error = std::max(error, std::abs(res->access(i, j) - expected->access(i, j)));
+                }
+            }
+        }
+    };
+
+    auto batch_a = load_batch<L>(a);
+    auto batch_b = load_batch<L>(b);
+    auto det = determinant(batch_a);
+    auto inv = inverse(batch_a);
+    auto product = batch_a * batch_b;
+    for (size_t l = 0; l < L; l++) {
+        ok = ok && det[l] == determinant(a[l]) && get_lane(product, l) == a[l] * b[l];
+        compare_inverse(inv.valid[l] ? std::optional<mat>(get_lane(inv.value, l)) : std::nullopt, a[l]);
+    }
+    ok = ok && !inv.valid[2];
+
+    std::vector<mat> products(a.size());
+    std::vector<double> dets(a.size());
+    std::vector<std::optional<mat>> inverses(a.size());
+    multiply_all<L>(a, b, products);
+    determinant_all<L>(a, dets);
+    inverse_all<L>(a, inverses);
+    for (size_t k = 0; k < a.size(); k++) {
+        ok = ok && products[k] == a[k] * b[k] && dets[k] == determinant(a[k]);
+        compare_inverse(inverses[k], a[k]);
+    }
+    ok = ok && !inverses[2].has_value();
+    std::cout << "batch " << N << "x" << N << ":     " << (ok ? "matches scalar" : "differs") << ", inverse error " << error
+              << std::endl;
+    return ok && error < 1e-9;
+}
 
 int main() {
     using namespace cr::math;
@@ -56,7 +128,86 @@ int main() {
     std::cout << "M7:            " << m7 << std::endl;
     std::cout << "adj(M7):       " << adjugate(m7) << std::endl;
 
-    cvector<double, 2> v3 = m7.column_vector(2);
+    constexpr matrix<long, 3, 3> m8{2, -3, 1, 2, 0, -1, 1, 4, 5};
+    static_assert(determinant(m8) == 49);
+    std::cout << "det(M8):       " << determinant(m8) << std::endl;
+
+    matrix<long, 20, 20> m9{};
+    for (size_t i = 0; i < 20; i++) {
+        m9[i][i] = 2;
+        if (i > 0) m9[i][i - 1] = -1;
+        if (i + 1 < 20) m9[i][i + 1] = -1;
+    }
+    std::cout << "det(M9):       " << determinant(m9) << std::endl;
+
+    matrix<int, 3, 3> m10{100000, 0, 0, 0, 100000, 0, 0, 0, 100000};
+    std::cout << "checked:       " << checked_determinant(m10).has_value() << std::endl;
+    std::cout << "checked(M8):   " << checked_determinant(m8).value_or(0) << std::endl;
+
+    constexpr matrix<int, 3, 3> m11{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    static_assert(m11.submatrix<2, 2>(1, 1).access(1, 1) == 9);
+    static_assert(m11.column_vector(2)[2] == 9);
+    static_assert(m11.block<2, 2, 1, 0>().access(1, 0) == 7);
+    static_assert(m11.transposed().submatrix<2, 1>(1, 2).access(1, 0) == 9);
+    auto m11t = m11.minor(0, 0).transposed();
+    auto m11s = m11t.submatrix<1, 2>(1, 0);
+    std::cout << "minor(M11)^T:  " << m11t << std::endl;
+    std::cout << "row of it:     " << m11s << std::endl;
+
+    cvector<double, 2> v3 = m7.column_vector(1);
 
     std::cout << "V3:            " << v3 << std::endl;
+
+    if (!check_batch<2>() || !check_batch<3>() || !check_batch<4>() || !check_batch<5>()) {
+        return 1;
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "crmath_matrix_test.crm";
+    {
+        matrix_writer<double, 2, 2> writer(path);
+        writer.write(m6);
+        writer.write(m7);
+    }
+    mapped_matrix_file<double, 2, 2> mapped(path);
+    std::cout << "mapped:        " << mapped.size() << " " << mapped[0] << " " << mapped[1] << std::endl;
+    matrix_reader<double, 2, 2> reader(path);
+    matrix<double, 2, 2> chunk[1];
+    while (reader.read(chunk) > 0) {
+        std::cout << "chunk:         " << chunk[0] << std::endl;
+    }
+
+    // a count whose byte size wraps around must not pass the size check
+    auto header = read_matrix_file_header(path);
+    header.count = ~uint64_t(0) / sizeof(matrix<double, 2, 2>) + 2;
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    try {
+        mapped_matrix_file<double, 2, 2> corrupt(path);
+        std::cout << "corrupt:       accepted" << std::endl;
+        return 1;
+    } catch (const std::runtime_error&) {
+        std::cout << "corrupt:       rejected" << std::endl;
+    }
+    std::filesystem::remove(path);
+
+    // assigning a writer finishes the file it wrote before
+    auto other_path = std::filesystem::temp_directory_path() / "crmath_matrix_test_other.crm";
+    {
+        matrix_writer<double, 2, 2> writer(path);
+        writer.write(m6);
+        matrix_writer<double, 2, 2> other(other_path);
+        other.write(m7);
+        writer = std::move(other);
+        writer.write(m6);
+    }
+    mapped_matrix_file<double, 2, 2> first(path);
+    mapped_matrix_file<double, 2, 2> second(other_path);
+    std::cout << "reassigned:    " << first.size() << " " << second.size() << std::endl;
+    if (first.size() != 1 || second.size() != 2) {
+        return 1;
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(other_path);
 }
\ No newline at end of file
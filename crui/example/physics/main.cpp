@@ -2,13 +2,20 @@
 // Created by nudelerde on 19.05.23.
 //
 
+#include "crmath/curve.h"
+#include "crmath/expm.h"
 #include "crui/font.h"
 #include "crui/geometry.h"
 #include "crui/gui.h"
 #include "crui/window.h"
+#include "crutil/arena.h"
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <memory_resource>
+#include <utility>
 #include <vector>
 
 using namespace cr;
@@ -76,7 +83,12 @@ ui::Color hsv2rgb(hsv in) {
     return out;
 }
 
-void draw_physics(std::unique_ptr<ui::Window>& window, math::cvector<float, 2>& state) {
+// the geometry lists of a frame live in one arena that is reset per frame, instead of a heap allocation per list
+std::pmr::vector<ui::geometry> frame_list(util::frame_arena& frame, std::initializer_list<ui::geometry> geometries) {
+    return std::pmr::vector<ui::geometry>(geometries, &frame);
+}
+
+void draw_physics(std::unique_ptr<ui::Window>& window, util::frame_arena& frame, math::cvector<float, 2>& state) {
     float wheel_radius = 50;
     ui::Point wheel_pos{149, 100};
     ui::Color string_color{1, 1, 0, 1};
@@ -93,7 +105,18 @@ void draw_physics(std::unique_ptr<ui::Window>& window, math::cvector<float, 2>&
     ui::Point spring_start{10, spring_end.y()};
     ui::Point object_pos{wheel_pos + math::cvector<float, 2>{1 + wheel_radius, 100 + obj_pos}};
 
-    ui::draw({
+    // the spring is a smooth curve through alternating points, flattened to a quarter pixel
+    std::array<math::curve_point, 6> spring_control{
+            spring_start,
+            spring_start * 0.8 + spring_end * 0.2 + ui::Point{0, spring_vis_strength},
+            spring_start * 0.6 + spring_end * 0.4 + ui::Point{0, -spring_vis_strength},
+            spring_start * 0.4 + spring_end * 0.6 + ui::Point{0, spring_vis_strength},
+            spring_start * 0.2 + spring_end * 0.8 + ui::Point{0, -spring_vis_strength},
+            spring_end};
+    std::vector<math::curve_point> spring_points;
+    math::flatten_catmull_rom(spring_control, 0.25f, spring_points);
+
+    ui::draw(frame_list(frame, {
                      //string
                      ui::Line{wheel_pos + ui::Point{0, -wheel_radius}, spring_end,
                               string_color, 3},
@@ -102,22 +125,7 @@ void draw_physics(std::unique_ptr<ui::Window>& window, math::cvector<float, 2>&
                                 0},
                      //spring
                      ui::Rectangle{{-10, wheel_pos.y() - wheel_radius - 10}, 20, 20, {0, 0, 0, 1}},
-                     ui::Line{spring_start,
-                              spring_start * 0.8 + spring_end * 0.2 + ui::Point{0, spring_vis_strength},
-                              spring_color,
-                              3},
-                     ui::Line{spring_start * 0.8 + spring_end * 0.2 + ui::Point{0, spring_vis_strength},
-                              spring_start * 0.6 + spring_end * 0.4 + ui::Point{0, -spring_vis_strength},
-                              spring_color, 3},
-                     ui::Line{spring_start * 0.6 + spring_end * 0.4 + ui::Point{0, -spring_vis_strength},
-                              spring_start * 0.4 + spring_end * 0.6 + ui::Point{0, spring_vis_strength},
-                              spring_color, 3},
-                     ui::Line{spring_start * 0.4 + spring_end * 0.6 + ui::Point{0, spring_vis_strength},
-                              spring_start * 0.2 + spring_end * 0.8 + ui::Point{0, -spring_vis_strength},
-                              spring_color, 3},
-                     ui::Line{spring_start * 0.2 + spring_end * 0.8 + ui::Point{0, -spring_vis_strength},
-                              spring_end,
-                              spring_color, 3},
+                     ui::Polyline{spring_points, spring_color, 3},
                      //wheel
                      ui::Line{wheel_pos,
                               math::rotation_matrix(angle) * math::cvector<float, 2>(0, wheel_radius) + wheel_pos,
@@ -134,12 +142,12 @@ void draw_physics(std::unique_ptr<ui::Window>& window, math::cvector<float, 2>&
                      ui::Circle{wheel_pos, wheel_radius, wheel_color, wheel_radius - 4},
                      //object
                      ui::Circle{object_pos, 10, object_color},
-             },
+             }),
              window);
 }
 
 void do_slider(double& value, double min, double max, const std::string& text, const ui::Point& p,
-               std::shared_ptr<ui::font>& font, std::unique_ptr<ui::Window>& window, const std::vector<ui::event>& events) {
+               std::shared_ptr<ui::font>& font, std::unique_ptr<ui::Window>& window, const ui::event_list& events) {
     ui::Slider slider(p, {150, 20}, float(value - min) / float(max - min),
                       {0.6, 0.6, 0.6, 1}, {0, 0, 0.8, 1}, 2);
     apply_all(events, slider);
@@ -177,28 +185,42 @@ int main(int argc, char** argv) {
 
     auto font = ui::loadFont(font_path, 40);
 
-    auto step_func = [&](const math::cvector<float, 2>& state) {
+    // the system is linear: state' = A * state + b
+    auto linear_system = [&]() {
         double c1 = (m * r) / ((I / r) + m * r);
         double c2 = (r * kf) / ((I / r) + m * r);
         double c3 = (1) / (I + m * r * r);
         math::square_matrix<float, 2> A{0, 1, -c2, -c3 * kd};
         math::cvector<float, 2> b{0, c1 * g};
+        return std::pair{A, b};
+    };
+
+    auto step_func = [&](const math::cvector<float, 2>& state) {
+        auto [A, b] = linear_system();
         return A * state + b;
     };
 
+    // fixed step, so the exact discretization only has to be recomputed when a slider changes the system
+    constexpr float physics_step = 1.0f / 240.0f;
+    float physics_time = 0;
+    math::cached_discretization<float, 2> discretization;
+
     math::cvector<float, 2> state{0, 0};
     auto time = std::chrono::high_resolution_clock::now();
 
+    util::frame_arena frame;
+
     while (window->exists()) {
+        auto frame_stats = frame.reset();
         auto dt = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - time).count();
         time = std::chrono::high_resolution_clock::now();
 
         ui::clear(ui::Color{0.2, 0.2, 0.2, 1}, window);
-        ui::draw({
+        ui::draw(frame_list(frame, {
                          ui::Rectangle{{0, 0}, 225, float(window->size()[1]) - 150.0f, {0.4, 0.4, 0.4, 1}},
-                 },
+                 }),
                  window);
-        draw_physics(window, state);
+        draw_physics(window, frame, state);
         auto events = window->get_events();
 
         do_slider(g, 0, 18, "g:", {250, 25}, font, window, events);
@@ -211,7 +233,7 @@ int main(int argc, char** argv) {
         double c1 = (m * r) / ((I / r) + m * r);
         double c2 = (r * kf) / ((I / r) + m * r);
         double c3 = (1) / (I + m * r * r);
-        ui::draw({
+        ui::draw(frame_list(frame, {
                          ui::Text{{20, float(window->size()[1]) - 100.0f}, font, "c1: " + std::to_string(c1),//
                                   {1, 1, 1, 1},
                                   .125},
@@ -221,7 +243,12 @@ int main(int argc, char** argv) {
                          ui::Text{{20, float(window->size()[1]) - 50.0f}, font, "c3: " + std::to_string(c3),//
                                   {1, 1, 1, 1},
                                   .125},
-                 },
+                         ui::Text{{20, float(window->size()[1]) - 25.0f}, font,
+                                  "frame: " + std::to_string(frame_stats.allocations) + " allocations, " +
+                                          std::to_string(frame_stats.bytes) + " bytes",
+                                  {1, 1, 1, 1},
+                                  .125},
+                 }),
                  window);
 
         auto m_pos = window->get_mouse_position();
@@ -231,18 +258,25 @@ int main(int argc, char** argv) {
             math::cvector<float, 2> tmp = m_pos;
             state = (tmp - ui::Point{250.0f + 150.0f, 175.0f + 150.0f}) / 20.0f;
         } else {
-            state = math::rk4(state, dt, step_func);
+            auto [A, b] = linear_system();
+            const auto& system = discretization(A, b, physics_step);
+            for (physics_time += std::min(dt, 0.1f); physics_time >= physics_step; physics_time -= physics_step) {
+                state = system(state);
+            }
         }
 
-        ui::draw({
+        ui::draw(frame_list(frame, {
                          ui::Rectangle{{250, 175}, 300, 300, {0.4, 0.4, 0.4, 1}},
                          ui::Line{{250 + 150, 175}, {250 + 150, 175 + 300}, {0, 0, 0, 1}, 2},
                          ui::Line{{250, 175 + 150}, {250 + 300, 175 + 150}, {0, 0, 0, 1}, 2},
                          ui::Text{{250 + 150 + 4, 175 + 15}, font, "x'", {1, 1, 1, 1}, .125},
                          ui::Text{{250 + 300 - 10, 175 + 150 - 5}, font, "x", {1, 1, 1, 1}, .125},
                          ui::Circle{state * 20 + ui::Point{250 + 150, 175 + 150}, 5, {1, 1, 0, 1}},
-                 },
+                 }),
                  window);
+        // the whole vector field is drawn as one list
+        std::pmr::vector<ui::geometry> field(&frame);
+        field.reserve(20 * 20 * 2);
         double width = 300.0 / 20.0;
         double height = 300.0 / 20.0;
         for (int i = 0; i < 20; i++) {
@@ -258,14 +292,12 @@ int main(int argc, char** argv) {
                 auto direction = diff / len * 0.5;
                 auto color = hsv2rgb({len * 4, 0.8, 0.8});
                 color[3] = 1;
-                ui::draw({
-                                 ui::Circle{s * 20 + ui::Point{250 + 150, 175 + 150}, 2, color},
-                                 ui::Line{s * 20 + ui::Point{250 + 150, 175 + 150},
-                                          (s + direction) * 20 + ui::Point{250 + 150, 175 + 150}, color, 1},
-                         },
-                         window);
+                field.emplace_back(ui::Circle{s * 20 + ui::Point{250 + 150, 175 + 150}, 2, color});
+                field.emplace_back(ui::Line{s * 20 + ui::Point{250 + 150, 175 + 150},
+                                            (s + direction) * 20 + ui::Point{250 + 150, 175 + 150}, color, 1});
             }
         }
+        ui::draw(field, window);
 
         window->update();
     }
@@ -4,9 +4,13 @@
 
 #pragma once
 
+#include "crutil/flat_hash_map.h"
 #include "opengl.h"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <span>
 #include <string>
-#include <unordered_map>
 
 namespace cr::ui {
 struct font {
@@ -23,13 +27,52 @@ struct font {
         int bearingY;
     };
 
-    std::unordered_map<char, glyph> glyphs;
+    /**
+     * @brief glyphs by character, looked up once per drawn character
+     * @details the 128 ASCII characters sit in a plain array indexed by the character, only characters outside of it
+     * go through a hash map
+     */
+    class glyph_table {
+    public:
+        /**
+         * @brief the glyph of c, inserted zeroed if it is missing
+         */
+        glyph& operator[](char c) {
+            auto index = static_cast<unsigned char>(c);
+            if (index < ascii_size) {
+                present[index] = true;
+                return ascii[index];
+            }
+            return others[c];
+        }
+
+        /**
+         * @brief the glyph of c, nullptr if the font has none
+         */
+        [[nodiscard]] const glyph* find(char c) const {
+            auto index = static_cast<unsigned char>(c);
+            if (index < ascii_size) {
+                return present[index] ? &ascii[index] : nullptr;
+            }
+            auto it = others.find(c);
+            return it == others.end() ? nullptr : &it->second;
+        }
+
+    private:
+        static constexpr size_t ascii_size = 128;
+
+        std::array<glyph, ascii_size> ascii{};
+        std::bitset<ascii_size> present;
+        cr::util::flat_hash_map<char, glyph> others;
+    };
+
+    glyph_table glyphs;
     std::shared_ptr<texture> atlas;
     unsigned int atlasWidth;
     unsigned int atlasHeight;
 
     font() = default;
-    font(std::unordered_map<char, glyph> glyphs,
+    font(glyph_table glyphs,
          std::shared_ptr<texture> atlas,
          unsigned int atlasWidth,
          unsigned int atlasHeight) ://
@@ -40,4 +83,10 @@ struct font {
 };
 
 std::shared_ptr<font> loadFont(const std::string& path, unsigned int size);
+
+/**
+ * @brief loads a font from a file already in memory, e.g. a cr::util::mapped_file
+ * @details data only has to stay alive for the duration of the call
+ */
+std::shared_ptr<font> loadFont(std::span<const std::byte> data, unsigned int size);
 }// namespace cr::ui
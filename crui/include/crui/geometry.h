@@ -5,6 +5,8 @@
 #pragma once
 
 #include "crmath/geometry.h"
+#include "crmath/spatial.h"
+#include "crutil/variant_vector.h"
 #include "font.h"
 #include "opengl.h"
 #include <memory>
@@ -85,7 +87,7 @@ struct RawGL {
     std::shared_ptr<shader> shad;
     std::shared_ptr<vertex_array> vao;
     uniform_buffer uniforms;
-    std::string windowMatrixName;
+    cr::util::hashed_string windowMatrixName;
     DrawMode mode;
     unsigned int count;
     unsigned int offset;
@@ -98,7 +100,55 @@ struct Text {
     float scale;
 };
 
-using geometry = std::variant<Circle, Rectangle, Line, RawGL, Text>;
+/**
+ * @brief connected line strip, e.g. a curve flattened with cr::math::flatten
+ * @details the points are uploaded as they are, so they can be filled directly by the crmath curve functions
+ */
+struct Polyline {
+    std::vector<cr::math::cvector<float, 2>> points;
+    Color color;
+    float strokeWidth{};
+};
+
+/**
+ * @brief filled polygon with holes, triangulated when the vertices are set
+ * @details the vertex and index buffers are created on the first draw and shared by all copies until set_vertices is
+ * called, so a polygon that does not change is uploaded exactly once
+ */
+class Polygon {
+public:
+    struct gpu_cache;
+
+    Color color;
+
+    Polygon() = default;
+    /**
+     * @param vertices outer ring followed by the holes
+     * @param hole_starts index of the first vertex of every hole
+     */
+    Polygon(std::vector<cr::math::cvector<float, 2>> vertices, const Color& color,
+            std::vector<uint32_t> hole_starts = {});
+
+    void set_vertices(std::vector<cr::math::cvector<float, 2>> vertices, std::vector<uint32_t> hole_starts = {});
+    [[nodiscard]] const std::vector<cr::math::cvector<float, 2>>& get_vertices() const;
+    [[nodiscard]] const std::vector<uint32_t>& get_hole_starts() const;
+    [[nodiscard]] const std::vector<uint32_t>& get_indices() const;
+    [[nodiscard]] const cr::math::aabb& get_bounds() const;
+
+    /**
+     * @brief the uploaded buffers, created on first use, needs a current GL context
+     */
+    [[nodiscard]] const gpu_cache& gpu() const;
+
+private:
+    std::vector<cr::math::cvector<float, 2>> vertices;
+    std::vector<uint32_t> hole_starts;
+    std::vector<uint32_t> indices;
+    cr::math::aabb bounds;
+    mutable std::shared_ptr<gpu_cache> cache;
+};
+
+using geometry = std::variant<Circle, Rectangle, Line, RawGL, Text, Polyline, Polygon>;
 
 void draw(std::span<const geometry> geometries, std::unique_ptr<Window>& window,
           const cr::math::square_matrix<float, 3>& extra_matrix = cr::math::identity<float, 3>());
@@ -108,5 +158,31 @@ inline void draw(const std::vector<geometry>& geometries, std::unique_ptr<Window
     draw(std::span(geometries), window, extra_matrix);
 }
 
+/**
+ * @brief pixel space bounds of a geometry before extra_matrix, RawGL is unbounded since its vertices are unknown
+ */
+cr::math::aabb bounds(const geometry& g);
+
+/**
+ * @brief draws only the geometries whose bounds in index intersect view, in their original order
+ * @details index has to be built from bounds(geometries[i]) for every i, for static scenes it is built once
+ */
+void draw(std::span<const geometry> geometries, const cr::math::bvh& index, const cr::math::aabb& view,
+          std::unique_ptr<Window>& window,
+          const cr::math::square_matrix<float, 3>& extra_matrix = cr::math::identity<float, 3>());
+
+/**
+ * @brief geometries stored by type, drawing them runs one loop per type
+ */
+using geometry_list = cr::util::variant_vector_for<geometry>;
+
+/**
+ * @brief draws all Circles, then all Rectangles and so on, skipping those outside the window
+ * @details the insertion order is not kept, so overlapping geometries of different types may be drawn in another order
+ * than with a std::vector<geometry>. Use that for layered scenes.
+ */
+void draw_by_type(const geometry_list& geometries, std::unique_ptr<Window>& window,
+                  const cr::math::square_matrix<float, 3>& extra_matrix = cr::math::identity<float, 3>());
+
 void clear(const Color& color, std::unique_ptr<Window>& window);
 }// namespace cr::ui
@@ -6,6 +6,7 @@
 
 #include "geometry.h"
 #include "window.h"
+#include <algorithm>
 #include <span>
 #include <utility>
 
@@ -34,6 +35,7 @@ struct Slider {
     void set_border_width(float border_width);
 
     void apply(const event& event);
+    [[nodiscard]] math::aabb bounds() const;
     [[nodiscard]] bool requires_redraw() const;
     [[nodiscard]] std::span<const geometry> get_geometry();
 
@@ -63,6 +65,25 @@ void apply_all(Events& cont, T& g) {
     }
 }
 
+/**
+ * @brief window position of a mouse event
+ */
+inline Point event_position(const event& e) {
+    return std::visit([](const auto& ev) { return Point(float(ev.pos[0]), float(ev.pos[1])); }, e);
+}
+
+/**
+ * @brief sends every event only to the widgets whose bounds contain the event position
+ * @details index is a math::uniform_grid or math::bvh holding widgets[i].bounds() as id i, so hit-testing costs a
+ * lookup instead of a bounds check in every widget
+ */
+template<typename Events, typename T, typename Index>
+void apply_all(Events& cont, std::span<T> widgets, const Index& index) {
+    for (const auto& e : cont) {
+        index.query(event_position(e), [&](uint32_t id) { apply(e, widgets[id]); });
+    }
+}
+
 template<typename T>
 void update(T& g, std::unique_ptr<Window>& window, bool force = false, const cr::math::square_matrix<float, 3>& extra_matrix = cr::math::identity<float, 3>()) {
     if (force || g.requires_redraw()) {
@@ -77,4 +98,20 @@ void update_all(Container& cont, std::unique_ptr<Window>& window, bool force = f
     }
 }
 
+/**
+ * @brief like update_all, but skips the widgets whose bounds in index lie outside view
+ * @details index holds cont[i].bounds() as id i, the visible widgets are updated in their original order
+ */
+template<typename Container, typename Index>
+void update_visible(Container& cont, const Index& index, const cr::math::aabb& view, std::unique_ptr<Window>& window,
+                    bool force = false,
+                    const cr::math::square_matrix<float, 3>& extra_matrix = cr::math::identity<float, 3>()) {
+    std::vector<uint32_t> visible;
+    index.query(view, [&](uint32_t id) { visible.push_back(id); });
+    std::sort(visible.begin(), visible.end());
+    for (auto id : visible) {
+        update(cont[id], window, force, extra_matrix);
+    }
+}
+
 }// namespace cr::ui
\ No newline at end of file
@@ -5,7 +5,9 @@
 #pragma once
 
 #include "crmath/geometry.h"
-#include <map>
+#include "crutil/flat_hash_map.h"
+#include "crutil/hashed_string.h"
+#include "crutil/small_vector.h"
 #include <memory>
 #include <variant>
 #include <vector>
@@ -42,12 +44,14 @@ using uniform_value = std::variant<float, int, bool,
                                    cr::math::cvector<float, 4>,
                                    std::shared_ptr<texture>>;
 
+// names are hashed at compile time when written as literals, use cr::util::hashed_string::intern for runtime names
 struct uniform {
-    std::string name;
+    cr::util::hashed_string name;
     uniform_value value;
 };
 
-using uniform_buffer = std::vector<uniform>;
+// a draw sets a handful of uniforms, inline storage keeps building them per draw off the heap
+using uniform_buffer = cr::util::small_vector<uniform, 6>;
 
 struct shader {
     shader();
@@ -62,15 +66,19 @@ struct shader {
 
     ~shader();
 
-    void set_uniform(const std::string& name, const uniform_value& value) const;
+    void set_uniform(const cr::util::hashed_string& name, const uniform_value& value) const;
 
     void use() const;
 
 private:
     unsigned int id{};
-    mutable std::map<std::string, int> texture_units;
+    // glGetUniformLocation is a string lookup in the driver, each name is only asked for once
+    mutable cr::util::flat_hash_map<cr::util::hashed_string, int> uniform_locations;
+    mutable cr::util::flat_hash_map<cr::util::hashed_string, int> texture_units;
 
-    int get_texture_unit(const std::string& name) const;
+    int get_uniform_location(const cr::util::hashed_string& name) const;
+
+    int get_texture_unit(const cr::util::hashed_string& name) const;
 
     friend shader create_shader(const std::string& vertex_shader, const std::string& fragment_shader);
 };
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "crmath/matrix.h"
+#include "crutil/small_vector.h"
 #include <memory>
 #include <variant>
 #include <vector>
@@ -38,6 +39,8 @@ struct MouseReleaseEvent {
     MouseButton button;
 };
 using event = std::variant<MouseMoveEvent, MousePressEvent, MouseReleaseEvent, MouseDragEvent>;
+// the events of one frame, usually a handful
+using event_list = cr::util::small_vector<event, 16>;
 
 struct Window {
     GLFWwindow* window = nullptr;
@@ -50,7 +53,7 @@ struct Window {
     ~Window();
 
     void update();
-    std::vector<event> get_events();
+    event_list get_events();
 
     [[nodiscard]] cr::math::cvector<int, 2> size() const;
 
@@ -64,7 +67,7 @@ struct Window {
 
 private:
     bool isOpen = true;
-    std::vector<event> events;
+    event_list events;
 
     friend std::unique_ptr<Window> createWindow();
 };
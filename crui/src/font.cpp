@@ -3,6 +3,7 @@
 //
 
 #include "font.h"
+#include "crutil/file.h"
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
@@ -18,15 +19,22 @@ static FT_Library& get_ftlib() {
 
 namespace cr::ui {
 std::shared_ptr<font> loadFont(const std::string& path, unsigned int size) {
+    cr::util::mapped_file file(path);
+    return loadFont(file.bytes(), size);
+}
+
+std::shared_ptr<font> loadFont(std::span<const std::byte> data, unsigned int size) {
     FT_Face face;
-    FT_New_Face(get_ftlib(), path.c_str(), 0, &face);
+    if (FT_New_Memory_Face(get_ftlib(), reinterpret_cast<const FT_Byte*>(data.data()), FT_Long(data.size()), 0,
+                           &face) != 0) {
+        throw std::runtime_error("failed to load font");
+    }
     FT_Set_Char_Size(face, 0, size * 64, 300, 300);
 
     unsigned int maxCharWidth = 0;
     unsigned int maxCharHeight = 0;
 
-    std::unordered_map<char, font::glyph> glyphs;
-    glyphs.reserve(128);
+    font::glyph_table glyphs;
     for (size_t i = 0; i < 128; ++i) {
         // load only width and height of bitmap
         FT_Load_Char(face, i, FT_LOAD_RENDER);
@@ -3,13 +3,20 @@
 //
 
 #include "geometry.h"
+#include "crmath/culling.h"
+#include "crmath/triangulate.h"
 #include "crutil/overload.h"
+#include "crutil/trace.h"
+#include "crutil/visit.h"
 #include "opengl.h"
 #include "window.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
+#include <numeric>
 
 using namespace cr::ui;
 
@@ -137,6 +144,7 @@ struct CircleDrawer {
     }
 
     void operator()(const cr::ui::Circle& circle, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("CircleDrawer");
         cr::math::square_matrix<float, 3> projection =
                 window_matrix * cr::math::translate_matrix<float>(circle.pos.x(), circle.pos.y()) * cr::math::scale_matrix<float>(cr::math::with_translation, circle.radius, circle.radius);
         auto startAngle = wrapAngle(circle.startAngle);
@@ -184,6 +192,7 @@ struct RectangleDrawer {
     }
 
     void operator()(const cr::ui::Rectangle& rect, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("RectangleDrawer");
         cr::math::square_matrix<float, 3> projection =
                 window_matrix *
                 cr::math::translate_matrix<float>(rect.pos.x(), rect.pos.y()) *
@@ -219,6 +228,7 @@ struct LineDrawer {
     }
 
     void operator()(const cr::ui::Line& line, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("LineDrawer");
         auto delta = line.end - line.start;
         cr::math::square_matrix<float, 3> projection =
                 window_matrix *
@@ -232,6 +242,61 @@ struct LineDrawer {
     }
 };
 
+struct PolylineDrawer {
+    shader shad;
+    mutable vertex_array vao;
+    mutable size_t indexCapacity = 0;
+
+    PolylineDrawer() {
+        shad = create_shader(vsSourceRectangle, fsSourceRectangle);
+        vao.set_vertex_buffer(vertex_buffer{});
+        vao.set_index_buffer(index_buffer{});
+        vao.add_attribute(0, vertex_array::attribute_type::float_type, 2, 0, 8);
+    }
+
+    void operator()(const cr::ui::Polyline& line, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("PolylineDrawer");
+        if (line.points.size() < 2)
+            return;
+        if (line.points.size() > indexCapacity) {
+            // the strip is drawn indexed like everything else, the indices only change when a longer strip comes
+            indexCapacity = std::bit_ceil(line.points.size());
+            std::vector<unsigned int> indices(indexCapacity);
+            std::iota(indices.begin(), indices.end(), 0u);
+            vao.use();
+            vao.get_index_buffer().set_data(indices);
+        }
+        vao.get_vertex_buffer().set_data(line.points, true);
+        uniform_buffer uniforms = {
+                {"projection", window_matrix},
+                {"color", line.color}};
+        lineWidth(line.strokeWidth);
+        draw(vao, shad, uniforms, (int) line.points.size(), 0, DrawMode::line_strip);
+    }
+};
+
+struct cr::ui::Polygon::gpu_cache {
+    vertex_array vao;
+};
+
+struct PolygonDrawer {
+    shader shad;
+
+    PolygonDrawer() {
+        shad = create_shader(vsSourceRectangle, fsSourceRectangle);
+    }
+
+    void operator()(const cr::ui::Polygon& polygon, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("PolygonDrawer");
+        if (polygon.get_indices().empty())
+            return;
+        uniform_buffer uniforms = {
+                {"projection", window_matrix},
+                {"color", polygon.color}};
+        draw(polygon.gpu().vao, shad, uniforms, (int) polygon.get_indices().size(), 0);
+    }
+};
+
 struct TextDrawer {
     shader shad;
     mutable vertex_array vao;
@@ -257,6 +322,7 @@ struct TextDrawer {
     }
 
     void operator()(const cr::ui::Text& text, const cr::math::square_matrix<float, 3>& window_matrix) const {
+        CR_TRACE_SCOPE("TextDrawer");
         auto pos = text.pos / text.scale;
         cr::math::square_matrix<float, 3> projection =
                 window_matrix *
@@ -295,7 +361,10 @@ static auto& get_visitor() {
             RectangleDrawer{},
             LineDrawer{},
             TextDrawer{},
+            PolylineDrawer{},
+            PolygonDrawer{},
             [](const RawGL& raw, const cr::math::square_matrix<float, 3>& window_matrix) {
+                CR_TRACE_SCOPE("RawGL");
                 uniform_buffer tmp = raw.uniforms;
                 tmp.push_back({raw.windowMatrixName, window_matrix});
                 draw(*raw.vao, *raw.shad, tmp, (int) raw.count, (int) raw.offset, raw.mode);
@@ -303,18 +372,195 @@ static auto& get_visitor() {
     return visitor;
 }
 
+static cr::math::square_matrix<float, 3> begin_draw(std::unique_ptr<Window>& window,
+                                                    const cr::math::square_matrix<float, 3>& extra_matrix) {
+    glfwMakeContextCurrent(window->window);
+    auto size = window->size();
+    glViewport(0, 0, size[0], size[1]);
+    return opengl_window_to_pixel(size[0], size[1]) * extra_matrix;
+}
+
+// the window rectangle in the coordinates the geometries are given in, i.e. before extra_matrix
+static cr::math::aabb visible_area(std::unique_ptr<Window>& window,
+                                   const cr::math::square_matrix<float, 3>& extra_matrix) {
+    auto size = window->size();
+    auto inverse = cr::math::inverse(extra_matrix);
+    if (!inverse) {
+        return cr::math::aabb::everything();
+    }
+    cr::math::aabb res;
+    for (auto [x, y] : {std::pair{0, 0}, std::pair{size[0], 0}, std::pair{0, size[1]}, std::pair{size[0], size[1]}}) {
+        cr::math::cvector<float, 3> corner = *inverse * cr::math::cvector<float, 3>{float(x), float(y), 1.0f};
+        if (corner[2] <= 0) {
+            return cr::math::aabb::everything();
+        }
+        res.expand(cr::math::cvector<float, 2>{corner[0] / corner[2], corner[1] / corner[2]});
+    }
+    return res;
+}
+
 void draw(std::span<const geometry> geometries, std::unique_ptr<Window>& window,
           const cr::math::square_matrix<float, 3>& extra_matrix) {
+    CR_TRACE_SCOPE("ui::draw");
     if (!window->exists())
         return;
-    glfwMakeContextCurrent(window->window);
-    auto size = window->size();
-    glViewport(0, 0, size[0], size[1]);
-    auto opengl_window_to_pixel_matrix = opengl_window_to_pixel(size[0], size[1]) * extra_matrix;
+    // bounds are gathered into one batch so that off-screen geometries are dropped before any GL state is touched
+    thread_local cr::math::aabb2_batch batch;
+    thread_local std::vector<uint32_t> visible;
+    batch.clear();
+    batch.reserve(geometries.size());
     for (const auto& geometry : geometries) {
-        std::visit(get_visitor(), geometry,
-                   std::variant<cr::math::matrix<float, 3, 3>>(opengl_window_to_pixel_matrix));
+        batch.push_back(bounds(geometry));
+    }
+    visible.resize(geometries.size());
+    auto count = cr::math::cull(batch, visible_area(window, extra_matrix), visible);
+    auto opengl_window_to_pixel_matrix = begin_draw(window, extra_matrix);
+    for (size_t i = 0; i < count; i++) {
+        cr::util::visit(get_visitor(), geometries[visible[i]],
+                        std::variant<cr::math::matrix<float, 3, 3>>(opengl_window_to_pixel_matrix));
+    }
+}
+
+void draw(std::span<const geometry> geometries, const cr::math::bvh& index, const cr::math::aabb& view,
+          std::unique_ptr<Window>& window, const cr::math::square_matrix<float, 3>& extra_matrix) {
+    CR_TRACE_SCOPE("ui::draw bvh");
+    if (!window->exists())
+        return;
+    std::vector<uint32_t> visible;
+    index.query(view, [&](uint32_t id) { visible.push_back(id); });
+    // later geometries are drawn over earlier ones, so the query order is not good enough
+    std::sort(visible.begin(), visible.end());
+    auto opengl_window_to_pixel_matrix = begin_draw(window, extra_matrix);
+    for (auto id : visible) {
+        cr::util::visit(get_visitor(), geometries[id],
+                        std::variant<cr::math::matrix<float, 3, 3>>(opengl_window_to_pixel_matrix));
+    }
+}
+
+static auto& get_bounds_visitor() {
+    static auto visitor = cr::util::overloaded{
+            [](const Circle& circle) {
+                return cr::math::aabb{{circle.pos.x() - circle.radius, circle.pos.y() - circle.radius},
+                                      {circle.pos.x() + circle.radius, circle.pos.y() + circle.radius}};
+            },
+            [](const Rectangle& rect) {
+                cr::math::aabb res;
+                res.expand(rect.pos);
+                res.expand(cr::math::cvector<float, 2>{rect.pos.x() + rect.width, rect.pos.y() + rect.height});
+                return res;
+            },
+            [](const Line& line) {
+                cr::math::aabb res;
+                res.expand(line.start);
+                res.expand(line.end);
+                float half = line.strokeWidth / 2;
+                return cr::math::aabb{{res.min[0] - half, res.min[1] - half}, {res.max[0] + half, res.max[1] + half}};
+            },
+            [](const RawGL&) {
+                return cr::math::aabb::everything();
+            },
+            [](const Text& text) {
+                // same glyph placement as TextDrawer
+                cr::math::aabb res;
+                if (!text.font_ptr) {
+                    return res;
+                }
+                float x = text.pos.x();
+                for (char c : text.text) {
+                    const auto* glyph_ptr = text.font_ptr->glyphs.find(c);
+                    if (glyph_ptr == nullptr) {
+                        continue;
+                    }
+                    const auto& glyph = *glyph_ptr;
+                    float left = x + float(glyph.bearingX) * text.scale;
+                    float top = text.pos.y() - float(glyph.bearingY) * text.scale;
+                    res.expand(cr::math::cvector<float, 2>{left, top});
+                    res.expand(cr::math::cvector<float, 2>{left + float(glyph.width) * text.scale,
+                                                           top + float(glyph.height) * text.scale});
+                    x += float(glyph.advance) * text.scale;
+                }
+                return res;
+            },
+            [](const Polygon& polygon) {
+                return polygon.get_bounds();
+            },
+            [](const Polyline& line) {
+                cr::math::aabb res;
+                for (const auto& point : line.points) {
+                    res.expand(point);
+                }
+                float half = line.strokeWidth / 2;
+                return cr::math::aabb{{res.min[0] - half, res.min[1] - half}, {res.max[0] + half, res.max[1] + half}};
+            }};
+    return visitor;
+}
+
+cr::math::aabb bounds(const geometry& g) {
+    return cr::util::visit(get_bounds_visitor(), g);
+}
+
+void draw_by_type(const geometry_list& geometries, std::unique_ptr<Window>& window,
+                  const cr::math::square_matrix<float, 3>& extra_matrix) {
+    CR_TRACE_SCOPE("ui::draw_by_type");
+    if (!window->exists())
+        return;
+    auto view = visible_area(window, extra_matrix);
+    auto opengl_window_to_pixel_matrix = begin_draw(window, extra_matrix);
+    // the visitors are called with the alternative itself, so there is no variant dispatch inside the loops
+    geometries.for_each_type([&](auto span) {
+        for (const auto& geometry : span) {
+            if (get_bounds_visitor()(geometry).intersects(view)) {
+                get_visitor()(geometry, opengl_window_to_pixel_matrix);
+            }
+        }
+    });
+}
+
+Polygon::Polygon(std::vector<cr::math::cvector<float, 2>> vertices, const Color& color,
+                 std::vector<uint32_t> hole_starts) : color(color) {
+    set_vertices(std::move(vertices), std::move(hole_starts));
+}
+
+void Polygon::set_vertices(std::vector<cr::math::cvector<float, 2>> n_vertices, std::vector<uint32_t> n_hole_starts) {
+    vertices = std::move(n_vertices);
+    hole_starts = std::move(n_hole_starts);
+    indices = cr::math::triangulate(vertices, hole_starts);
+    bounds = {};
+    for (const auto& vertex : vertices) {
+        bounds.expand(vertex);
+    }
+    // copies drawn before keep the old buffers, this one uploads again on its next draw
+    cache.reset();
+}
+
+const std::vector<cr::math::cvector<float, 2>>& Polygon::get_vertices() const {
+    return vertices;
+}
+
+const std::vector<uint32_t>& Polygon::get_hole_starts() const {
+    return hole_starts;
+}
+
+const std::vector<uint32_t>& Polygon::get_indices() const {
+    return indices;
+}
+
+const cr::math::aabb& Polygon::get_bounds() const {
+    return bounds;
+}
+
+const Polygon::gpu_cache& Polygon::gpu() const {
+    if (!cache) {
+        cache = std::make_shared<gpu_cache>();
+        vertex_buffer vbo;
+        index_buffer ibo;
+        vbo.set_data(vertices);
+        ibo.set_data(indices);
+        cache->vao.set_vertex_buffer(std::move(vbo));
+        cache->vao.set_index_buffer(std::move(ibo));
+        cache->vao.add_attribute(0, vertex_array::attribute_type::float_type, 2, 0, 8);
     }
+    return *cache;
 }
 
 void clear(const Color& color, std::unique_ptr<Window>& window) {
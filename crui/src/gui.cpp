@@ -95,6 +95,10 @@ void Slider::update_geometry() {
     stateChanged = false;
 }
 
+[[nodiscard]] math::aabb Slider::bounds() const {
+    return {pos, pos + size};
+}
+
 [[nodiscard]] bool Slider::requires_redraw() const {
     return stateChanged;
 }
@@ -4,6 +4,8 @@
 
 #include "opengl.h"
 #include "crutil/overload.h"
+#include "crutil/trace.h"
+#include "crutil/visit.h"
 #include <GL/glew.h>
 #include <iostream>
 
@@ -23,12 +25,16 @@ shader::shader() {
 shader::shader(shader&& other) noexcept {
     id = other.id;
     other.id = 0;
+    uniform_locations = std::move(other.uniform_locations);
+    texture_units = std::move(other.texture_units);
 }
 
 shader& shader::operator=(shader&& other) noexcept {
     if (id) glDeleteProgram(id);
     id = other.id;
     other.id = 0;
+    uniform_locations = std::move(other.uniform_locations);
+    texture_units = std::move(other.texture_units);
     return *this;
 }
 
@@ -36,35 +42,37 @@ shader::~shader() {
     if (id) glDeleteProgram(id);
 }
 
-void shader::set_uniform(const std::string& name, const uniform_value& value) const {
-    auto location = glGetUniformLocation(id, name.c_str());
-    std::visit(util::overloaded{
-                       [&](float v) { glUniform1f(location, v); },
-                       [&](int v) { glUniform1i(location, v); },
-                       [&](bool v) { glUniform1i(location, v); },
-                       [&](const cr::math::square_matrix<float, 4>& v) { glUniformMatrix4fv(location, 1, GL_TRUE, v.raw()); },
-                       [&](const cr::math::square_matrix<float, 3>& v) { glUniformMatrix3fv(location, 1, GL_TRUE, v.raw()); },
-                       [&](const cr::math::square_matrix<float, 2>& v) { glUniformMatrix2fv(location, 1, GL_TRUE, v.raw()); },
-                       [&](const cr::math::cvector<float, 2>& v) { glUniform2fv(location, 1, v.raw()); },
-                       [&](const cr::math::cvector<float, 3>& v) { glUniform3fv(location, 1, v.raw()); },
-                       [&](const cr::math::cvector<float, 4>& v) { glUniform4fv(location, 1, v.raw()); },
-                       [&](const std::shared_ptr<texture>& v) {
-                           int texture_unit = get_texture_unit(name);
-                           glActiveTexture(GL_TEXTURE0 + texture_unit);
-                           glBindTexture(GL_TEXTURE_2D, v->id);
-                           glUniform1i(location, texture_unit);
-                       }},
-               value);
-}
-
-int shader::get_texture_unit(const std::string& name) const {
-    auto it = texture_units.find(name);
-    if (it != texture_units.end()) {
-        return it->second;
+void shader::set_uniform(const util::hashed_string& name, const uniform_value& value) const {
+    auto location = get_uniform_location(name);
+    util::visit(util::overloaded{
+                        [&](float v) { glUniform1f(location, v); },
+                        [&](int v) { glUniform1i(location, v); },
+                        [&](bool v) { glUniform1i(location, v); },
+                        [&](const cr::math::square_matrix<float, 4>& v) { glUniformMatrix4fv(location, 1, GL_TRUE, v.raw()); },
+                        [&](const cr::math::square_matrix<float, 3>& v) { glUniformMatrix3fv(location, 1, GL_TRUE, v.raw()); },
+                        [&](const cr::math::square_matrix<float, 2>& v) { glUniformMatrix2fv(location, 1, GL_TRUE, v.raw()); },
+                        [&](const cr::math::cvector<float, 2>& v) { glUniform2fv(location, 1, v.raw()); },
+                        [&](const cr::math::cvector<float, 3>& v) { glUniform3fv(location, 1, v.raw()); },
+                        [&](const cr::math::cvector<float, 4>& v) { glUniform4fv(location, 1, v.raw()); },
+                        [&](const std::shared_ptr<texture>& v) {
+                            int texture_unit = get_texture_unit(name);
+                            glActiveTexture(GL_TEXTURE0 + texture_unit);
+                            glBindTexture(GL_TEXTURE_2D, v->id);
+                            glUniform1i(location, texture_unit);
+                        }},
+                value);
+}
+
+int shader::get_uniform_location(const util::hashed_string& name) const {
+    auto [it, inserted] = uniform_locations.try_emplace(name);
+    if (inserted) {
+        it->second = glGetUniformLocation(id, name.c_str());
     }
-    int texture_unit = int(texture_units.size());
-    texture_units[name] = texture_unit;
-    return texture_unit;
+    return it->second;
+}
+
+int shader::get_texture_unit(const util::hashed_string& name) const {
+    return texture_units.try_emplace(name, int(texture_units.size())).first->second;
 }
 
 void shader::use() const {
@@ -128,6 +136,8 @@ vertex_buffer::~vertex_buffer() {
 }
 
 void vertex_buffer::set_data(const void* data, unsigned int size, bool dyn_draw) const {
+    CR_TRACE_SCOPE("vertex_buffer::set_data");
+    CR_TRACE_COUNTER("vertex upload bytes", size);
     glBindBuffer(GL_ARRAY_BUFFER, id);
     glBufferData(GL_ARRAY_BUFFER, size, data, dyn_draw ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
 }
@@ -153,6 +163,7 @@ index_buffer::~index_buffer() {
 }
 
 void index_buffer::set_data(const void* data, unsigned int size) const {
+    CR_TRACE_SCOPE("index_buffer::set_data");
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
@@ -293,6 +304,7 @@ texture::~texture() {
 }
 
 void texture::set_data(const void* data, unsigned int width, unsigned int height, unsigned int channels) const {
+    CR_TRACE_SCOPE("texture::set_data");
     glBindTexture(GL_TEXTURE_2D, id);
     GLint format;
     switch (channels) {
@@ -3,9 +3,11 @@
 //
 
 #include "window.h"
+#include "crutil/trace.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <optional>
+#include <utility>
 
 static bool glfwInitialized = false;
 
@@ -56,6 +58,8 @@ std::unique_ptr<Window> createWindow() {
 }
 
 void Window::update() {
+    CR_TRACE_FRAME();
+    CR_TRACE_SCOPE("Window::update");
     glfwSwapBuffers(window);
     glfwPollEvents();
     if (glfwWindowShouldClose(window)) {
@@ -79,10 +83,8 @@ cr::math::cvector<int, 2> Window::size() const {
     return size;
 }
 
-std::vector<event> Window::get_events() {
-    std::vector<event> events;
-    std::swap(events, this->events);
-    return events;
+event_list Window::get_events() {
+    return std::exchange(events, {});
 }
 
 cr::math::cvector<int, 2> Window::get_mouse_position() const {
@@ -0,0 +1,80 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/arena.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+using namespace cr::util;
+
+// shaped like a crui uniform, a short name and a value
+struct item {
+    std::string name;
+    float value[16];
+};
+
+// a frame of many small lists, like a draw call per geometry building its uniforms
+static void bm_frame_heap(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int64_t list = 0; list < state.range(0); list++) {
+            std::vector<item> items{{"projection", {}}, {"color", {}}, {"innerRadius", {}}};
+            benchmark::DoNotOptimize(items.data());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_frame_arena(benchmark::State& state) {
+    frame_arena frame;
+    for (auto _ : state) {
+        frame.reset();
+        for (int64_t list = 0; list < state.range(0); list++) {
+            std::pmr::vector<item> items({{"projection", {}}, {"color", {}}, {"innerRadius", {}}}, &frame);
+            benchmark::DoNotOptimize(items.data());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_frame_scratch(benchmark::State& state) {
+    for (auto _ : state) {
+        for (int64_t list = 0; list < state.range(0); list++) {
+            scratch s;
+            std::pmr::vector<item> items({{"projection", {}}, {"color", {}}, {"innerRadius", {}}}, &s);
+            benchmark::DoNotOptimize(items.data());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// a growing vector, its old buffers stay in the arena until the scratch ends
+static void bm_push_back_heap(benchmark::State& state) {
+    for (auto _ : state) {
+        std::vector<int> values;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            values.push_back(int(i));
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_push_back_scratch(benchmark::State& state) {
+    for (auto _ : state) {
+        scratch s;
+        std::pmr::vector<int> values(&s);
+        for (int64_t i = 0; i < state.range(0); i++) {
+            values.push_back(int(i));
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_frame_heap)->Arg(1000);
+BENCHMARK(bm_frame_arena)->Arg(1000);
+BENCHMARK(bm_frame_scratch)->Arg(1000);
+BENCHMARK(bm_push_back_heap)->Arg(1000);
+BENCHMARK(bm_push_back_scratch)->Arg(1000);
@@ -0,0 +1,82 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/file.h"
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace cr::util;
+
+// 256 files of 16 KiB each, about the size of a compiled shader, the page cache is warm after the first pass
+static const std::vector<std::filesystem::path>& asset_files() {
+    static std::vector<std::filesystem::path> paths = [] {
+        auto dir = std::filesystem::temp_directory_path() / "crutil_file_bench";
+        std::filesystem::create_directories(dir);
+        std::vector<std::filesystem::path> result;
+        std::string content(16 * 1024, 'x');
+        for (size_t i = 0; i < 256; i++) {
+            auto path = dir / ("asset" + std::to_string(i) + ".spv");
+            std::ofstream(path, std::ios::binary).write(content.data(), std::streamsize(content.size()));
+            result.push_back(path);
+        }
+        return result;
+    }();
+    return paths;
+}
+
+static void set_bytes(benchmark::State& state) {
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(asset_files().size()) * 16 * 1024);
+}
+
+static void bm_istreambuf_iterator(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& path : asset_files()) {
+            std::ifstream file(path, std::ios::binary);
+            std::vector<char> code((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            benchmark::DoNotOptimize(code.data());
+        }
+    }
+    set_bytes(state);
+}
+
+static void bm_read_file(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& path : asset_files()) {
+            auto file = read_file(path);
+            benchmark::DoNotOptimize(file.data());
+        }
+    }
+    set_bytes(state);
+}
+
+static void bm_mapped_file(benchmark::State& state) {
+    for (auto _ : state) {
+        for (const auto& path : asset_files()) {
+            mapped_file file(path);
+            benchmark::DoNotOptimize(file.data());
+        }
+    }
+    set_bytes(state);
+}
+
+static void bm_file_reader(benchmark::State& state) {
+    thread_pool pool;
+    file_reader reader(pool, {64, state.range(0) != 0});
+    for (auto _ : state) {
+        auto batch = reader.read(asset_files());
+        batch.wait();
+        benchmark::DoNotOptimize(batch[0].data());
+    }
+    set_bytes(state);
+    state.SetLabel(reader.uses_io_uring() ? "io_uring" : "thread_pool");
+}
+
+BENCHMARK(bm_istreambuf_iterator);
+BENCHMARK(bm_read_file);
+BENCHMARK(bm_mapped_file);
+BENCHMARK(bm_file_reader)->Arg(1)->Arg(0);
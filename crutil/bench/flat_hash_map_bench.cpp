@@ -0,0 +1,124 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/flat_hash_map.h"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace cr::util;
+
+// shaped like font::glyph
+struct glyph {
+    unsigned int atlas[4];
+    unsigned int advance, width, height;
+    int bearing[2];
+};
+
+// TextDrawer: one glyph lookup per character of a line of text
+template<typename Map>
+static void bm_glyph_lookup(benchmark::State& state) {
+    Map glyphs;
+    for (int c = 32; c < 128; c++) {
+        glyphs[char(c)] = glyph{{unsigned(c)}, unsigned(c), 0, 0, {0, 0}};
+    }
+    std::string text = "The quick brown fox jumps over the lazy dog, 0123456789 times!";
+    for (auto _ : state) {
+        unsigned int advance = 0;
+        for (char c : text) {
+            advance += glyphs.find(c)->second.advance;
+        }
+        benchmark::DoNotOptimize(advance);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+
+// font::glyph_table: the ASCII glyphs in an array indexed by the character
+static void bm_glyph_lookup_array(benchmark::State& state) {
+    std::array<glyph, 128> glyphs{};
+    for (int c = 32; c < 128; c++) {
+        glyphs[size_t(c)] = glyph{{unsigned(c)}, unsigned(c), 0, 0, {0, 0}};
+    }
+    std::string text = "The quick brown fox jumps over the lazy dog, 0123456789 times!";
+    for (auto _ : state) {
+        unsigned int advance = 0;
+        for (char c : text) {
+            advance += glyphs[static_cast<unsigned char>(c)].advance;
+        }
+        benchmark::DoNotOptimize(advance);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+
+// range(0) keys, looked up in random order, half of the lookups miss
+template<typename Map>
+static void bm_int_lookup(benchmark::State& state) {
+    auto n = size_t(state.range(0));
+    std::mt19937_64 rng(1);
+    Map map;
+    std::vector<uint64_t> keys;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = rng();
+        map[key] = i;
+        keys.push_back(key);
+        keys.push_back(rng());
+    }
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (auto _ : state) {
+        size_t found = 0;
+        for (auto key : keys) {
+            found += map.find(key) != map.end();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(keys.size()));
+}
+
+// proxyCall style: string keys
+template<typename Map>
+static void bm_string_lookup(benchmark::State& state) {
+    Map map;
+    std::vector<std::string> keys;
+    for (int i = 0; i < 64; i++) {
+        keys.push_back("vkFunctionNameNumber" + std::to_string(i));
+        map[keys.back()] = i;
+    }
+    for (auto _ : state) {
+        int sum = 0;
+        for (const auto& key : keys) {
+            sum += map.find(key)->second;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(keys.size()));
+}
+
+template<typename Map>
+static void bm_insert(benchmark::State& state) {
+    auto n = uint64_t(state.range(0));
+    for (auto _ : state) {
+        Map map;
+        for (uint64_t i = 0; i < n; i++) {
+            map[i * 0x9e3779b97f4a7c15] = i;
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(n));
+}
+
+BENCHMARK(bm_glyph_lookup<std::unordered_map<char, glyph>>);
+BENCHMARK(bm_glyph_lookup<flat_hash_map<char, glyph>>);
+BENCHMARK(bm_glyph_lookup_array);
+BENCHMARK(bm_int_lookup<std::map<uint64_t, uint64_t>>)->Arg(64)->Arg(1 << 16);
+BENCHMARK(bm_int_lookup<std::unordered_map<uint64_t, uint64_t>>)->Arg(64)->Arg(1 << 16);
+BENCHMARK(bm_int_lookup<flat_hash_map<uint64_t, uint64_t>>)->Arg(64)->Arg(1 << 16);
+BENCHMARK(bm_string_lookup<std::map<std::string, int>>);
+BENCHMARK(bm_string_lookup<std::unordered_map<std::string, int>>);
+BENCHMARK(bm_string_lookup<flat_hash_map<std::string, int>>);
+BENCHMARK(bm_insert<std::unordered_map<uint64_t, uint64_t>>)->Arg(1 << 16);
+BENCHMARK(bm_insert<flat_hash_map<uint64_t, uint64_t>>)->Arg(1 << 16);
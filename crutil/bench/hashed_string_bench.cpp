@@ -0,0 +1,57 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/flat_hash_map.h"
+#include "crutil/hashed_string.h"
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+
+using namespace cr::util;
+
+// a frame of uniform lookups: 200 draws setting 4 uniforms of a shader that has 6
+static constexpr hashed_string names[] = {"projection", "color", "innerRadius", "outerRadius", "windowMatrix", "tex"};
+
+static void bm_std_map_lookup(benchmark::State& state) {
+    std::map<std::string, int> locations;
+    for (int i = 0; i < 6; i++) {
+        locations[names[i].c_str()] = i;
+    }
+    for (auto _ : state) {
+        for (int draw = 0; draw < 200; draw++) {
+            for (int i = 0; i < 4; i++) {
+                // what set_uniform paid per uniform: a std::string from the literal and a string compare per node
+                benchmark::DoNotOptimize(locations.find(names[(draw + i) % 6].c_str())->second);
+            }
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 800);
+}
+
+static void bm_hashed_string_lookup(benchmark::State& state) {
+    flat_hash_map<hashed_string, int> locations;
+    for (int i = 0; i < 6; i++) {
+        locations[names[i]] = i;
+    }
+    for (auto _ : state) {
+        for (int draw = 0; draw < 200; draw++) {
+            for (int i = 0; i < 4; i++) {
+                benchmark::DoNotOptimize(locations.find(names[(draw + i) % 6])->second);
+            }
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 800);
+}
+
+// names built at runtime hash once when interned, after that they are as cheap as literals
+static void bm_intern(benchmark::State& state) {
+    std::string name = "light" + std::to_string(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hashed_string::intern(name));
+    }
+}
+
+BENCHMARK(bm_std_map_lookup);
+BENCHMARK(bm_hashed_string_lookup);
+BENCHMARK(bm_intern)->Arg(3);
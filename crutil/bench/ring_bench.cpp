@@ -0,0 +1,178 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/ring.h"
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace cr::util;
+
+// the baseline the rings replace
+template<typename T>
+class mutex_queue {
+public:
+    bool try_push(T value) {
+        std::lock_guard lock(mutex);
+        values.push_back(std::move(value));
+        return true;
+    }
+
+    std::optional<T> try_pop() {
+        std::lock_guard lock(mutex);
+        if (values.empty()) {
+            return std::nullopt;
+        }
+        T res = std::move(values.front());
+        values.pop_front();
+        return res;
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<T> values;
+};
+
+// cost of one push and one pop without contention, what a frame pays per handed over item
+template<typename Queue>
+static void bm_push_pop(benchmark::State& state) {
+    Queue queue(1024);
+    for (auto _ : state) {
+        for (int64_t i = 0; i < 64; i++) {
+            queue.try_push(i);
+        }
+        for (int64_t i = 0; i < 64; i++) {
+            benchmark::DoNotOptimize(queue.try_pop());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 64);
+}
+
+static void bm_mutex_push_pop(benchmark::State& state) {
+    mutex_queue<int64_t> queue;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < 64; i++) {
+            queue.try_push(i);
+        }
+        for (int64_t i = 0; i < 64; i++) {
+            benchmark::DoNotOptimize(queue.try_pop());
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 64);
+}
+
+static void bm_spsc_batch_push_pop(benchmark::State& state) {
+    spsc_ring<int64_t> ring(1024);
+    std::vector<int64_t> values(64, 1);
+    std::vector<int64_t> out(64);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.try_push(std::span(values)));
+        benchmark::DoNotOptimize(ring.try_pop(std::span(out)));
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 64);
+}
+
+// one producer thread, the benchmark thread consumes, range(0) is the batch size
+static void bm_spsc_throughput(benchmark::State& state) {
+    constexpr int64_t count = 1 << 16;
+    auto batch = size_t(state.range(0));
+    for (auto _ : state) {
+        spsc_ring<int64_t> ring(1024);
+        std::thread producer([&] {
+            std::vector<int64_t> values(batch, 1);
+            for (int64_t sent = 0; sent < count;) {
+                auto n = ring.try_push(std::span(values).first(std::min<size_t>(batch, size_t(count - sent))));
+                if (n == 0) {
+                    std::this_thread::yield();
+                }
+                sent += int64_t(n);
+            }
+        });
+        std::vector<int64_t> out(batch);
+        for (int64_t received = 0; received < count;) {
+            auto n = ring.try_pop(std::span(out));
+            if (n == 0) {
+                std::this_thread::yield();
+            }
+            received += int64_t(n);
+        }
+        producer.join();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+
+// range(0) producers and as many consumers
+template<typename Queue>
+static void bm_mpmc_throughput(benchmark::State& state) {
+    constexpr int64_t count = 1 << 16;
+    auto threads = state.range(0);
+    for (auto _ : state) {
+        Queue queue(1024);
+        std::atomic<int64_t> received{0};
+        std::vector<std::thread> workers;
+        for (int64_t t = 0; t < threads; t++) {
+            workers.emplace_back([&] {
+                for (int64_t i = 0; i < count / threads; i++) {
+                    while (!queue.try_push(i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            workers.emplace_back([&] {
+                while (received.load(std::memory_order_relaxed) < count / threads * threads) {
+                    if (queue.try_pop()) {
+                        received.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * count);
+}
+
+// latency: a value goes to the other thread and back
+static void bm_spsc_round_trip(benchmark::State& state) {
+    spsc_ring<int64_t> ping(16);
+    spsc_ring<int64_t> pong(16);
+    std::atomic<bool> stop{false};
+    std::thread echo([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (auto value = ping.try_pop()) {
+                while (!pong.try_push(*value)) {
+                }
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    int64_t i = 0;
+    for (auto _ : state) {
+        ping.try_push(i++);
+        while (!pong.try_pop()) {
+            std::this_thread::yield();
+        }
+    }
+    stop = true;
+    echo.join();
+}
+
+struct mutex_queue_1024 : mutex_queue<int64_t> {
+    explicit mutex_queue_1024(size_t) {}
+};
+
+BENCHMARK(bm_mutex_push_pop);
+BENCHMARK(bm_push_pop<spsc_ring<int64_t>>);
+BENCHMARK(bm_push_pop<mpmc_queue<int64_t>>);
+BENCHMARK(bm_spsc_batch_push_pop);
+BENCHMARK(bm_spsc_throughput)->Arg(1)->Arg(64)->UseRealTime();
+BENCHMARK(bm_mpmc_throughput<mutex_queue_1024>)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK(bm_mpmc_throughput<mpmc_queue<int64_t>>)->Arg(1)->Arg(2)->UseRealTime();
+BENCHMARK(bm_spsc_round_trip)->UseRealTime();
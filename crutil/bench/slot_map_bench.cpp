@@ -0,0 +1,81 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/slot_map.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace cr::util;
+
+// stands in for a GPU resource, a few raw vulkan handles
+struct resource {
+    uint64_t buffer;
+    uint64_t memory;
+    uint64_t size;
+};
+
+// a frame that references 4096 resources, the references are collected into a draw list and resolved
+static void bm_shared_ptr_frame(benchmark::State& state) {
+    std::vector<std::shared_ptr<resource>> resources;
+    for (uint64_t i = 0; i < 4096; i++) {
+        resources.push_back(std::make_shared<resource>(resource{i, i, i}));
+    }
+    std::vector<std::shared_ptr<resource>> draws;
+    for (auto _ : state) {
+        draws.clear();
+        for (const auto& r : resources) {
+            draws.push_back(r);
+        }
+        uint64_t sum = 0;
+        for (const auto& r : draws) {
+            sum += r->size;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 4096);
+}
+
+static void bm_slot_map_frame(benchmark::State& state) {
+    slot_map<resource> resources;
+    std::vector<slot_handle<resource>> handles;
+    for (uint64_t i = 0; i < 4096; i++) {
+        handles.push_back(resources.insert({i, i, i}));
+    }
+    std::vector<slot_handle<resource>> draws;
+    for (auto _ : state) {
+        draws.clear();
+        for (auto h : handles) {
+            draws.push_back(h);
+        }
+        uint64_t sum = 0;
+        for (auto h : draws) {
+            sum += resources.get(h)->size;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 4096);
+}
+
+// creating and destroying resources, the slot map reuses its slots and storage
+static void bm_shared_ptr_churn(benchmark::State& state) {
+    for (auto _ : state) {
+        auto r = std::make_shared<resource>(resource{1, 2, 3});
+        benchmark::DoNotOptimize(r.get());
+    }
+}
+
+static void bm_slot_map_churn(benchmark::State& state) {
+    slot_map<resource> resources;
+    for (auto _ : state) {
+        auto h = resources.insert({1, 2, 3});
+        benchmark::DoNotOptimize(h);
+        resources.erase(h);
+    }
+}
+
+BENCHMARK(bm_shared_ptr_frame);
+BENCHMARK(bm_slot_map_frame);
+BENCHMARK(bm_shared_ptr_churn);
+BENCHMARK(bm_slot_map_churn);
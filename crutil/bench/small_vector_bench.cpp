@@ -0,0 +1,91 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/small_vector.h"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <variant>
+#include <vector>
+
+// counts the heap allocations of the whole bench binary, the frame benches report theirs per frame
+static thread_local size_t allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// not inlined, otherwise GCC sees free() on a pointer from a new expression and warns about mismatched allocation
+[[gnu::noinline]] static void release(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p) noexcept {
+    release(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    release(p);
+}
+
+// shaped like crui's uniform and event
+struct uniform {
+    std::string name;
+    std::variant<float, std::array<float, 9>, std::array<float, 4>> value;
+};
+
+struct event {
+    int x, y, button;
+};
+
+// one frame: 200 draws with 2 to 5 uniforms each, the frame's events and a fence list for the uploads
+template<typename Uniforms, typename Events, typename Fences>
+static void frame(Events& pending) {
+    for (int draw = 0; draw < 200; draw++) {
+        Uniforms uniforms = {{"projection", std::array<float, 9>{}}, {"color", std::array<float, 4>{}}};
+        for (int extra = 0; extra < draw % 4; extra++) {
+            uniforms.push_back({"innerRadius", 0.5f});
+        }
+        benchmark::DoNotOptimize(uniforms.data());
+    }
+    for (int i = 0; i < 5; i++) {
+        pending.push_back({i, i, 0});
+    }
+    Events events = std::move(pending);
+    pending.clear();
+    benchmark::DoNotOptimize(events.data());
+    Fences fences;
+    for (int i = 0; i < 3; i++) {
+        fences.push_back(uintptr_t(i));
+    }
+    benchmark::DoNotOptimize(fences.data());
+}
+
+template<typename Uniforms, typename Events, typename Fences>
+static void bm_frame(benchmark::State& state) {
+    Events pending;
+    size_t before = allocations;
+    for (auto _ : state) {
+        frame<Uniforms, Events, Fences>(pending);
+    }
+    state.counters["allocations/frame"] = double(allocations - before) / double(state.iterations());
+}
+
+static void bm_frame_std_vector(benchmark::State& state) {
+    bm_frame<std::vector<uniform>, std::vector<event>, std::vector<uintptr_t>>(state);
+}
+
+static void bm_frame_small_vector(benchmark::State& state) {
+    using namespace cr::util;
+    bm_frame<small_vector<uniform, 6>, small_vector<event, 16>, small_vector<uintptr_t, 8>>(state);
+}
+
+BENCHMARK(bm_frame_std_vector);
+BENCHMARK(bm_frame_small_vector);
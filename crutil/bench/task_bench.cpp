@@ -0,0 +1,92 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/task.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+
+using namespace cr::util;
+
+static task<int> leaf(int i) {
+    co_return i;
+}
+
+static task<int> chain(int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += co_await leaf(i);
+    }
+    co_return sum;
+}
+
+// cost of creating and awaiting a child task
+static void bm_task_await(benchmark::State& state) {
+    scheduler s;
+    for (auto _ : state) {
+        int result = 0;
+        auto body = [&]() -> task<> { result = co_await chain(1024); };
+        s.spawn(body());
+        s.run();
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * 1024);
+}
+
+// stands in for a GPU fence, signaled a fixed time after the upload was submitted
+struct fake_fence {
+    std::chrono::steady_clock::time_point signaled;
+
+    [[nodiscard]] bool ready() const {
+        return std::chrono::steady_clock::now() >= signaled;
+    }
+};
+
+static constexpr auto upload_latency = std::chrono::microseconds(50);
+static constexpr size_t asset_count = 64;
+
+static void decode() {
+    // a few microseconds of CPU work per asset
+    volatile uint64_t x = 0;
+    for (int i = 0; i < 2000; i++) {
+        x = x + uint64_t(i) * 2654435761u;
+    }
+}
+
+// every asset is decoded on the pool, uploaded and waited for before the next one starts
+static void bm_assets_blocking(benchmark::State& state) {
+    thread_pool pool;
+    for (auto _ : state) {
+        for (size_t i = 0; i < asset_count; i++) {
+            task_group group(pool);
+            group.run(decode);
+            group.wait();
+            fake_fence fence{std::chrono::steady_clock::now() + upload_latency};
+            while (!fence.ready()) {
+            }
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(asset_count));
+}
+
+// the same loads as coroutines, decode and upload latency of different assets overlap
+static void bm_assets_scheduler(benchmark::State& state) {
+    thread_pool pool;
+    scheduler s;
+    auto load = [&]() -> task<> {
+        co_await s.offload(pool, decode);
+        fake_fence fence{std::chrono::steady_clock::now() + upload_latency};
+        co_await s.until(fence);
+    };
+    for (auto _ : state) {
+        for (size_t i = 0; i < asset_count; i++) {
+            s.spawn(load());
+        }
+        s.run();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(asset_count));
+}
+
+BENCHMARK(bm_task_await);
+BENCHMARK(bm_assets_blocking)->UseRealTime();
+BENCHMARK(bm_assets_scheduler)->UseRealTime();
@@ -0,0 +1,89 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/thread_pool.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace cr::util;
+
+static thread_pool& pool() {
+    static thread_pool instance;
+    return instance;
+}
+
+// fine grained work with uneven cost per index, a static split leaves threads idle while others finish
+static float work(size_t i) {
+    float x = float(i);
+    size_t rounds = 8 + (i * 2654435761u) % 64;
+    for (size_t k = 0; k < rounds; k++) {
+        x = std::sqrt(x + 1.0f);
+    }
+    return x;
+}
+
+static void bm_sequential(benchmark::State& state) {
+    std::vector<float> out(size_t(state.range(0)));
+    for (auto _ : state) {
+        for (size_t i = 0; i < out.size(); i++) {
+            out[i] = work(i);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// one std::thread per hardware thread, each with a contiguous slice, created for every call
+static void bm_naive_threads(benchmark::State& state) {
+    std::vector<float> out(size_t(state.range(0)));
+    size_t count = std::max(1u, std::thread::hardware_concurrency());
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < count; t++) {
+            threads.emplace_back([&, t] {
+                size_t begin = out.size() * t / count;
+                size_t end = out.size() * (t + 1) / count;
+                for (size_t i = begin; i < end; i++) {
+                    out[i] = work(i);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_parallel_for(benchmark::State& state) {
+    std::vector<float> out(size_t(state.range(0)));
+    auto grain = size_t(state.range(1));
+    for (auto _ : state) {
+        parallel_for(pool(), 0, out.size(), grain, [&](size_t i) { out[i] = work(i); });
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+// overhead of a task_group with many empty tasks spawned from inside the pool
+static void bm_task_spawn(benchmark::State& state) {
+    for (auto _ : state) {
+        task_group group(pool());
+        group.run([&] {
+            for (int64_t i = 0; i < state.range(0); i++) {
+                group.run([] {});
+            }
+        });
+        group.wait();
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_sequential)->Arg(1 << 12)->Arg(1 << 18);
+BENCHMARK(bm_naive_threads)->Arg(1 << 12)->Arg(1 << 18)->UseRealTime();
+BENCHMARK(bm_parallel_for)->Args({1 << 12, 64})->Args({1 << 18, 64})->Args({1 << 18, 1024})->UseRealTime();
+BENCHMARK(bm_task_spawn)->Arg(10000)->UseRealTime();
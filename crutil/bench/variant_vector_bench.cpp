@@ -0,0 +1,99 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/overload.h"
+#include "crutil/variant_vector.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <variant>
+#include <vector>
+
+using namespace cr::util;
+
+// shapes of different sizes like the ones in crui, so a vector of the variant wastes space on the small ones
+struct circle {
+    float x, y, radius;
+};
+
+struct rectangle {
+    float x, y, width, height;
+};
+
+struct line {
+    float x0, y0, x1, y1, width;
+    float color[4];
+};
+
+using shape = std::variant<circle, rectangle, line>;
+
+static auto area = overloaded{
+        [](const circle& c) { return 3.14159f * c.radius * c.radius; },
+        [](const rectangle& r) { return r.width * r.height; },
+        [](const line& l) { return (l.x1 - l.x0 + l.y1 - l.y0) * l.width; }};
+
+static std::vector<shape> random_shapes(size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> type(0, 2);
+    std::uniform_real_distribution<float> value(0, 100);
+    std::vector<shape> shapes;
+    for (size_t i = 0; i < count; i++) {
+        switch (type(rng)) {
+            case 0:
+                shapes.emplace_back(circle{value(rng), value(rng), value(rng)});
+                break;
+            case 1:
+                shapes.emplace_back(rectangle{value(rng), value(rng), value(rng), value(rng)});
+                break;
+            default:
+                shapes.emplace_back(line{value(rng), value(rng), value(rng), value(rng), value(rng), {}});
+        }
+    }
+    return shapes;
+}
+
+static void bm_vector_of_variant(benchmark::State& state) {
+    auto shapes = random_shapes(size_t(state.range(0)));
+    for (auto _ : state) {
+        float sum = 0;
+        for (const auto& s : shapes) {
+            sum += std::visit(area, s);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_variant_vector_for_each(benchmark::State& state) {
+    variant_vector_for<shape> shapes;
+    for (auto& s : random_shapes(size_t(state.range(0)))) {
+        shapes.push_back(std::move(s));
+    }
+    for (auto _ : state) {
+        float sum = 0;
+        shapes.for_each([&](const auto& s) { sum += area(s); });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_variant_vector_for_each_type(benchmark::State& state) {
+    variant_vector_for<shape> shapes;
+    for (auto& s : random_shapes(size_t(state.range(0)))) {
+        shapes.push_back(std::move(s));
+    }
+    for (auto _ : state) {
+        float sum = 0;
+        shapes.for_each_type([&](auto span) {
+            for (const auto& s : span) {
+                sum += area(s);
+            }
+        });
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_vector_of_variant)->Arg(100000);
+BENCHMARK(bm_variant_vector_for_each)->Arg(100000);
+BENCHMARK(bm_variant_vector_for_each_type)->Arg(100000);
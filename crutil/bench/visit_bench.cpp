@@ -0,0 +1,103 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "crutil/overload.h"
+#include "crutil/visit.h"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+// ten alternatives of different sizes, shaped like crui's uniform_value
+using value = std::variant<float, int, bool, std::array<float, 16>, std::array<float, 9>, std::array<float, 4>,
+                           std::array<float, 2>, std::array<float, 3>, std::array<double, 4>, std::shared_ptr<int>>;
+
+static std::vector<value> random_values(size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<size_t> type(0, std::variant_size_v<value> - 1);
+    std::vector<value> values;
+    for (size_t i = 0; i < count; i++) {
+        switch (type(rng)) {
+            case 0: values.emplace_back(1.5f); break;
+            case 1: values.emplace_back(2); break;
+            case 2: values.emplace_back(true); break;
+            case 3: values.emplace_back(std::array<float, 16>{1}); break;
+            case 4: values.emplace_back(std::array<float, 9>{2}); break;
+            case 5: values.emplace_back(std::array<float, 4>{3}); break;
+            case 6: values.emplace_back(std::array<float, 2>{4}); break;
+            case 7: values.emplace_back(std::array<float, 3>{5}); break;
+            case 8: values.emplace_back(std::array<double, 4>{6}); break;
+            default: values.emplace_back(std::make_shared<int>(7));
+        }
+    }
+    return values;
+}
+
+static auto first = cr::util::overloaded{
+        [](float v) { return double(v); },
+        [](int v) { return double(v); },
+        [](bool v) { return double(v); },
+        [](const std::shared_ptr<int>& v) { return double(*v); },
+        [](const auto& v) { return double(v[0]); }};
+
+// the second variant only carries an argument, like the matrix in crui's draw
+static auto scaled = cr::util::overloaded{
+        [](const auto& v, double factor) { return first(v) * factor; }};
+
+static void bm_std_visit(benchmark::State& state) {
+    auto values = random_values(size_t(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto& v : values) {
+            sum += std::visit(first, v);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_cr_visit(benchmark::State& state) {
+    auto values = random_values(size_t(state.range(0)));
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto& v : values) {
+            sum += cr::util::visit(first, v);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_std_visit_two(benchmark::State& state) {
+    auto values = random_values(size_t(state.range(0)));
+    std::variant<double> factor(0.5);
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto& v : values) {
+            sum += std::visit(scaled, v, factor);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void bm_cr_visit_two(benchmark::State& state) {
+    auto values = random_values(size_t(state.range(0)));
+    std::variant<double> factor(0.5);
+    for (auto _ : state) {
+        double sum = 0;
+        for (const auto& v : values) {
+            sum += cr::util::visit(scaled, v, factor);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+BENCHMARK(bm_std_visit)->Arg(10000);
+BENCHMARK(bm_cr_visit)->Arg(10000);
+BENCHMARK(bm_std_visit_two)->Arg(10000);
+BENCHMARK(bm_cr_visit_two)->Arg(10000);
@@ -0,0 +1,233 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace cr::util {
+
+struct arena_stats {
+    size_t bytes = 0;
+    size_t allocations = 0;
+};
+
+/**
+ * @brief monotonic memory resource, allocating is a pointer bump and everything is freed at once by reset()
+ * @details memory comes from blocks of the upstream resource which are kept across resets, so a frame that allocates
+ * no more than the previous ones does not touch the upstream resource. Deallocating only gives memory back if it was
+ * the latest allocation, i.e. for temporaries freed in reverse order. Not thread safe.
+ * @code
+ * cr::util::frame_arena frame;
+ * while (running) {
+ *     auto last = frame.reset();
+ *     std::pmr::vector<geometry> list(&frame);
+ *     ...
+ * }
+ * @endcode
+ */
+class frame_arena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief position in the arena, rewinding to it frees everything allocated after mark() returned it
+     */
+    struct marker {
+        size_t block;
+        size_t offset;
+    };
+
+    explicit frame_arena(size_t initial_size = 64 * 1024,
+                         std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : next_size(std::max<size_t>(initial_size, 64)), upstream(upstream) {}
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    ~frame_arena() override {
+        release();
+    }
+
+    /**
+     * @brief frees everything and starts counting the next frame
+     * @details if the last frame needed more than one block they are merged into one, so the steady state is a single
+     * block
+     * @return the stats of the frame that ended
+     */
+    arena_stats reset() {
+        if (blocks.size() > 1) {
+            size_t total = capacity();
+            release();
+            add_block(total);
+        }
+        rewind({0, 0});
+        return reset_stats();
+    }
+
+    /**
+     * @brief returns the stats since the last reset and zeroes them, without freeing anything
+     */
+    arena_stats reset_stats() {
+        auto res = counters;
+        counters = {};
+        return res;
+    }
+
+    /**
+     * @brief bytes and allocations since the last reset, deallocations are not subtracted
+     */
+    [[nodiscard]] const arena_stats& stats() const {
+        return counters;
+    }
+
+    /**
+     * @brief bytes held from the upstream resource
+     */
+    [[nodiscard]] size_t capacity() const {
+        size_t res = 0;
+        for (const auto& b : blocks) {
+            res += b.size;
+        }
+        return res;
+    }
+
+    [[nodiscard]] marker mark() const {
+        return {current, offset};
+    }
+
+    void rewind(marker m) {
+        current = m.block;
+        offset = m.offset;
+    }
+
+    /**
+     * @brief returns all blocks to the upstream resource
+     */
+    void release() {
+        for (const auto& b : blocks) {
+            upstream->deallocate(b.data, b.size, alignof(std::max_align_t));
+        }
+        blocks.clear();
+        current = 0;
+        offset = 0;
+    }
+
+private:
+    struct block {
+        std::byte* data;
+        size_t size;
+    };
+
+    void add_block(size_t size) {
+        blocks.push_back({static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t))), size});
+        next_size = std::max(next_size, size * 2);
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        counters.bytes += bytes;
+        counters.allocations++;
+        while (true) {
+            if (current < blocks.size()) {
+                auto& b = blocks[current];
+                auto base = reinterpret_cast<uintptr_t>(b.data);
+                size_t start = ((base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+                if (start + bytes <= b.size) {
+                    offset = start + bytes;
+                    return b.data + start;
+                }
+                if (current + 1 < blocks.size()) {
+                    current++;
+                    offset = 0;
+                    continue;
+                }
+            }
+            // the remaining blocks are too small, they are used again after the next reset or rewind
+            add_block(std::max(next_size, bytes + alignment));
+            current = blocks.size() - 1;
+            offset = 0;
+        }
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t) override {
+        if (current < blocks.size() && static_cast<std::byte*>(p) + bytes == blocks[current].data + offset) {
+            offset -= bytes;
+        }
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    std::vector<block> blocks;
+    size_t current = 0;
+    size_t offset = 0;
+    size_t next_size;
+    std::pmr::memory_resource* upstream;
+    arena_stats counters;
+};
+
+/**
+ * @brief memory resource for temporaries on a thread local stack, everything allocated through it is freed when it is
+ * destroyed
+ * @details scratches nest like the scopes they live in. Only the innermost scratch of a thread may allocate, otherwise
+ * its memory would be freed with the inner one.
+ * @code
+ * cr::util::scratch scratch;
+ * std::pmr::vector<uint32_t> visible(&scratch);
+ * @endcode
+ */
+class scratch : public std::pmr::memory_resource {
+public:
+    scratch() : state(local()), start(state.arena.mark()), depth(++state.depth) {}
+
+    scratch(const scratch&) = delete;
+    scratch& operator=(const scratch&) = delete;
+
+    ~scratch() override {
+        assert(state.depth == depth && "scratch destroyed out of order");
+        state.arena.rewind(start);
+        state.depth--;
+    }
+
+    /**
+     * @brief the arena behind the scratches of the calling thread, e.g. to read its stats once per frame
+     */
+    static frame_arena& arena() {
+        return local().arena;
+    }
+
+private:
+    struct thread_state {
+        frame_arena arena;
+        size_t depth = 0;
+    };
+
+    static thread_state& local() {
+        thread_local thread_state state;
+        return state;
+    }
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        assert(state.depth == depth && "only the innermost scratch may allocate");
+        return state.arena.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        state.arena.deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    thread_state& state;
+    frame_arena::marker start;
+    size_t depth;
+};
+
+}// namespace cr::util
@@ -12,4 +12,11 @@ constexpr bool debug = true;
 constexpr bool debug = false;
 #endif
 
+// set by cmake -DCRLIB_TRACE=ON, see crutil/trace.h
+#ifdef CR_TRACE
+constexpr bool trace = true;
+#else
+constexpr bool trace = false;
+#endif
+
 }// namespace cr::compiletime
\ No newline at end of file
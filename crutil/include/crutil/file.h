@@ -0,0 +1,658 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#define CR_FILE_IO_URING
+#endif
+
+namespace cr::util {
+
+/**
+ * @brief views bytes as an array of T
+ * @details throws if the bytes are not aligned for T or their size is not a multiple of sizeof(T)
+ */
+template<typename T>
+[[nodiscard]] std::span<const T> view_as(std::span<const std::byte> bytes) {
+    if (bytes.size() % sizeof(T) != 0 || reinterpret_cast<uintptr_t>(bytes.data()) % alignof(T) != 0) {
+        throw std::runtime_error("bytes are not an aligned array of the requested type");
+    }
+    return {reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T)};
+}
+
+namespace impl {
+
+inline std::runtime_error file_error(const char* what, const std::filesystem::path& path, int error) {
+    return std::runtime_error(std::string(what) + " " + path.string() + ": " + std::strerror(error));
+}
+
+class file_descriptor {
+public:
+    explicit file_descriptor(const std::filesystem::path& path) : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)) {
+        if (fd < 0) {
+            throw file_error("failed to open", path, errno);
+        }
+        struct stat info {};
+        if (::fstat(fd, &info) != 0) {
+            int error = errno;
+            ::close(fd);
+            throw file_error("failed to stat", path, error);
+        }
+        length = size_t(info.st_size);
+    }
+
+    file_descriptor(const file_descriptor&) = delete;
+    file_descriptor& operator=(const file_descriptor&) = delete;
+
+    ~file_descriptor() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+
+    [[nodiscard]] int get() const {
+        return fd;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return length;
+    }
+
+    int release() {
+        return std::exchange(fd, -1);
+    }
+
+private:
+    int fd;
+    size_t length = 0;
+};
+
+}// namespace impl
+
+/**
+ * @brief read only mapping of a whole file
+ * @details the pages are populated up front, so reading through bytes() does not fault into the kernel for every page.
+ * The mapping starts on a page boundary, so view_as<uint32_t>(bytes()) works for SPIR-V and similar formats.
+ */
+class mapped_file {
+public:
+    mapped_file() = default;
+
+    explicit mapped_file(const std::filesystem::path& path) {
+        impl::file_descriptor fd(path);
+        length = fd.size();
+        if (length == 0) {
+            return;
+        }
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        void* mapping = ::mmap(nullptr, length, PROT_READ, flags, fd.get(), 0);
+        if (mapping == MAP_FAILED) {
+            throw impl::file_error("failed to map", path, errno);
+        }
+        address = static_cast<const std::byte*>(mapping);
+    }
+
+    mapped_file(mapped_file&& other) noexcept
+        : address(std::exchange(other.address, nullptr)), length(std::exchange(other.length, 0)) {}
+
+    mapped_file& operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            address = std::exchange(other.address, nullptr);
+            length = std::exchange(other.length, 0);
+        }
+        return *this;
+    }
+
+    ~mapped_file() {
+        unmap();
+    }
+
+    [[nodiscard]] std::span<const std::byte> bytes() const {
+        return {address, length};
+    }
+
+    [[nodiscard]] const std::byte* data() const {
+        return address;
+    }
+
+    [[nodiscard]] size_t size() const {
+        return length;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return length == 0;
+    }
+
+private:
+    void unmap() {
+        if (address != nullptr) {
+            ::munmap(const_cast<std::byte*>(address), length);
+        }
+    }
+
+    const std::byte* address = nullptr;
+    size_t length = 0;
+};
+
+/**
+ * @brief owned contents of a file
+ * @details the storage is left uninitialized until the file is read into it and is aligned for every scalar type.
+ */
+class file_buffer {
+public:
+    file_buffer() = default;
+
+    explicit file_buffer(size_t size) : storage(size != 0 ? new std::byte[size] : nullptr), length(size) {}
+
+    [[nodiscard]] std::span<const std::byte> bytes() const {
+        return {storage.get(), length};
+    }
+
+    [[nodiscard]] std::byte* data() {
+        return storage.get();
+    }
+
+    [[nodiscard]] const std::byte* data() const {
+        return storage.get();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return length;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return length == 0;
+    }
+
+private:
+    std::unique_ptr<std::byte[]> storage;
+    size_t length = 0;
+};
+
+namespace impl {
+
+// reads the rest of the file with as few syscalls as the kernel allows, returns 0 or an errno value
+inline int read_fully(int fd, std::byte* data, size_t size) {
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = ::pread(fd, data + done, size - done, off_t(done));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno;
+        }
+        if (n == 0) {
+            // the file shrank after it was opened
+            return EIO;
+        }
+        done += size_t(n);
+    }
+    return 0;
+}
+
+}// namespace impl
+
+/**
+ * @brief reads a whole file into a buffer, usually with a single read
+ */
+inline file_buffer read_file(const std::filesystem::path& path) {
+    impl::file_descriptor fd(path);
+    file_buffer buffer(fd.size());
+    if (int error = impl::read_fully(fd.get(), buffer.data(), buffer.size()); error != 0) {
+        throw impl::file_error("failed to read", path, error);
+    }
+    return buffer;
+}
+
+class file_reader;
+class file_batch;
+
+namespace impl {
+
+class io_uring_queue;
+
+struct file_batch_state;
+
+struct file_read {
+    file_batch_state* batch = nullptr;
+    size_t index = 0;
+    int fd = -1;
+    size_t done = 0;
+    iovec chunk{};
+};
+
+struct file_batch_state {
+    std::vector<std::filesystem::path> paths;
+    std::vector<file_buffer> files;
+    std::vector<file_read> reads;
+    std::atomic<size_t> remaining{0};
+    std::mutex error_mutex;
+    std::string error;
+    io_uring_queue* ring = nullptr;
+    // declared last so it is destroyed first, its destructor waits for the tasks still using this state
+    std::unique_ptr<task_group> group;
+
+    void fail(file_read& read, const char* what, int code) {
+        {
+            std::lock_guard lock(error_mutex);
+            if (error.empty()) {
+                error = file_error(what, paths[read.index], code).what();
+            }
+        }
+        finish(read);
+    }
+
+    void finish(file_read& read) {
+        if (read.fd >= 0) {
+            ::close(std::exchange(read.fd, -1));
+        }
+        remaining.fetch_sub(1, std::memory_order_release);
+    }
+
+    // opens the file and sizes its buffer, returns false if the read is already over
+    bool open(file_read& read) {
+        try {
+            file_descriptor fd(paths[read.index]);
+            files[read.index] = file_buffer(fd.size());
+            read.fd = fd.release();
+        } catch (const std::exception& e) {
+            {
+                std::lock_guard lock(error_mutex);
+                if (error.empty()) {
+                    error = e.what();
+                }
+            }
+            finish(read);
+            return false;
+        }
+        if (files[read.index].empty()) {
+            finish(read);
+            return false;
+        }
+        return true;
+    }
+
+    void read_blocking(file_read& read) {
+        if (!open(read)) {
+            return;
+        }
+        auto& file = files[read.index];
+        if (int code = read_fully(read.fd, file.data(), file.size()); code != 0) {
+            fail(read, "failed to read", code);
+        } else {
+            finish(read);
+        }
+    }
+};
+
+#ifdef CR_FILE_IO_URING
+
+/**
+ * @brief submission and completion rings of one io_uring, driven by whoever waits on a batch
+ * @details reads beyond the ring size wait in a queue until earlier reads complete, so the completion ring never
+ * overflows. Not thread safe.
+ */
+class io_uring_queue {
+public:
+    // nullptr if the kernel has no io_uring or does not allow this process to use it
+    static std::unique_ptr<io_uring_queue> create(unsigned entries, size_t max_read) {
+        io_uring_params params{};
+        int fd = int(::syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0) {
+            return nullptr;
+        }
+        std::unique_ptr<io_uring_queue> queue(new io_uring_queue(fd, max_read));
+        queue->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        queue->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        queue->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        queue->sq_ring = map(fd, queue->sq_ring_size, IORING_OFF_SQ_RING);
+        queue->cq_ring = map(fd, queue->cq_ring_size, IORING_OFF_CQ_RING);
+        queue->sqes = static_cast<io_uring_sqe*>(map(fd, queue->sqes_size, IORING_OFF_SQES));
+        if (queue->sq_ring == nullptr || queue->cq_ring == nullptr || queue->sqes == nullptr) {
+            return nullptr;
+        }
+        auto* sq = static_cast<std::byte*>(queue->sq_ring);
+        auto* cq = static_cast<std::byte*>(queue->cq_ring);
+        queue->sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        queue->sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        queue->sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        queue->sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        queue->cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        queue->cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        queue->cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        queue->cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        queue->capacity = params.sq_entries;
+        return queue;
+    }
+
+    io_uring_queue(const io_uring_queue&) = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    ~io_uring_queue() {
+        if (sqes != nullptr) {
+            ::munmap(sqes, sqes_size);
+        }
+        if (cq_ring != nullptr) {
+            ::munmap(cq_ring, cq_ring_size);
+        }
+        if (sq_ring != nullptr) {
+            ::munmap(sq_ring, sq_ring_size);
+        }
+        ::close(fd);
+    }
+
+    void push(file_read* read) {
+        pending.push_back(read);
+    }
+
+    /**
+     * @brief submits queued reads and handles the completed ones
+     * @details with wait set, blocks until at least one read completes if any is in flight. Returns the number of
+     * completions handled, 0 after a wait only if the kernel was interrupted or refused with EAGAIN or EBUSY.
+     */
+    unsigned poll(bool wait) {
+        unsigned tail = *sq_tail;
+        while (!pending.empty() && in_flight < capacity) {
+            file_read* read = pending.front();
+            pending.pop_front();
+            auto& file = read->batch->files[read->index];
+            read->chunk.iov_base = file.data() + read->done;
+            // reads are capped at max_read and the kernel returns at most about 2 GiB, larger files take several
+            read->chunk.iov_len = std::min(file.size() - read->done, max_read);
+            unsigned slot = tail & sq_mask;
+            io_uring_sqe& sqe = sqes[slot];
+            std::memset(&sqe, 0, sizeof(sqe));
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = read->fd;
+            sqe.off = read->done;
+            sqe.addr = reinterpret_cast<uint64_t>(&read->chunk);
+            sqe.len = 1;
+            sqe.user_data = reinterpret_cast<uint64_t>(read);
+            sq_array[slot] = slot;
+            tail++;
+            in_flight++;
+        }
+        std::atomic_ref(*sq_tail).store(tail, std::memory_order_release);
+
+        unsigned submit = tail - std::atomic_ref(*sq_head).load(std::memory_order_acquire);
+        bool block = wait && in_flight != 0;
+        if (submit != 0 || block) {
+            unsigned flags = block ? IORING_ENTER_GETEVENTS : 0;
+            if (::syscall(__NR_io_uring_enter, fd, submit, block ? 1 : 0, flags, nullptr, 0) < 0 && errno != EINTR &&
+                errno != EAGAIN && errno != EBUSY) {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+            }
+        }
+
+        unsigned head = *cq_head;
+        unsigned end = std::atomic_ref(*cq_tail).load(std::memory_order_acquire);
+        unsigned completed = end - head;
+        while (head != end) {
+            const io_uring_cqe& cqe = cqes[head & cq_mask];
+            auto* read = reinterpret_cast<file_read*>(cqe.user_data);
+            int result = cqe.res;
+            head++;
+            in_flight--;
+            complete(*read, result);
+        }
+        std::atomic_ref(*cq_head).store(head, std::memory_order_release);
+        return completed;
+    }
+
+private:
+    io_uring_queue(int fd, size_t max_read) : fd(fd), max_read(max_read) {}
+
+    static void* map(int fd, size_t size, off_t offset) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return mapping == MAP_FAILED ? nullptr : mapping;
+    }
+
+    void complete(file_read& read, int result) {
+        auto& batch = *read.batch;
+        if (result == -EINTR || result == -EAGAIN) {
+            pending.push_back(&read);
+        } else if (result < 0) {
+            batch.fail(read, "failed to read", -result);
+        } else if (result == 0) {
+            batch.fail(read, "failed to read", EIO);
+        } else if ((read.done += size_t(result)) < batch.files[read.index].size()) {
+            pending.push_back(&read);
+        } else {
+            batch.finish(read);
+        }
+    }
+
+    int fd;
+    size_t max_read;
+    void* sq_ring = nullptr;
+    void* cq_ring = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sq_ring_size = 0;
+    size_t cq_ring_size = 0;
+    size_t sqes_size = 0;
+    unsigned* sq_head = nullptr;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned sq_mask = 0;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cq_mask = 0;
+    unsigned capacity = 0;
+    unsigned in_flight = 0;
+    std::deque<file_read*> pending;
+};
+
+#else
+
+class io_uring_queue {
+public:
+    static std::unique_ptr<io_uring_queue> create(unsigned, size_t) {
+        return nullptr;
+    }
+
+    void push(file_read*) {}
+
+    unsigned poll(bool) {
+        return 0;
+    }
+};
+
+#endif
+
+}// namespace impl
+
+/**
+ * @brief files being read by a file_reader
+ * @details destroying a batch waits for its reads, the buffers must not go away while the kernel writes into them.
+ */
+class file_batch {
+public:
+    file_batch(file_batch&&) noexcept = default;
+
+    file_batch& operator=(file_batch&& other) noexcept {
+        if (this != &other) {
+            drain();
+            state = std::move(other.state);
+        }
+        return *this;
+    }
+
+    ~file_batch() {
+        drain();
+    }
+
+    /**
+     * @brief true once every file is read, does not block
+     */
+    [[nodiscard]] bool ready() {
+        if (state->ring != nullptr) {
+            state->ring->poll(false);
+        }
+        return state->remaining.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * @brief blocks until every file is read
+     * @details throws std::runtime_error naming the first file that could not be read. A thread pool batch lets the
+     * waiting thread run tasks, an io_uring batch submits and completes reads on the waiting thread. Also throws if
+     * the io_uring keeps refusing to make progress.
+     */
+    void wait() {
+        if (state->group) {
+            state->group->wait();
+        }
+        // the kernel may refuse io_uring_enter for a moment with EAGAIN or EBUSY, give it time but not forever
+        int idle = 0;
+        while (state->remaining.load(std::memory_order_acquire) != 0) {
+            if (state->ring->poll(true) != 0) {
+                idle = 0;
+            } else if (++idle == max_idle_polls) {
+                throw std::runtime_error("io_uring stopped completing reads");
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        if (!state->error.empty()) {
+            throw std::runtime_error(state->error);
+        }
+    }
+
+    [[nodiscard]] size_t size() const {
+        return state->files.size();
+    }
+
+    /**
+     * @brief contents of the i-th file, only valid after wait() succeeded
+     */
+    [[nodiscard]] const file_buffer& operator[](size_t i) const {
+        return state->files[i];
+    }
+
+    /**
+     * @brief moves the contents of all files out of the batch, only valid after wait() succeeded
+     */
+    [[nodiscard]] std::vector<file_buffer> release() {
+        return std::move(state->files);
+    }
+
+private:
+    friend class file_reader;
+
+    static constexpr int max_idle_polls = 100;
+
+    explicit file_batch(std::unique_ptr<impl::file_batch_state> state) : state(std::move(state)) {}
+
+    void drain() {
+        if (state && state->remaining.load(std::memory_order_acquire) != 0) {
+            try {
+                wait();
+            } catch (...) {
+            }
+            if (state->remaining.load(std::memory_order_acquire) != 0) {
+                // the ring gave up with reads in flight, leaking them is better than the kernel writing into freed memory
+                (void) state.release();
+            }
+        }
+    }
+
+    std::unique_ptr<impl::file_batch_state> state;
+};
+
+struct file_reader_options {
+    // reads in flight at once on the io_uring
+    unsigned queue_depth = 64;
+    // false always reads on the thread pool
+    bool io_uring = true;
+    // largest single read on the io_uring, larger files are read in several parts
+    size_t max_read = size_t(1) << 30;
+};
+
+/**
+ * @brief reads batches of whole files asynchronously
+ * @details uses an io_uring when the kernel provides one, otherwise every file is read by a task on the thread pool.
+ * Files are opened when the batch is started, io_uring batches progress whenever ready() or wait() is called on a
+ * batch of the same reader. The reader has to outlive its batches and is not thread safe in io_uring mode.
+ */
+class file_reader {
+public:
+    explicit file_reader(thread_pool& pool, const file_reader_options& options = {}) : pool(pool) {
+        if (options.io_uring) {
+            ring = impl::io_uring_queue::create(options.queue_depth, std::max<size_t>(options.max_read, 1));
+        }
+    }
+
+    file_reader(const file_reader&) = delete;
+    file_reader& operator=(const file_reader&) = delete;
+
+    [[nodiscard]] file_batch read(std::vector<std::filesystem::path> paths) {
+        auto state = std::make_unique<impl::file_batch_state>();
+        state->paths = std::move(paths);
+        state->files.resize(state->paths.size());
+        state->reads.resize(state->paths.size());
+        state->remaining.store(state->paths.size(), std::memory_order_relaxed);
+        for (size_t i = 0; i < state->reads.size(); i++) {
+            state->reads[i].batch = state.get();
+            state->reads[i].index = i;
+        }
+        if (ring) {
+            state->ring = ring.get();
+            for (auto& read : state->reads) {
+                if (state->open(read)) {
+                    ring->push(&read);
+                }
+            }
+            ring->poll(false);
+        } else {
+            state->group = std::make_unique<task_group>(pool);
+            for (auto& read : state->reads) {
+                state->group->run([&batch = *state, &read] { batch.read_blocking(read); });
+            }
+        }
+        return file_batch(std::move(state));
+    }
+
+    [[nodiscard]] bool uses_io_uring() const {
+        return ring != nullptr;
+    }
+
+private:
+    thread_pool& pool;
+    std::unique_ptr<impl::io_uring_queue> ring;
+};
+
+}// namespace cr::util
@@ -0,0 +1,522 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CR_FLAT_HASH_MAP_SSE2
+#endif
+
+namespace cr::util {
+
+namespace impl {
+
+// control byte of a slot: the low 7 hash bits while it is full, otherwise one of these
+enum class ctrl : int8_t {
+    empty = -128,
+    deleted = -2
+};
+
+inline constexpr size_t group_width = 16;
+
+// bit i is set for every slot i of the group that matched
+class group_mask {
+public:
+    explicit group_mask(uint32_t bits) : bits(bits) {}
+
+    explicit operator bool() const {
+        return bits != 0;
+    }
+
+    [[nodiscard]] size_t lowest() const {
+        return size_t(std::countr_zero(bits));
+    }
+
+    group_mask& operator++() {
+        bits &= bits - 1;
+        return *this;
+    }
+
+private:
+    uint32_t bits;
+};
+
+// the control bytes of group_width slots, compared all at once
+class group {
+public:
+    explicit group(const int8_t* ctrl) {
+#ifdef CR_FLAT_HASH_MAP_SSE2
+        bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+        std::memcpy(bytes, ctrl, group_width);
+#endif
+    }
+
+    [[nodiscard]] group_mask match(int8_t h2) const {
+#ifdef CR_FLAT_HASH_MAP_SSE2
+        return group_mask(uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), bytes))));
+#else
+        return scalar_match([=](int8_t c) { return c == h2; });
+#endif
+    }
+
+    [[nodiscard]] group_mask match_empty() const {
+        return match(int8_t(ctrl::empty));
+    }
+
+    [[nodiscard]] group_mask match_empty_or_deleted() const {
+#ifdef CR_FLAT_HASH_MAP_SSE2
+        // full bytes are >= 0, empty and deleted are < -1
+        return group_mask(uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), bytes))));
+#else
+        return scalar_match([](int8_t c) { return c < -1; });
+#endif
+    }
+
+private:
+#ifdef CR_FLAT_HASH_MAP_SSE2
+    __m128i bytes;
+#else
+    template<typename F>
+    group_mask scalar_match(F f) const {
+        uint32_t bits = 0;
+        for (size_t i = 0; i < group_width; i++) {
+            bits |= uint32_t(f(bytes[i])) << i;
+        }
+        return group_mask(bits);
+    }
+
+    int8_t bytes[group_width];
+#endif
+};
+
+// spreads the bits of hashes like std::hash<int>, which is the identity, over the whole word
+inline size_t mix_hash(size_t hash) {
+    uint64_t h = uint64_t(hash) * 0x9e3779b97f4a7c15;
+    return size_t(h ^ (h >> 32));
+}
+
+}// namespace impl
+
+/**
+ * @brief open addressing hash map in the style of Abseil's SwissTable
+ * @details the slots are stored flat with one control byte each that holds 7 bits of the key's hash. A lookup compares
+ * the control bytes of 16 slots at once (SSE2 where available) and only touches the slots whose bytes match, so a miss
+ * rarely reads a key at all. The API follows std::unordered_map, but every insert may move the values: iterators,
+ * pointers and references are invalidated by inserts that grow the map and by rehash/reserve.
+ */
+template<typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class flat_hash_map {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<const K, V>;
+    using size_type = size_t;
+
+    template<bool Const>
+    class iterator_impl {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = flat_hash_map::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        iterator_impl() = default;
+
+        // iterator converts to const_iterator, a template so that it is never the copy constructor
+        template<bool C = Const>
+            requires C
+        iterator_impl(const iterator_impl<false>& other) : ctrl(other.ctrl), slot(other.slot), end(other.end) {}
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        iterator_impl& operator++() {
+            ++ctrl;
+            ++slot;
+            skip_free();
+            return *this;
+        }
+
+        iterator_impl operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(const iterator_impl& a, const iterator_impl& b) {
+            return a.ctrl == b.ctrl;
+        }
+
+    private:
+        friend class flat_hash_map;
+        friend class iterator_impl<!Const>;
+
+        iterator_impl(const int8_t* ctrl, pointer slot, const int8_t* end) : ctrl(ctrl), slot(slot), end(end) {
+            skip_free();
+        }
+
+        struct full_tag {};
+
+        // ctrl is known to be full, no need to skip
+        iterator_impl(const int8_t* ctrl, pointer slot, const int8_t* end, full_tag) : ctrl(ctrl), slot(slot), end(end) {}
+
+        void skip_free() {
+            while (ctrl != end && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+            }
+        }
+
+        const int8_t* ctrl = nullptr;
+        pointer slot = nullptr;
+        const int8_t* end = nullptr;
+    };
+
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+
+    flat_hash_map() = default;
+
+    flat_hash_map(std::initializer_list<value_type> values) {
+        reserve(values.size());
+        for (const auto& value : values) {
+            insert(value);
+        }
+    }
+
+    flat_hash_map(const flat_hash_map& other) : hasher(other.hasher), eq(other.eq) {
+        reserve(other.size());
+        for (const auto& value : other) {
+            insert_unique(value.first, value.second);
+        }
+    }
+
+    flat_hash_map(flat_hash_map&& other) noexcept
+        : ctrl_bytes(std::exchange(other.ctrl_bytes, nullptr)), slots(std::exchange(other.slots, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)), size_(std::exchange(other.size_, 0)),
+          growth_left(std::exchange(other.growth_left, 0)), hasher(std::move(other.hasher)), eq(std::move(other.eq)) {}
+
+    flat_hash_map& operator=(const flat_hash_map& other) {
+        if (this != &other) {
+            flat_hash_map copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    flat_hash_map& operator=(flat_hash_map&& other) noexcept {
+        if (this != &other) {
+            destroy();
+            flat_hash_map moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~flat_hash_map() {
+        destroy();
+    }
+
+    void swap(flat_hash_map& other) noexcept {
+        std::swap(ctrl_bytes, other.ctrl_bytes);
+        std::swap(slots, other.slots);
+        std::swap(capacity_, other.capacity_);
+        std::swap(size_, other.size_);
+        std::swap(growth_left, other.growth_left);
+        std::swap(hasher, other.hasher);
+        std::swap(eq, other.eq);
+    }
+
+    [[nodiscard]] iterator begin() { return {ctrl_bytes, slots, ctrl_bytes + capacity_}; }
+    [[nodiscard]] const_iterator begin() const { return {ctrl_bytes, slots, ctrl_bytes + capacity_}; }
+    [[nodiscard]] iterator end() { return {ctrl_bytes + capacity_, slots + capacity_, ctrl_bytes + capacity_}; }
+    [[nodiscard]] const_iterator end() const { return {ctrl_bytes + capacity_, slots + capacity_, ctrl_bytes + capacity_}; }
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    [[nodiscard]] iterator find(const K& key) {
+        size_t index = find_index(key);
+        return index == npos ? end() : iterator_at(index);
+    }
+
+    [[nodiscard]] const_iterator find(const K& key) const {
+        size_t index = find_index(key);
+        return index == npos ? end() : const_iterator(ctrl_bytes + index, slots + index, ctrl_bytes + capacity_, {});
+    }
+
+    [[nodiscard]] bool contains(const K& key) const {
+        return find_index(key) != npos;
+    }
+
+    [[nodiscard]] size_t count(const K& key) const {
+        return contains(key) ? 1 : 0;
+    }
+
+    [[nodiscard]] V& at(const K& key) {
+        size_t index = find_index(key);
+        if (index == npos) {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return slots[index].second;
+    }
+
+    [[nodiscard]] const V& at(const K& key) const {
+        size_t index = find_index(key);
+        if (index == npos) {
+            throw std::out_of_range("flat_hash_map::at");
+        }
+        return slots[index].second;
+    }
+
+    V& operator[](const K& key) {
+        return try_emplace(key).first->second;
+    }
+
+    /**
+     * @brief inserts (key, V(args...)) if key is missing, args are not touched otherwise
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        size_t hash = hash_of(key);
+        if (size_t index = find_index(key, hash); index != npos) {
+            return {iterator_at(index), false};
+        }
+        size_t index = prepare_insert(hash);
+        std::construct_at(slots + index, std::piecewise_construct, std::forward_as_tuple(key),
+                          std::forward_as_tuple(std::forward<Args>(args)...));
+        commit_insert(index, hash);
+        return {iterator_at(index), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return try_emplace(value.first, value.second);
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto res = try_emplace(key, std::forward<M>(value));
+        if (!res.second) {
+            res.first->second = std::forward<M>(value);
+        }
+        return res;
+    }
+
+    size_t erase(const K& key) {
+        size_t index = find_index(key);
+        if (index == npos) {
+            return 0;
+        }
+        erase_at(index);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        size_t index = size_t(pos.ctrl - ctrl_bytes);
+        erase_at(index);
+        return {ctrl_bytes + index, slots + index, ctrl_bytes + capacity_};
+    }
+
+    void clear() {
+        for (size_t i = 0; i < capacity_; i++) {
+            if (ctrl_bytes[i] >= 0) {
+                std::destroy_at(slots + i);
+            }
+        }
+        if (capacity_ > 0) {
+            std::memset(ctrl_bytes, int(impl::ctrl::empty), capacity_);
+        }
+        size_ = 0;
+        growth_left = max_load(capacity_);
+    }
+
+    /**
+     * @brief makes room for n elements without growing
+     */
+    void reserve(size_t n) {
+        size_t needed = impl::group_width;
+        while (max_load(needed) < n) {
+            needed *= 2;
+        }
+        if (needed > capacity_) {
+            rehash(needed);
+        }
+    }
+
+private:
+    static constexpr size_t npos = ~size_t(0);
+
+    // at most 7/8 of the slots are full, beyond that probe sequences get long
+    static size_t max_load(size_t capacity) {
+        return capacity - capacity / 8;
+    }
+
+    size_t hash_of(const K& key) const {
+        return impl::mix_hash(hasher(key));
+    }
+
+    static int8_t h2(size_t hash) {
+        return int8_t(hash & 0x7f);
+    }
+
+    // the groups are visited in triangular order, which reaches every group of a power of two table once
+    struct probe_sequence {
+        probe_sequence(size_t hash, size_t groups) : mask(groups - 1), offset((hash >> 7) & mask) {}
+
+        [[nodiscard]] size_t group() const {
+            return offset * impl::group_width;
+        }
+
+        void next() {
+            step++;
+            offset = (offset + step) & mask;
+        }
+
+        size_t mask;
+        size_t offset;
+        size_t step = 0;
+    };
+
+    // index has to be a full slot
+    iterator iterator_at(size_t index) {
+        return {ctrl_bytes + index, slots + index, ctrl_bytes + capacity_, {}};
+    }
+
+    size_t find_index(const K& key) const {
+        return capacity_ == 0 ? npos : find_index(key, hash_of(key));
+    }
+
+    size_t find_index(const K& key, size_t hash) const {
+        if (capacity_ == 0) {
+            return npos;
+        }
+        probe_sequence seq(hash, capacity_ / impl::group_width);
+        while (true) {
+            impl::group g(ctrl_bytes + seq.group());
+            for (auto match = g.match(h2(hash)); match; ++match) {
+                size_t index = seq.group() + match.lowest();
+                if (eq(slots[index].first, key)) {
+                    return index;
+                }
+            }
+            if (g.match_empty()) {
+                return npos;
+            }
+            seq.next();
+        }
+    }
+
+    size_t find_free(size_t hash) const {
+        probe_sequence seq(hash, capacity_ / impl::group_width);
+        while (true) {
+            if (auto free = impl::group(ctrl_bytes + seq.group()).match_empty_or_deleted()) {
+                return seq.group() + free.lowest();
+            }
+            seq.next();
+        }
+    }
+
+    // a free slot for a key that is not in the map, marked full by commit_insert once the value is constructed
+    size_t prepare_insert(size_t hash) {
+        size_t index = capacity_ == 0 ? npos : find_free(hash);
+        if (index == npos || (growth_left == 0 && ctrl_bytes[index] == int8_t(impl::ctrl::empty))) {
+            // many tombstones: rehashing at the same size is enough to get rid of them
+            rehash(capacity_ == 0 ? impl::group_width : size_ * 2 < max_load(capacity_) ? capacity_ : capacity_ * 2);
+            index = find_free(hash);
+        }
+        return index;
+    }
+
+    // if the constructor of the value throws, the slot is still free and the map unchanged
+    void commit_insert(size_t index, size_t hash) {
+        if (ctrl_bytes[index] == int8_t(impl::ctrl::empty)) {
+            growth_left--;
+        }
+        ctrl_bytes[index] = h2(hash);
+        size_++;
+    }
+
+    void erase_at(size_t index) {
+        std::destroy_at(slots + index);
+        size_--;
+        // a probe only continues past a group without empty slots, so if this group has one the slot may become empty
+        size_t group_start = index - index % impl::group_width;
+        if (impl::group(ctrl_bytes + group_start).match_empty()) {
+            ctrl_bytes[index] = int8_t(impl::ctrl::empty);
+            growth_left++;
+        } else {
+            ctrl_bytes[index] = int8_t(impl::ctrl::deleted);
+        }
+    }
+
+    void rehash(size_t new_capacity) {
+        auto* old_ctrl = ctrl_bytes;
+        auto* old_slots = slots;
+        size_t old_capacity = capacity_;
+
+        ctrl_bytes = new int8_t[new_capacity];
+        std::memset(ctrl_bytes, int(impl::ctrl::empty), new_capacity);
+        slots = std::allocator<value_type>().allocate(new_capacity);
+        capacity_ = new_capacity;
+        growth_left = max_load(new_capacity) - size_;
+
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_ctrl[i] >= 0) {
+                size_t hash = hash_of(old_slots[i].first);
+                size_t index = find_free(hash);
+                ctrl_bytes[index] = h2(hash);
+                // the key is const in the slot, so it is copied
+                std::construct_at(slots + index, old_slots[i].first, std::move(old_slots[i].second));
+                std::destroy_at(old_slots + i);
+            }
+        }
+        delete[] old_ctrl;
+        if (old_slots) {
+            std::allocator<value_type>().deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void insert_unique(const K& key, const V& value) {
+        size_t hash = hash_of(key);
+        size_t index = prepare_insert(hash);
+        std::construct_at(slots + index, key, value);
+        commit_insert(index, hash);
+    }
+
+    void destroy() {
+        if (capacity_ == 0) {
+            return;
+        }
+        clear();
+        delete[] ctrl_bytes;
+        std::allocator<value_type>().deallocate(slots, capacity_);
+        ctrl_bytes = nullptr;
+        slots = nullptr;
+        capacity_ = 0;
+        growth_left = 0;
+    }
+
+    int8_t* ctrl_bytes = nullptr;
+    value_type* slots = nullptr;
+    size_t capacity_ = 0;
+    size_t size_ = 0;
+    size_t growth_left = 0;
+    [[no_unique_address]] Hash hasher;
+    [[no_unique_address]] Eq eq;
+};
+
+}// namespace cr::util
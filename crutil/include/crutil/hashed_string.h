@@ -0,0 +1,114 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace cr::util {
+
+namespace impl {
+
+// 64 bit FNV-1a
+constexpr uint64_t fnv1a(std::string_view s) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (char c : s) {
+        hash = (hash ^ uint8_t(c)) * 0x100000001b3;
+    }
+    return hash;
+}
+
+}// namespace impl
+
+class hashed_string;
+
+namespace literals {
+consteval hashed_string operator""_hs(const char* text, size_t size);
+}// namespace literals
+
+/**
+ * @brief a string that is compared and looked up by its 64 bit hash
+ * @details string literals hash at compile time, "name"_hs or passing a literal where a hashed_string is expected.
+ * Strings built at runtime go through intern(), which keeps one copy of each text alive for the lifetime of the program
+ * and throws if two different texts ever share a hash. c_str() is always null terminated.
+ */
+class hashed_string {
+public:
+    constexpr hashed_string() : value(impl::fnv1a("")), text("") {}
+
+    template<size_t N>
+    consteval hashed_string(const char (&literal)[N]) : value(impl::fnv1a({literal, N - 1})), text(literal) {}
+
+    /**
+     * @brief hashes text at runtime and keeps a copy of it
+     */
+    static hashed_string intern(std::string_view text) {
+        struct table {
+            std::mutex mutex;
+            std::unordered_map<uint64_t, std::unique_ptr<std::string>> strings;
+        };
+        static table interned;
+        uint64_t hash = impl::fnv1a(text);
+        std::lock_guard lock(interned.mutex);
+        auto& entry = interned.strings[hash];
+        if (!entry) {
+            entry = std::make_unique<std::string>(text);
+        } else if (*entry != text) {
+            throw std::runtime_error("hashed_string collision between " + *entry + " and " + std::string(text));
+        }
+        return {hash, entry->c_str()};
+    }
+
+    [[nodiscard]] constexpr uint64_t hash() const {
+        return value;
+    }
+
+    [[nodiscard]] constexpr const char* c_str() const {
+        return text;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return text;
+    }
+
+    friend constexpr bool operator==(const hashed_string& a, const hashed_string& b) {
+        return a.value == b.value;
+    }
+
+    friend constexpr auto operator<=>(const hashed_string& a, const hashed_string& b) {
+        return a.value <=> b.value;
+    }
+
+private:
+    friend consteval hashed_string literals::operator""_hs(const char* text, size_t size);
+
+    constexpr hashed_string(uint64_t value, const char* text) : value(value), text(text) {}
+
+    uint64_t value;
+    const char* text;
+};
+
+namespace literals {
+
+consteval hashed_string operator""_hs(const char* text, size_t size) {
+    return {impl::fnv1a({text, size}), text};
+}
+
+}// namespace literals
+
+}// namespace cr::util
+
+template<>
+struct std::hash<cr::util::hashed_string> {
+    size_t operator()(const cr::util::hashed_string& s) const noexcept {
+        return size_t(s.hash());
+    }
+};
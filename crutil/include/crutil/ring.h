@@ -0,0 +1,295 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace cr::util {
+
+namespace impl {
+
+template<typename T>
+struct ring_storage {
+    alignas(T) std::byte data[sizeof(T)];
+
+    T* get() {
+        return std::launder(reinterpret_cast<T*>(data));
+    }
+};
+
+inline size_t ring_capacity(size_t requested) {
+    return std::bit_ceil(std::max<size_t>(requested, 2));
+}
+
+}// namespace impl
+
+/**
+ * @brief bounded lock free queue for exactly one producer thread and one consumer thread
+ * @details the capacity is rounded up to a power of two. Producer and consumer each keep a cached copy of the other
+ * side's index on their own cache line, so they only touch the shared line when the cached value says full or empty.
+ * T only has to be move constructible, e.g. a type built on move_only. The span overload of try_pop also move assigns.
+ */
+template<typename T>
+class spsc_ring {
+public:
+    explicit spsc_ring(size_t capacity)
+        : mask(impl::ring_capacity(capacity) - 1), slots(std::make_unique<impl::ring_storage<T>[]>(mask + 1)) {}
+
+    spsc_ring(const spsc_ring&) = delete;
+    spsc_ring& operator=(const spsc_ring&) = delete;
+
+    ~spsc_ring() {
+        for (size_t i = head.load(std::memory_order_relaxed); i != tail.load(std::memory_order_relaxed); i++) {
+            slots[i & mask].get()->~T();
+        }
+    }
+
+    /**
+     * @brief producer only, false if the ring is full
+     */
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - producer_head > mask) {
+            producer_head = head.load(std::memory_order_acquire);
+            if (t - producer_head > mask) {
+                return false;
+            }
+        }
+        new (slots[t & mask].data) T(std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    bool try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    /**
+     * @brief producer only, moves as many values as fit from the front of values and publishes them at once
+     * @return the number of values moved
+     */
+    size_t try_push(std::span<T> values) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t + values.size() - producer_head > mask + 1) {
+            producer_head = head.load(std::memory_order_acquire);
+        }
+        size_t count = std::min(values.size(), mask + 1 - (t - producer_head));
+        for (size_t i = 0; i < count; i++) {
+            new (slots[(t + i) & mask].data) T(std::move(values[i]));
+        }
+        if (count != 0) {
+            tail.store(t + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief consumer only, empty if the ring is empty
+     */
+    std::optional<T> try_pop() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == consumer_tail) {
+            consumer_tail = tail.load(std::memory_order_acquire);
+            if (h == consumer_tail) {
+                return std::nullopt;
+            }
+        }
+        T* value = slots[h & mask].get();
+        std::optional<T> res(std::move(*value));
+        value->~T();
+        head.store(h + 1, std::memory_order_release);
+        return res;
+    }
+
+    /**
+     * @brief consumer only, move assigns up to out.size() values into out and frees their slots at once
+     * @return the number of values written
+     */
+    size_t try_pop(std::span<T> out)
+        requires std::is_move_assignable_v<T>
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (consumer_tail - h < out.size()) {
+            consumer_tail = tail.load(std::memory_order_acquire);
+        }
+        size_t count = std::min(out.size(), consumer_tail - h);
+        for (size_t i = 0; i < count; i++) {
+            T* value = slots[(h + i) & mask].get();
+            out[i] = std::move(*value);
+            value->~T();
+        }
+        if (count != 0) {
+            head.store(h + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * @brief approximate when called while the other side is active
+     */
+    [[nodiscard]] size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    const size_t mask;
+    const std::unique_ptr<impl::ring_storage<T>[]> slots;
+    // written by the consumer
+    alignas(64) std::atomic<size_t> head{0};
+    size_t consumer_tail = 0;
+    // written by the producer
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t producer_head = 0;
+};
+
+/**
+ * @brief bounded lock free queue for any number of producer and consumer threads
+ * @details Dmitry Vyukov's bounded MPMC queue, every cell carries a sequence number that tells producers and consumers
+ * whose turn it is, so a push or pop is one compare exchange on the shared position without a lock. The capacity is
+ * rounded up to a power of two. T has to be nothrow move constructible, since a claimed cell can not be given back.
+ */
+template<typename T>
+class mpmc_queue {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "a value has to move into and out of a claimed cell");
+
+public:
+    explicit mpmc_queue(size_t capacity)
+        : mask(impl::ring_capacity(capacity) - 1), cells(std::make_unique<cell[]>(mask + 1)) {
+        for (size_t i = 0; i <= mask; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue() {
+        while (try_pop()) {
+        }
+    }
+
+    /**
+     * @brief false if the queue is full
+     * @details a claimed cell has to be filled, so if T(args...) may throw the value is built before a cell is claimed
+     * and moved in afterwards. A throwing constructor leaves the queue as it was.
+     */
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return claim([&](void* memory) noexcept { new (memory) T(std::forward<Args>(args)...); });
+        } else {
+            T value(std::forward<Args>(args)...);
+            return claim([&](void* memory) noexcept { new (memory) T(std::move(value)); });
+        }
+    }
+
+    bool try_push(T&& value) {
+        return try_emplace(std::move(value));
+    }
+
+    bool try_push(const T& value) {
+        return try_emplace(value);
+    }
+
+    /**
+     * @brief empty if the queue is empty
+     */
+    std::optional<T> try_pop() {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell& c = cells[pos & mask];
+            size_t sequence = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    T* value = c.storage.get();
+                    std::optional<T> res(std::move(*value));
+                    value->~T();
+                    c.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return res;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief approximate while other threads push or pop
+     */
+    [[nodiscard]] size_t size() const {
+        size_t enqueued = enqueue_pos.load(std::memory_order_acquire);
+        size_t dequeued = dequeue_pos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return size() == 0;
+    }
+
+    [[nodiscard]] size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    struct cell {
+        std::atomic<size_t> sequence;
+        impl::ring_storage<T> storage;
+    };
+
+    // claims the next free cell and lets fill construct the value in it, fill must not throw
+    template<typename Fill>
+    bool claim(Fill fill) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            cell& c = cells[pos & mask];
+            size_t sequence = c.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    fill(c.storage.data);
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // the cell still holds the value from one lap ago
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t mask;
+    const std::unique_ptr<cell[]> cells;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+};
+
+}// namespace cr::util
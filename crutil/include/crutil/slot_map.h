@@ -0,0 +1,205 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace cr::util {
+
+/**
+ * @brief reference to a value in a slot_map<T>
+ * @details a default constructed handle is null and never valid. A handle stays valid until its value is erased,
+ * after that every lookup with it fails, even once the slot holds a new value.
+ */
+template<typename T, std::unsigned_integral Generation = uint32_t>
+struct slot_handle {
+    uint32_t index = 0;
+    Generation generation = 0;
+
+    [[nodiscard]] constexpr bool is_null() const {
+        return generation == 0;
+    }
+
+    constexpr explicit operator bool() const {
+        return !is_null();
+    }
+
+    friend constexpr bool operator==(const slot_handle&, const slot_handle&) = default;
+};
+
+/**
+ * @brief values addressed by generational handles, stored densely
+ * @details insert, erase and lookup are O(1). The values lie contiguously in insertion order until an erase moves the
+ * last value into the gap, so iterating values() is as fast as iterating a vector. Pointers and spans into the values
+ * are invalidated by insert and erase, handles are not. Not thread safe. A slot is retired once its Generation would
+ * wrap around, a narrower Generation makes handles smaller but retires slots sooner.
+ */
+template<typename T, std::unsigned_integral Generation = uint32_t>
+class slot_map {
+public:
+    using handle = slot_handle<T, Generation>;
+
+    /**
+     * @brief the map is unchanged if constructing the value throws
+     */
+    template<typename... Args>
+    handle emplace(Args&&... args) {
+        // everything that can throw happens before a slot is taken
+        if (free_head == none) {
+            grow(slots);
+        }
+        grow(item_slots);
+        items.emplace_back(std::forward<Args>(args)...);
+        uint32_t index;
+        if (free_head != none) {
+            index = free_head;
+            free_head = slots[index].target;
+        } else {
+            index = uint32_t(slots.size());
+            slots.push_back({none, 1});
+        }
+        slots[index].target = uint32_t(items.size() - 1);
+        item_slots.push_back(index);
+        return {index, slots[index].generation};
+    }
+
+    handle insert(T value) {
+        return emplace(std::move(value));
+    }
+
+    /**
+     * @brief removes the value of h, returns false if h is null or was erased already
+     */
+    bool erase(handle h) {
+        if (!contains(h)) {
+            return false;
+        }
+        auto& slot = slots[h.index];
+        uint32_t dense = slot.target;
+        if (dense != items.size() - 1) {
+            items[dense] = std::move(items.back());
+            item_slots[dense] = item_slots.back();
+            slots[item_slots[dense]].target = dense;
+        }
+        items.pop_back();
+        item_slots.pop_back();
+        // a slot whose generation would wrap around is retired instead of reused
+        if (++slot.generation != 0) {
+            slot.target = free_head;
+            free_head = h.index;
+        } else {
+            slot.target = none;
+        }
+        return true;
+    }
+
+    /**
+     * @brief removes the value of h and returns it, h has to be valid
+     */
+    T take(handle h) {
+        T value = std::move(items[slots[h.index].target]);
+        erase(h);
+        return value;
+    }
+
+    [[nodiscard]] bool contains(handle h) const {
+        return h.index < slots.size() && slots[h.index].generation == h.generation && h.generation != 0;
+    }
+
+    /**
+     * @brief the value of h, nullptr if h is not valid
+     */
+    [[nodiscard]] T* get(handle h) {
+        return contains(h) ? &items[slots[h.index].target] : nullptr;
+    }
+
+    [[nodiscard]] const T* get(handle h) const {
+        return contains(h) ? &items[slots[h.index].target] : nullptr;
+    }
+
+    /**
+     * @brief the value of h without checking it, h has to be valid
+     */
+    [[nodiscard]] T& operator[](handle h) {
+        return items[slots[h.index].target];
+    }
+
+    [[nodiscard]] const T& operator[](handle h) const {
+        return items[slots[h.index].target];
+    }
+
+    /**
+     * @brief handle of the value at position i of values()
+     */
+    [[nodiscard]] handle handle_at(size_t i) const {
+        return {item_slots[i], slots[item_slots[i]].generation};
+    }
+
+    [[nodiscard]] std::span<T> values() {
+        return items;
+    }
+
+    [[nodiscard]] std::span<const T> values() const {
+        return items;
+    }
+
+    [[nodiscard]] auto begin() { return items.begin(); }
+    [[nodiscard]] auto begin() const { return items.begin(); }
+    [[nodiscard]] auto end() { return items.end(); }
+    [[nodiscard]] auto end() const { return items.end(); }
+
+    [[nodiscard]] size_t size() const {
+        return items.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return items.empty();
+    }
+
+    void reserve(size_t n) {
+        items.reserve(n);
+        item_slots.reserve(n);
+        slots.reserve(n);
+    }
+
+    /**
+     * @brief erases all values, every handle handed out so far becomes invalid
+     */
+    void clear() {
+        while (!items.empty()) {
+            erase(handle_at(items.size() - 1));
+        }
+    }
+
+private:
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    struct slot {
+        // position in items while the slot is used, the next free slot while it is free
+        uint32_t target;
+        Generation generation;
+    };
+
+    // makes room for one more element, so the following push_back can not throw
+    template<typename U>
+    static void grow(std::vector<U>& v) {
+        if (v.size() == v.capacity()) {
+            v.reserve(std::max<size_t>(v.capacity() * 2, 8));
+        }
+    }
+
+    std::vector<T> items;
+    std::vector<uint32_t> item_slots;
+    std::vector<slot> slots;
+    uint32_t free_head = none;
+};
+
+}// namespace cr::util
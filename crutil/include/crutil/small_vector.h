@@ -0,0 +1,328 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace cr::util {
+
+/**
+ * @brief vector that keeps up to N elements inline and only allocates beyond that
+ * @details the API follows std::vector. Moving a small_vector whose elements are inline moves them one by one, so
+ * iterators and pointers into it do not survive a move, unlike with std::vector.
+ */
+template<typename T, size_t N>
+class small_vector {
+    static_assert(N > 0, "use std::vector without inline storage");
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    small_vector() noexcept = default;
+
+    explicit small_vector(size_t count) {
+        resize(count);
+    }
+
+    small_vector(size_t count, const T& value) {
+        resize(count, value);
+    }
+
+    template<std::input_iterator It>
+    small_vector(It first, It last) {
+        assign(first, last);
+    }
+
+    small_vector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    small_vector(const small_vector& other) {
+        assign(other.begin(), other.end());
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        take(std::move(other));
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            free_heap();
+            take(std::move(other));
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    ~small_vector() {
+        clear();
+        free_heap();
+    }
+
+    template<std::input_iterator It>
+    void assign(It first, It last) {
+        clear();
+        if constexpr (std::forward_iterator<It>) {
+            reserve(size_t(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            emplace_back(*first);
+        }
+    }
+
+    [[nodiscard]] iterator begin() noexcept { return ptr; }
+    [[nodiscard]] const_iterator begin() const noexcept { return ptr; }
+    [[nodiscard]] const_iterator cbegin() const noexcept { return ptr; }
+    [[nodiscard]] iterator end() noexcept { return ptr + count; }
+    [[nodiscard]] const_iterator end() const noexcept { return ptr + count; }
+    [[nodiscard]] const_iterator cend() const noexcept { return ptr + count; }
+    [[nodiscard]] reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    [[nodiscard]] const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    [[nodiscard]] reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    [[nodiscard]] const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    [[nodiscard]] size_t size() const noexcept { return count; }
+    [[nodiscard]] size_t capacity() const noexcept { return cap; }
+    [[nodiscard]] bool empty() const noexcept { return count == 0; }
+    [[nodiscard]] T* data() noexcept { return ptr; }
+    [[nodiscard]] const T* data() const noexcept { return ptr; }
+
+    /**
+     * @brief true while the elements live in the inline storage
+     */
+    [[nodiscard]] bool is_inline() const noexcept {
+        return ptr == inline_data();
+    }
+
+    [[nodiscard]] T& operator[](size_t i) { return ptr[i]; }
+    [[nodiscard]] const T& operator[](size_t i) const { return ptr[i]; }
+
+    [[nodiscard]] T& at(size_t i) {
+        if (i >= count) {
+            throw std::out_of_range("small_vector::at");
+        }
+        return ptr[i];
+    }
+
+    [[nodiscard]] const T& at(size_t i) const {
+        if (i >= count) {
+            throw std::out_of_range("small_vector::at");
+        }
+        return ptr[i];
+    }
+
+    [[nodiscard]] T& front() { return ptr[0]; }
+    [[nodiscard]] const T& front() const { return ptr[0]; }
+    [[nodiscard]] T& back() { return ptr[count - 1]; }
+    [[nodiscard]] const T& back() const { return ptr[count - 1]; }
+
+    void reserve(size_t n) {
+        if (n > cap) {
+            reallocate(n);
+        }
+    }
+
+    void clear() noexcept {
+        std::destroy(ptr, ptr + count);
+        count = 0;
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count == cap) {
+            // the new element is built before the old ones move, args may refer to one of them
+            size_t new_cap = grow_capacity(count + 1);
+            T* memory = std::allocator<T>().allocate(new_cap);
+            try {
+                std::construct_at(memory + count, std::forward<Args>(args)...);
+                try {
+                    transfer(memory);
+                } catch (...) {
+                    std::destroy_at(memory + count);
+                    throw;
+                }
+            } catch (...) {
+                std::allocator<T>().deallocate(memory, new_cap);
+                throw;
+            }
+            adopt(memory, new_cap);
+        } else {
+            std::construct_at(ptr + count, std::forward<Args>(args)...);
+        }
+        return ptr[count++];
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() {
+        std::destroy_at(ptr + --count);
+    }
+
+    void resize(size_t n) {
+        resize_impl(n, [](T* p) { std::uninitialized_value_construct_n(p, 1); });
+    }
+
+    void resize(size_t n, const T& value) {
+        resize_impl(n, [&](T* p) { std::construct_at(p, value); });
+    }
+
+    iterator insert(const_iterator pos, const T& value) {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator pos, Args&&... args) {
+        size_t index = size_t(pos - ptr);
+        if (index == count) {
+            emplace_back(std::forward<Args>(args)...);
+            return ptr + index;
+        }
+        T value(std::forward<Args>(args)...);
+        emplace_back(std::move(back()));
+        std::move_backward(ptr + index, ptr + count - 2, ptr + count - 1);
+        ptr[index] = std::move(value);
+        return ptr + index;
+    }
+
+    iterator erase(const_iterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        auto* f = ptr + (first - ptr);
+        auto* l = ptr + (last - ptr);
+        auto* new_end = std::move(l, end(), f);
+        std::destroy(new_end, end());
+        count = size_t(new_end - ptr);
+        return f;
+    }
+
+    friend bool operator==(const small_vector& a, const small_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    T* inline_data() noexcept {
+        return std::launder(reinterpret_cast<T*>(storage));
+    }
+
+    const T* inline_data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(storage));
+    }
+
+    size_t grow_capacity(size_t needed) const {
+        return std::max(cap * 2, needed);
+    }
+
+    // moves the elements into memory, copies them if a move could throw, leaves nothing behind in memory on failure
+    void transfer(T* memory) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move(ptr, ptr + count, memory);
+        } else {
+            std::uninitialized_copy(ptr, ptr + count, memory);
+        }
+    }
+
+    // makes memory, which holds new_cap transferred elements, the storage and frees the old heap storage
+    void adopt(T* memory, size_t new_cap) {
+        std::destroy(ptr, ptr + count);
+        free_heap();
+        ptr = memory;
+        cap = new_cap;
+    }
+
+    void reallocate(size_t new_cap) {
+        T* memory = std::allocator<T>().allocate(new_cap);
+        try {
+            transfer(memory);
+        } catch (...) {
+            std::allocator<T>().deallocate(memory, new_cap);
+            throw;
+        }
+        adopt(memory, new_cap);
+    }
+
+    template<typename Construct>
+    void resize_impl(size_t n, Construct construct) {
+        if (n < count) {
+            std::destroy(ptr + n, ptr + count);
+            count = n;
+            return;
+        }
+        if (n > cap) {
+            reallocate(std::max(n, grow_capacity(n)));
+        }
+        for (; count < n; count++) {
+            construct(ptr + count);
+        }
+    }
+
+    void free_heap() noexcept {
+        if (!is_inline()) {
+            std::allocator<T>().deallocate(ptr, cap);
+            ptr = inline_data();
+            cap = N;
+        }
+    }
+
+    void take(small_vector&& other) {
+        if (!other.is_inline()) {
+            ptr = std::exchange(other.ptr, other.inline_data());
+            count = std::exchange(other.count, 0);
+            cap = std::exchange(other.cap, N);
+            return;
+        }
+        std::uninitialized_move(other.ptr, other.ptr + other.count, ptr);
+        count = other.count;
+        other.clear();
+    }
+
+    T* ptr = inline_data();
+    size_t count = 0;
+    size_t cap = N;
+    alignas(T) std::byte storage[N * sizeof(T)];
+};
+
+}// namespace cr::util
@@ -0,0 +1,412 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cr::util {
+
+template<typename T = void>
+class task;
+
+class scheduler;
+
+namespace impl {
+
+struct task_promise_base {
+    struct final_awaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+            return handle.promise().continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+
+    final_awaiter final_suspend() noexcept {
+        return {};
+    }
+
+    void unhandled_exception() {
+        error = std::current_exception();
+    }
+
+    // resumed once the task is done, whoever awaits the task
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+    std::exception_ptr error;
+};
+
+template<typename T>
+struct task_promise : task_promise_base {
+    util::task<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& result) {
+        value.emplace(std::forward<U>(result));
+    }
+
+    T result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*value);
+    }
+
+    std::optional<T> value;
+};
+
+template<>
+struct task_promise<void> : task_promise_base {
+    util::task<void> get_return_object();
+
+    void return_void() {}
+
+    void result() {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+}// namespace impl
+
+/**
+ * @brief lazily started coroutine that produces a T
+ * @details the body runs when the task is awaited, the awaiting coroutine continues right after the task finishes
+ * without going through a scheduler. An exception escaping the body is rethrown by co_await. Top level tasks are
+ * started with scheduler::spawn. Awaiting transfers control as a tail call, so chains of any depth run in constant
+ * stack, but GCC only emits those tail calls from -O2 on. Unoptimized and sanitizer builds grow the stack per level.
+ */
+template<typename T>
+class [[nodiscard]] task {
+public:
+    using promise_type = impl::task_promise<T>;
+
+    task() = default;
+
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+
+    task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    task& operator=(task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    [[nodiscard]] bool done() const {
+        return !handle || handle.done();
+    }
+
+    auto operator co_await() && {
+        struct awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() {
+                return handle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() {
+                return handle.promise().result();
+            }
+        };
+        return awaiter{handle};
+    }
+
+private:
+    friend promise_type;
+    friend class scheduler;
+
+    explicit task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+namespace impl {
+
+template<typename T>
+util::task<T> task_promise<T>::get_return_object() {
+    return util::task<T>(std::coroutine_handle<task_promise<T>>::from_promise(*this));
+}
+
+inline util::task<void> task_promise<void>::get_return_object() {
+    return util::task<void>(std::coroutine_handle<task_promise<void>>::from_promise(*this));
+}
+
+}// namespace impl
+
+/**
+ * @brief anything whose completion can be checked without blocking, e.g. file_batch or a Vulkan fence
+ */
+template<typename T>
+concept pollable = requires(T& t) {
+    { t.ready() } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief runs coroutines on the thread that calls poll() or run()
+ * @details coroutines only ever run on that thread, so they can touch the same state as the main loop without locks.
+ * They wait for other work in three ways: until() checks a pollable on every poll(), offload() runs a function on a
+ * thread pool and comes back with its result, schedule() just yields to the other coroutines. Blocking calls such as
+ * a Vulkan fence wait can be offloaded to keep them off the main thread instead of polling them.
+ */
+class scheduler {
+public:
+    scheduler() = default;
+
+    scheduler(const scheduler&) = delete;
+    scheduler& operator=(const scheduler&) = delete;
+
+    /**
+     * @brief waits for offloaded functions that still refer to the scheduler, then destroys unfinished tasks
+     */
+    ~scheduler() {
+        std::unique_lock lock(inbox_mutex);
+        inbox_signal.wait(lock, [this] { return offloaded == 0; });
+    }
+
+    /**
+     * @brief starts t on the next poll(), the scheduler keeps it alive until it is done
+     */
+    template<typename T>
+    void spawn(task<T> t) {
+        roots.push_back(root(std::move(t)));
+        ready.push_back(roots.back().handle);
+    }
+
+    /**
+     * @brief resumes every coroutine that can make progress
+     * @details rethrows the first exception that escaped a spawned task. Returns false once all spawned tasks are
+     * done.
+     */
+    bool poll() {
+        {
+            std::lock_guard lock(inbox_mutex);
+            ready.insert(ready.end(), inbox.begin(), inbox.end());
+            inbox.clear();
+        }
+        for (size_t i = 0; i < polls.size();) {
+            if (polls[i].ready(polls[i].object)) {
+                ready.push_back(polls[i].handle);
+                polls[i] = polls.back();
+                polls.pop_back();
+            } else {
+                i++;
+            }
+        }
+        // coroutines that yield again are resumed on the next poll, not in this one
+        for (size_t n = ready.size(); n != 0; n--) {
+            auto handle = ready.front();
+            ready.pop_front();
+            handle.resume();
+        }
+        std::erase_if(roots, [](const task<void>& t) { return t.done(); });
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+        return !roots.empty();
+    }
+
+    /**
+     * @brief polls until every spawned task is done
+     * @details sleeps while only offloaded work is left, spins with yields while something has to be polled. Tasks may
+     * only wait through schedule(), until(), offload() or other tasks. If the remaining tasks wait on anything else,
+     * nothing could ever resume them, so run() throws std::runtime_error instead of spinning forever.
+     */
+    void run() {
+        while (poll()) {
+            if (!ready.empty()) {
+                continue;
+            }
+            if (polls.empty()) {
+                std::unique_lock lock(inbox_mutex);
+                inbox_signal.wait(lock, [this] { return !inbox.empty() || offloaded == 0; });
+                if (inbox.empty()) {
+                    throw std::runtime_error("scheduler::run: tasks wait on something the scheduler does not track");
+                }
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /**
+     * @brief suspends until the next poll()
+     */
+    auto schedule() {
+        struct awaiter {
+            scheduler& owner;
+
+            bool await_ready() {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                owner.ready.push_back(handle);
+            }
+
+            void await_resume() {}
+        };
+        return awaiter{*this};
+    }
+
+    /**
+     * @brief suspends until object.ready() returns true, object has to stay alive until then
+     */
+    template<pollable P>
+    auto until(P& object) {
+        struct awaiter {
+            scheduler& owner;
+            P& object;
+
+            bool await_ready() {
+                return bool(object.ready());
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                owner.polls.push_back({[](void* o) { return bool(static_cast<P*>(o)->ready()); },
+                                       const_cast<void*>(static_cast<const void*>(&object)), handle});
+            }
+
+            void await_resume() {}
+        };
+        return awaiter{*this, object};
+    }
+
+    /**
+     * @brief runs f on pool and resumes with its result on the scheduler thread
+     * @details an exception thrown by f is rethrown by co_await
+     */
+    template<typename F>
+    auto offload(thread_pool& pool, F f) {
+        using result_type = std::invoke_result_t<F&>;
+        using stored_type = std::conditional_t<std::is_void_v<result_type>, std::monostate, result_type>;
+        struct awaiter {
+            scheduler& owner;
+            thread_pool& pool;
+            F f;
+            std::optional<stored_type> value;
+            std::exception_ptr error;
+
+            bool await_ready() {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) {
+                pool.submit([this, handle] {
+                    try {
+                        if constexpr (std::is_void_v<result_type>) {
+                            f();
+                            value.emplace();
+                        } else {
+                            value.emplace(f());
+                        }
+                    } catch (...) {
+                        error = std::current_exception();
+                    }
+                    owner.post(handle);
+                });
+                // counted once submit succeeded, a throwing submit resumes the coroutine with its exception. post may
+                // already have counted down, the count wraps back since only this thread waits for it in between
+                std::lock_guard lock(owner.inbox_mutex);
+                owner.offloaded++;
+            }
+
+            result_type await_resume() {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+                if constexpr (!std::is_void_v<result_type>) {
+                    return std::move(*value);
+                }
+            }
+        };
+        return awaiter{*this, pool, std::move(f), std::nullopt, nullptr};
+    }
+
+    /**
+     * @brief number of spawned tasks that are not done yet
+     */
+    [[nodiscard]] size_t pending() const {
+        return roots.size();
+    }
+
+private:
+    struct poll_wait {
+        bool (*ready)(void*);
+        void* object;
+        std::coroutine_handle<> handle;
+    };
+
+    template<typename T>
+    task<void> root(task<T> t) {
+        try {
+            co_await std::move(t);
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    // called from pool threads when an offloaded function is done
+    void post(std::coroutine_handle<> handle) {
+        std::lock_guard lock(inbox_mutex);
+        inbox.push_back(handle);
+        offloaded--;
+        inbox_signal.notify_all();
+    }
+
+    std::vector<task<void>> roots;
+    std::deque<std::coroutine_handle<>> ready;
+    std::vector<poll_wait> polls;
+    std::exception_ptr error;
+
+    std::mutex inbox_mutex;
+    std::condition_variable inbox_signal;
+    std::vector<std::coroutine_handle<>> inbox;
+    size_t offloaded = 0;
+};
+
+}// namespace cr::util
@@ -0,0 +1,438 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace cr::util {
+
+class thread_pool;
+class task_group;
+
+namespace impl {
+
+struct task {
+    task_group* group = nullptr;
+
+    virtual ~task() = default;
+    virtual void run() = 0;
+};
+
+template<typename F>
+struct task_impl final : task {
+    F f;
+
+    explicit task_impl(F f) : f(std::move(f)) {}
+
+    void run() override {
+        f();
+    }
+};
+
+/**
+ * @brief Chase-Lev work stealing deque, after Lê, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models"
+ * @details the owner pushes and pops at the bottom without locks, other threads steal from the top. The ring grows
+ * when full, old rings are kept until destruction because a thief may still read from them.
+ */
+template<typename T>
+class work_stealing_deque {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    struct ring {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> items;
+
+        explicit ring(int64_t capacity) : capacity(capacity), items(new std::atomic<T>[size_t(capacity)]) {}
+
+        T get(int64_t i) const {
+            return items[size_t(i & (capacity - 1))].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t i, T value) {
+            items[size_t(i & (capacity - 1))].store(value, std::memory_order_relaxed);
+        }
+    };
+
+public:
+    explicit work_stealing_deque(int64_t capacity = 256) {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        rings.push_back(std::make_unique<ring>(capacity));
+        array.store(rings.back().get(), std::memory_order_relaxed);
+    }
+
+    work_stealing_deque(const work_stealing_deque&) = delete;
+    work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+
+    // owner only
+    void push(T value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        ring* a = array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, t, b);
+        }
+        a->put(b, value);
+        // a release store instead of the paper's release fence, same cost and visible to thread sanitizers
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // owner only, takes the most recently pushed item
+    bool pop(T& out) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring* a = array.load(std::memory_order_relaxed);
+        // seq_cst store and load instead of the paper's seq_cst fence, thread sanitizers do not model fences
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = a->get(b);
+        if (t == b) {
+            // last item, race against thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // any thread, takes the oldest item
+    bool steal(T& out) {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return false;
+        }
+        // acquire stands in for consume, which compilers implement as acquire anyway
+        ring* a = array.load(std::memory_order_acquire);
+        T value = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = value;
+        return true;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return top.load(std::memory_order_relaxed) >= bottom.load(std::memory_order_relaxed);
+    }
+
+private:
+    ring* grow(ring* old, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<ring>(old->capacity * 2);
+        for (int64_t i = t; i < b; i++) {
+            bigger->put(i, old->get(i));
+        }
+        rings.push_back(std::move(bigger));
+        array.store(rings.back().get(), std::memory_order_release);
+        return rings.back().get();
+    }
+
+    // top and bottom on their own cache lines, thieves hammer top while the owner works on bottom
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    alignas(64) std::atomic<ring*> array;
+    std::vector<std::unique_ptr<ring>> rings;
+};
+
+}// namespace impl
+
+struct thread_pool_options {
+    // 0 uses one worker per hardware thread
+    size_t threads = 0;
+    // binds worker i to cpu i, so the caches a worker warmed up stay its own
+    bool pin = false;
+};
+
+/**
+ * @brief work stealing thread pool
+ * @details every worker owns a Chase-Lev deque. Tasks spawned by a worker go to its own deque and are run newest
+ * first, idle workers steal the oldest task of a random victim, which tends to be the largest piece of work left.
+ * Tasks from threads outside the pool go through a shared queue. Idle workers sleep on an atomic wait.
+ */
+class thread_pool {
+public:
+    explicit thread_pool(const thread_pool_options& options = {}) {
+        size_t count = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+        workers.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            workers.push_back(std::make_unique<worker>());
+        }
+        for (size_t i = 0; i < count; i++) {
+            workers[i]->thread = std::thread([this, i] { worker_loop(i); });
+            if (options.pin) {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(i % std::max(1u, std::thread::hardware_concurrency()), &set);
+                pthread_setaffinity_np(workers[i]->thread.native_handle(), sizeof(set), &set);
+            }
+        }
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /**
+     * @brief runs the tasks that are still queued, then joins the workers
+     */
+    ~thread_pool() {
+        stopping.store(true);
+        wake(true);
+        for (auto& w : workers) {
+            w->thread.join();
+        }
+    }
+
+    [[nodiscard]] size_t size() const {
+        return workers.size();
+    }
+
+    /**
+     * @brief index of the calling worker of this pool, or size() for any other thread
+     */
+    [[nodiscard]] size_t current_worker() const {
+        return current_pool == this ? current_index : size();
+    }
+
+    /**
+     * @brief runs f on some worker, use a task_group to wait for it
+     */
+    template<typename F>
+    void submit(F&& f) {
+        push(new impl::task_impl<std::decay_t<F>>(std::forward<F>(f)));
+    }
+
+private:
+    friend class task_group;
+
+    struct worker {
+        impl::work_stealing_deque<impl::task*> deque;
+        std::thread thread;
+    };
+
+    void push(impl::task* t) {
+        if (current_pool == this) {
+            workers[current_index]->deque.push(t);
+        } else {
+            std::lock_guard lock(injection_mutex);
+            injection.push_back(t);
+        }
+        wake(false);
+    }
+
+    void wake(bool all) {
+        epoch.fetch_add(1);
+        if (sleeping.load() > 0 || all) {
+            if (all) {
+                epoch.notify_all();
+            } else {
+                epoch.notify_one();
+            }
+        }
+    }
+
+    impl::task* find_task(size_t self) {
+        impl::task* t = nullptr;
+        if (self < workers.size() && workers[self]->deque.pop(t)) {
+            return t;
+        }
+        // random victims, so that thieves do not all line up behind the same worker
+        thread_local std::minstd_rand rng(std::random_device{}());
+        size_t count = workers.size();
+        size_t start = rng() % count;
+        for (size_t k = 0; k < count; k++) {
+            size_t victim = (start + k) % count;
+            if (victim != self && workers[victim]->deque.steal(t)) {
+                return t;
+            }
+        }
+        std::lock_guard lock(injection_mutex);
+        if (!injection.empty()) {
+            t = injection.front();
+            injection.pop_front();
+            return t;
+        }
+        return nullptr;
+    }
+
+    void execute(impl::task* t);
+
+    /**
+     * @brief runs one pending task on the calling thread, false if there was none
+     */
+    bool run_one() {
+        auto* t = find_task(current_worker());
+        if (t == nullptr) {
+            return false;
+        }
+        execute(t);
+        return true;
+    }
+
+    void worker_loop(size_t index) {
+        current_pool = this;
+        current_index = index;
+        constexpr int spins_before_sleep = 64;
+        int idle = 0;
+        while (true) {
+            auto seen = epoch.load();
+            if (run_one()) {
+                idle = 0;
+                continue;
+            }
+            if (stopping.load()) {
+                break;
+            }
+            if (++idle < spins_before_sleep) {
+                std::this_thread::yield();
+                continue;
+            }
+            // a push after the epoch was read changes it, so the wait returns immediately instead of missing it
+            sleeping.fetch_add(1);
+            epoch.wait(seen);
+            sleeping.fetch_sub(1);
+            idle = 0;
+        }
+        current_pool = nullptr;
+    }
+
+    static inline thread_local thread_pool* current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+
+    std::vector<std::unique_ptr<worker>> workers;
+    std::mutex injection_mutex;
+    std::deque<impl::task*> injection;
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<uint32_t> sleeping{0};
+    std::atomic<bool> stopping{false};
+};
+
+/**
+ * @brief set of tasks that can be waited for together
+ * @details wait() does not block while tasks are pending, the waiting thread runs tasks itself, which also makes
+ * nested parallelism from inside a task safe. The first exception thrown by a task is rethrown by wait().
+ */
+class task_group {
+public:
+    explicit task_group(thread_pool& pool) : pool(pool) {}
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() {
+        if (pending.load(std::memory_order_acquire) != 0) {
+            try {
+                wait();
+            } catch (...) {
+            }
+        }
+    }
+
+    template<typename F>
+    void run(F&& f) {
+        auto* t = new impl::task_impl<std::decay_t<F>>(std::forward<F>(f));
+        t->group = this;
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.push(t);
+    }
+
+    void wait() {
+        while (pending.load(std::memory_order_acquire) != 0) {
+            if (!pool.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        if (error) {
+            std::rethrow_exception(std::exchange(error, nullptr));
+        }
+    }
+
+private:
+    friend class thread_pool;
+
+    void finish(std::exception_ptr e) {
+        if (e) {
+            std::lock_guard lock(error_mutex);
+            if (!error) {
+                error = std::move(e);
+            }
+        }
+        pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    thread_pool& pool;
+    std::atomic<size_t> pending{0};
+    std::mutex error_mutex;
+    std::exception_ptr error;
+};
+
+inline void thread_pool::execute(impl::task* t) {
+    std::exception_ptr e;
+    try {
+        t->run();
+    } catch (...) {
+        e = std::current_exception();
+    }
+    auto* group = t->group;
+    delete t;
+    if (group != nullptr) {
+        group->finish(std::move(e));
+    }
+}
+
+namespace impl {
+
+template<typename F>
+void split_for(task_group& group, size_t begin, size_t end, size_t grain, F& f) {
+    // hand the upper halves to other workers and keep splitting the lower half, so thieves get big pieces
+    while (end - begin > grain) {
+        size_t middle = begin + (end - begin) / 2;
+        group.run([&group, middle, end, grain, &f] { split_for(group, middle, end, grain, f); });
+        end = middle;
+    }
+    if constexpr (std::is_invocable_v<F&, size_t, size_t>) {
+        f(begin, end);
+    } else {
+        for (size_t i = begin; i < end; i++) {
+            f(i);
+        }
+    }
+}
+
+}// namespace impl
+
+/**
+ * @brief calls f(i) for every i in [begin, end), or f(first, last) for chunks of at most grain indices
+ * @details the range is split in halves recursively until a piece is no larger than grain, the calling thread takes
+ * part in the work and returns when everything is done
+ */
+template<typename F>
+void parallel_for(thread_pool& pool, size_t begin, size_t end, size_t grain, F&& f) {
+    if (begin >= end) {
+        return;
+    }
+    task_group group(pool);
+    impl::split_for(group, begin, end, std::max<size_t>(grain, 1), f);
+    group.wait();
+}
+
+}// namespace cr::util
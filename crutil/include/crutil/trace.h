@@ -0,0 +1,290 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include "comptime.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*
+ * Tracing zones, counters and frame markers, exported as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ * Everything compiles to nothing unless CR_TRACE is defined (cmake -DCRLIB_TRACE=ON), see cr::compiletime::trace.
+ * With it, nothing is recorded until start_trace() is called.
+ *
+ * CR_TRACE_SCOPE("draw");            // zone from here to the end of the scope
+ * CR_TRACE_COUNTER("uploads", n);    // value over time
+ * CR_TRACE_FRAME();                  // marks the start of a frame
+ *
+ * Names have to be string literals, only the pointer is recorded.
+ */
+
+namespace cr::util {
+
+namespace impl {
+
+enum class trace_kind : uint8_t {
+    zone,
+    counter,
+    frame
+};
+
+struct trace_event {
+    const char* name;
+    uint64_t start;
+    // duration in ns for zones, the value for counters
+    double value;
+    trace_kind kind;
+};
+
+inline uint64_t trace_now() {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count());
+}
+
+// written by its thread only and read by the exporter up to count, so recording takes no lock
+struct trace_buffer {
+    static constexpr size_t chunk_size = 4096;
+    static constexpr size_t max_chunks = 1024;
+
+    using chunk = std::array<trace_event, chunk_size>;
+
+    explicit trace_buffer(uint32_t thread) : thread(thread) {}
+
+    ~trace_buffer() {
+        for (auto& c : chunks) {
+            delete c.load(std::memory_order_relaxed);
+        }
+    }
+
+    void push(const trace_event& e) {
+        size_t n = count.load(std::memory_order_relaxed);
+        if (n == chunk_size * max_chunks) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        auto& c = chunks[n / chunk_size];
+        auto* events = c.load(std::memory_order_relaxed);
+        if (events == nullptr) {
+            events = new chunk;
+            c.store(events, std::memory_order_release);
+        }
+        (*events)[n % chunk_size] = e;
+        count.store(n + 1, std::memory_order_release);
+    }
+
+    const uint32_t thread;
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> dropped{0};
+    std::array<std::atomic<chunk*>, max_chunks> chunks{};
+};
+
+struct trace_state {
+    std::atomic<bool> enabled{false};
+    std::atomic<uint64_t> epoch{0};
+    std::mutex mutex;
+    // buffers outlive their threads, so the events of finished threads are still exported
+    std::vector<std::unique_ptr<trace_buffer>> buffers;
+};
+
+inline trace_state& trace_global() {
+    static trace_state state;
+    return state;
+}
+
+inline trace_buffer& trace_local() {
+    thread_local trace_buffer* buffer = [] {
+        auto& state = trace_global();
+        std::lock_guard lock(state.mutex);
+        return state.buffers.emplace_back(std::make_unique<trace_buffer>(uint32_t(state.buffers.size()))).get();
+    }();
+    return *buffer;
+}
+
+inline void trace_record(const trace_event& e) {
+    auto& state = trace_global();
+    if (!state.enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    auto& buffer = trace_local();
+    // start_trace() does not touch the buffers, each thread drops its old events on its first new one
+    auto epoch = state.epoch.load(std::memory_order_relaxed);
+    if (buffer.epoch.load(std::memory_order_relaxed) != epoch) {
+        // the reset is published by the epoch, an exporter that sees the new epoch never sees the old count
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.epoch.store(epoch, std::memory_order_release);
+    }
+    buffer.push(e);
+}
+
+inline void write_json_string(std::ostream& out, const char* s) {
+    out << '"';
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            out << '\\';
+        }
+        out << *s;
+    }
+    out << '"';
+}
+
+}// namespace impl
+
+/**
+ * @brief records a zone from construction to destruction, use CR_TRACE_SCOPE
+ */
+class trace_scope {
+public:
+    explicit trace_scope(const char* name) {
+        if constexpr (cr::compiletime::trace) {
+            // while stopped a zone costs one relaxed load and no clock reads
+            if (impl::trace_global().enabled.load(std::memory_order_relaxed)) {
+                this->name = name;
+                start = impl::trace_now();
+            }
+        }
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+    ~trace_scope() {
+        if constexpr (cr::compiletime::trace) {
+            if (name == nullptr) {
+                return;
+            }
+            impl::trace_record({name, start, double(impl::trace_now() - start), impl::trace_kind::zone});
+        }
+    }
+
+private:
+    const char* name = nullptr;
+    uint64_t start = 0;
+};
+
+inline void trace_counter(const char* name, double value) {
+    if constexpr (cr::compiletime::trace) {
+        impl::trace_record({name, impl::trace_now(), value, impl::trace_kind::counter});
+    }
+}
+
+inline void trace_frame() {
+    if constexpr (cr::compiletime::trace) {
+        impl::trace_record({"frame", impl::trace_now(), 0, impl::trace_kind::frame});
+    }
+}
+
+/**
+ * @brief drops everything recorded so far and starts recording on all threads
+ */
+inline void start_trace() {
+    if constexpr (cr::compiletime::trace) {
+        auto& state = impl::trace_global();
+        state.epoch.fetch_add(1, std::memory_order_relaxed);
+        state.enabled.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief stops recording, zones that are still open are not recorded, zones opened before start_trace() neither
+ */
+inline void stop_trace() {
+    if constexpr (cr::compiletime::trace) {
+        impl::trace_global().enabled.store(false, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief writes everything recorded since start_trace() as Chrome trace JSON
+ * @details may be called while recording, events recorded during the call may be missing. Must not run at the same
+ * time as start_trace().
+ */
+inline void write_chrome_trace(std::ostream& out) {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    if constexpr (cr::compiletime::trace) {
+        auto& state = impl::trace_global();
+        auto epoch = state.epoch.load(std::memory_order_relaxed);
+        std::lock_guard lock(state.mutex);
+        // timestamps are in µs, fixed with ns digits since steady clock values are large
+        auto flags = out.flags();
+        auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+        bool first = true;
+        auto separator = [&] {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+        };
+        for (const auto& buffer : state.buffers) {
+            if (buffer->epoch.load(std::memory_order_acquire) != epoch) {
+                continue;
+            }
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++) {
+                const auto& e = (*buffer->chunks[i / impl::trace_buffer::chunk_size].load(std::memory_order_acquire))
+                        [i % impl::trace_buffer::chunk_size];
+                separator();
+                out << "{\"name\":";
+                impl::write_json_string(out, e.name);
+                out << ",\"pid\":0,\"tid\":" << buffer->thread << ",\"ts\":" << double(e.start) / 1000;
+                switch (e.kind) {
+                    case impl::trace_kind::zone:
+                        out << ",\"ph\":\"X\",\"dur\":" << e.value / 1000 << '}';
+                        break;
+                    case impl::trace_kind::counter:
+                        out << ",\"ph\":\"C\",\"args\":{\"value\":" << e.value << "}}";
+                        break;
+                    case impl::trace_kind::frame:
+                        out << ",\"ph\":\"i\",\"s\":\"g\"}";
+                        break;
+                }
+            }
+            if (auto dropped = buffer->dropped.load(std::memory_order_relaxed)) {
+                separator();
+                out << "{\"name\":\"dropped events\",\"pid\":0,\"tid\":" << buffer->thread
+                    << ",\"ph\":\"M\",\"args\":{\"count\":" << dropped << "}}";
+            }
+        }
+        out.flags(flags);
+        out.precision(precision);
+    }
+    out << "]}\n";
+}
+
+/**
+ * @brief write_chrome_trace into a file, throws std::runtime_error if it can not be written
+ */
+inline void save_chrome_trace(const std::string& path) {
+    std::ofstream file(path);
+    if (!file) {
+        throw std::runtime_error("Could not open trace file " + path);
+    }
+    write_chrome_trace(file);
+    if (!file) {
+        throw std::runtime_error("Could not write trace file " + path);
+    }
+}
+
+}// namespace cr::util
+
+#define CR_TRACE_CONCAT_IMPL(a, b) a##b
+#define CR_TRACE_CONCAT(a, b) CR_TRACE_CONCAT_IMPL(a, b)
+
+#define CR_TRACE_SCOPE(name) ::cr::util::trace_scope CR_TRACE_CONCAT(cr_trace_scope_, __LINE__)(name)
+#define CR_TRACE_COUNTER(name, value) ::cr::util::trace_counter(name, double(value))
+#define CR_TRACE_FRAME() ::cr::util::trace_frame()
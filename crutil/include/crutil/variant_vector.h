@@ -0,0 +1,208 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace cr::util {
+
+namespace impl {
+
+template<typename T, typename... Ts>
+constexpr size_t index_of() {
+    constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+    for (size_t i = 0; i < sizeof...(Ts); i++) {
+        if (matches[i]) {
+            return i;
+        }
+    }
+    return sizeof...(Ts);
+}
+
+}// namespace impl
+
+/**
+ * @brief container for the alternatives of std::variant<Ts...> that stores every alternative in its own array
+ * @details iterating by type with for_each_type runs one tight loop per alternative without a dispatch per element,
+ * which also keeps per type state (like a bound shader) valid for the whole loop. The insertion order is kept in a
+ * separate list of (type, index) entries for callers that need it, see for_each.
+ */
+template<typename... Ts>
+class variant_vector {
+    static_assert(sizeof...(Ts) < 256, "The order entries store the type in one byte");
+
+public:
+    using variant_type = std::variant<Ts...>;
+
+    struct entry {
+        uint8_t type;
+        uint32_t index;
+    };
+
+    template<typename T>
+    static constexpr size_t type_index = impl::index_of<T, Ts...>();
+
+    variant_vector() = default;
+
+    variant_vector(std::initializer_list<variant_type> values) {
+        for (const auto& value : values) {
+            push_back(value);
+        }
+    }
+
+    template<typename T>
+        requires(type_index<std::remove_cvref_t<T>> < sizeof...(Ts))
+    void push_back(T&& value) {
+        using U = std::remove_cvref_t<T>;
+        auto& bucket = std::get<type_index<U>>(buckets);
+        order.push_back({uint8_t(type_index<U>), uint32_t(bucket.size())});
+        bucket.push_back(std::forward<T>(value));
+    }
+
+    void push_back(const variant_type& value) {
+        std::visit([this](const auto& alternative) { push_back(alternative); }, value);
+    }
+
+    void push_back(variant_type&& value) {
+        std::visit([this](auto&& alternative) { push_back(std::move(alternative)); }, std::move(value));
+    }
+
+    template<typename T, typename... Args>
+    T& emplace_back(Args&&... args) {
+        auto& bucket = std::get<type_index<T>>(buckets);
+        order.push_back({uint8_t(type_index<T>), uint32_t(bucket.size())});
+        return bucket.emplace_back(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    void reserve(size_t count) {
+        std::get<type_index<T>>(buckets).reserve(count);
+    }
+
+    void clear() {
+        std::apply([](auto&... bucket) { (bucket.clear(), ...); }, buckets);
+        order.clear();
+    }
+
+    [[nodiscard]] size_t size() const {
+        return order.size();
+    }
+
+    [[nodiscard]] bool empty() const {
+        return order.empty();
+    }
+
+    /**
+     * @brief all elements of one alternative, in insertion order
+     */
+    template<typename T>
+    [[nodiscard]] std::span<T> get() {
+        return std::get<type_index<T>>(buckets);
+    }
+
+    template<typename T>
+    [[nodiscard]] std::span<const T> get() const {
+        return std::get<type_index<T>>(buckets);
+    }
+
+    /**
+     * @brief (type, index in that type's array) of every element in insertion order
+     */
+    [[nodiscard]] std::span<const entry> entries() const {
+        return order;
+    }
+
+    /**
+     * @brief copy of element i as a variant
+     */
+    [[nodiscard]] variant_type at(size_t i) const {
+        return at_impl(order[i], std::index_sequence_for<Ts...>{});
+    }
+
+    /**
+     * @brief calls f once per alternative with a span of all its elements
+     * @details the alternatives are visited in the order of Ts, empty ones are skipped. Loop over the span inside f,
+     * which is the loop the compiler can keep tight.
+     */
+    template<typename F>
+    void for_each_type(F&& f) const {
+        for_each_type_impl(*this, f);
+    }
+
+    template<typename F>
+    void for_each_type(F&& f) {
+        for_each_type_impl(*this, f);
+    }
+
+    /**
+     * @brief calls f(element) in insertion order, one switch on the type per element
+     */
+    template<typename F>
+    void for_each(F&& f) const {
+        for (const auto& e : order) {
+            dispatch(e, f, std::index_sequence_for<Ts...>{});
+        }
+    }
+
+private:
+    template<typename Self, typename F>
+    static void for_each_type_impl(Self& self, F& f) {
+        std::apply(
+                [&](auto&... bucket) {
+                    (
+                            [&](auto& b) {
+                                if (b.empty()) {
+                                    return;
+                                }
+                                f(std::span(b));
+                            }(bucket),
+                            ...);
+                },
+                self.buckets);
+    }
+
+    template<typename F, size_t... I>
+    void dispatch(const entry& e, F& f, std::index_sequence<I...>) const {
+        // a fold over || stops at the matching alternative, compilers turn it into a jump table
+        (void) ((e.type == I ? (f(std::get<I>(buckets)[e.index]), true) : false) || ...);
+    }
+
+    template<size_t... I>
+    variant_type at_impl(const entry& e, std::index_sequence<I...>) const {
+        variant_type res;
+        (void) ((e.type == I ? (res.template emplace<I>(std::get<I>(buckets)[e.index]), true) : false) || ...);
+        return res;
+    }
+
+    std::tuple<std::vector<Ts>...> buckets;
+    std::vector<entry> order;
+};
+
+namespace impl {
+
+template<typename V>
+struct variant_vector_for;
+
+template<typename... Ts>
+struct variant_vector_for<std::variant<Ts...>> {
+    using type = variant_vector<Ts...>;
+};
+
+}// namespace impl
+
+/**
+ * @brief variant_vector for the alternatives of a std::variant, e.g. one built with merge_variant
+ */
+template<typename V>
+using variant_vector_for = typename impl::variant_vector_for<V>::type;
+
+}// namespace cr::util
@@ -0,0 +1,100 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace cr::util {
+
+namespace impl {
+
+template<typename V>
+constexpr size_t alternatives = std::variant_size_v<std::remove_cvref_t<V>>;
+
+// the alternatives of all variants are numbered like the digits of a number, the last variant changes fastest
+template<typename... Vs>
+constexpr size_t combinations = (alternatives<Vs> * ... * 1);
+
+template<size_t Flat, size_t I, typename... Vs>
+constexpr size_t alternative_of() {
+    constexpr std::array<size_t, sizeof...(Vs)> sizes{alternatives<Vs>...};
+    size_t rest = Flat;
+    for (size_t k = sizeof...(Vs); k-- > I + 1;) {
+        rest /= sizes[k];
+    }
+    return rest % sizes[I];
+}
+
+template<size_t Flat, typename F, size_t... I, typename... Vs>
+constexpr decltype(auto) invoke_combination(std::index_sequence<I...>, F&& f, Vs&&... vs) {
+    return std::invoke(std::forward<F>(f), std::get<alternative_of<Flat, I, Vs...>()>(std::forward<Vs>(vs))...);
+}
+
+template<size_t Flat, typename F, typename... Vs>
+constexpr decltype(auto) invoke_combination(F&& f, Vs&&... vs) {
+    return invoke_combination<Flat>(std::index_sequence_for<Vs...>{}, std::forward<F>(f), std::forward<Vs>(vs)...);
+}
+
+// 16 cases per switch, larger visits chain into the next block from the default case
+template<typename R, size_t Base, typename F, typename... Vs>
+constexpr R visit_switch(size_t flat, F&& f, Vs&&... vs) {
+    constexpr size_t total = combinations<Vs...>;
+    auto call = [&]<size_t K>() -> R {
+        if constexpr (Base + K < total) {
+            return invoke_combination<Base + K>(std::forward<F>(f), std::forward<Vs>(vs)...);
+        } else {
+            std::unreachable();
+        }
+    };
+    switch (flat - Base) {
+        case 0: return call.template operator()<0>();
+        case 1: return call.template operator()<1>();
+        case 2: return call.template operator()<2>();
+        case 3: return call.template operator()<3>();
+        case 4: return call.template operator()<4>();
+        case 5: return call.template operator()<5>();
+        case 6: return call.template operator()<6>();
+        case 7: return call.template operator()<7>();
+        case 8: return call.template operator()<8>();
+        case 9: return call.template operator()<9>();
+        case 10: return call.template operator()<10>();
+        case 11: return call.template operator()<11>();
+        case 12: return call.template operator()<12>();
+        case 13: return call.template operator()<13>();
+        case 14: return call.template operator()<14>();
+        case 15: return call.template operator()<15>();
+        default:
+            if constexpr (Base + 16 < total) {
+                return visit_switch<R, Base + 16>(flat, std::forward<F>(f), std::forward<Vs>(vs)...);
+            } else {
+                std::unreachable();
+            }
+    }
+}
+
+}// namespace impl
+
+/**
+ * @brief std::visit with one switch over the combined index of all variants
+ * @details the switch compiles to a single jump table whose cases call f directly, where std::visit may go through a
+ * table of function pointers that the compiler cannot inline. Variants with a single alternative, like one that only
+ * carries an extra argument, add no cases. Throws std::bad_variant_access if a variant is valueless.
+ */
+template<typename F, typename... Vs>
+constexpr decltype(auto) visit(F&& f, Vs&&... vs) {
+    using R = decltype(impl::invoke_combination<0>(std::forward<F>(f), std::forward<Vs>(vs)...));
+    if ((vs.valueless_by_exception() || ...)) {
+        throw std::bad_variant_access();
+    }
+    size_t flat = 0;
+    ((flat = flat * impl::alternatives<Vs> + vs.index()), ...);
+    return impl::visit_switch<R, 0>(flat, std::forward<F>(f), std::forward<Vs>(vs)...);
+}
+
+}// namespace cr::util
@@ -0,0 +1,17 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// like assert, but also checked in release builds
+#define CR_CHECK(condition)                                                                                      \
+    do {                                                                                                         \
+        if (!(condition)) {                                                                                      \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl;              \
+            std::exit(1);                                                                                        \
+        }                                                                                                        \
+    } while (false)
@@ -0,0 +1,24 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include <iostream>
+
+void thread_pool_test();
+void ring_test();
+void small_vector_test();
+void flat_hash_map_test();
+void slot_map_test();
+void task_test();
+void file_test();
+
+int main() {
+    thread_pool_test();
+    ring_test();
+    small_vector_test();
+    flat_hash_map_test();
+    slot_map_test();
+    task_test();
+    file_test();
+    std::cout << "all crutil tests passed" << std::endl;
+}
@@ -0,0 +1,117 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/file.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace cr::util;
+
+namespace {
+
+struct test_files {
+    std::filesystem::path dir;
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::string> contents;
+
+    test_files() : dir(std::filesystem::temp_directory_path() / ("crutil_file_test_" + std::to_string(::getpid()))) {
+        std::filesystem::create_directories(dir);
+        std::mt19937 rng(7);
+        // empty, tiny, around a page and larger than several reads of 4 KiB
+        std::vector<size_t> sizes{0, 1, 4095, 4096, 4097, 100000};
+        for (int i = 0; i < 54; i++) {
+            sizes.push_back(rng() % 20000);
+        }
+        for (size_t i = 0; i < sizes.size(); i++) {
+            std::string data(sizes[i], '\0');
+            std::generate(data.begin(), data.end(), [&] { return char(rng()); });
+            paths.push_back(dir / ("file" + std::to_string(i)));
+            std::ofstream(paths.back(), std::ios::binary).write(data.data(), std::streamsize(data.size()));
+            contents.push_back(std::move(data));
+        }
+    }
+
+    ~test_files() {
+        std::filesystem::remove_all(dir);
+    }
+};
+
+bool same(std::span<const std::byte> bytes, const std::string& expected) {
+    return bytes.size() == expected.size() &&
+           (expected.empty() || std::memcmp(bytes.data(), expected.data(), expected.size()) == 0);
+}
+
+std::string wait_error(file_batch& batch) {
+    try {
+        batch.wait();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return {};
+}
+
+}// namespace
+
+static void whole_files(const test_files& files) {
+    for (size_t i = 0; i < files.paths.size(); i++) {
+        CR_CHECK(same(read_file(files.paths[i]).bytes(), files.contents[i]));
+        CR_CHECK(same(mapped_file(files.paths[i]).bytes(), files.contents[i]));
+    }
+    CR_CHECK(mapped_file(files.paths[0]).empty());
+    mapped_file page(files.paths[3]);
+    CR_CHECK(view_as<uint32_t>(page.bytes()).size() == 1024);
+    bool threw = false;
+    try {
+        (void) view_as<uint32_t>(page.bytes().subspan(1, 8));
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CR_CHECK(threw);
+    std::cout << "file:            read_file and mapped_file match" << std::endl;
+}
+
+// more files than the queue depth wait in line, reads capped at 4 KiB resubmit the rest of the file
+static void batches(thread_pool& pool, const test_files& files, bool io_uring) {
+    file_reader reader(pool, {.queue_depth = 4, .io_uring = io_uring, .max_read = 4096});
+    const char* mode = reader.uses_io_uring() ? "io_uring" : "thread pool";
+    if (io_uring && !reader.uses_io_uring()) {
+        std::cout << "file:            no io_uring, skipped" << std::endl;
+        return;
+    }
+
+    auto batch = reader.read(files.paths);
+    batch.wait();
+    CR_CHECK(batch.ready() && batch.size() == files.paths.size());
+    for (size_t i = 0; i < files.paths.size(); i++) {
+        CR_CHECK(same(batch[i].bytes(), files.contents[i]));
+    }
+    auto buffers = batch.release();
+    CR_CHECK(buffers[0].empty() && same(buffers[5].bytes(), files.contents[5]));
+
+    // a missing file and a directory, which opens but can not be read
+    auto missing = files.dir / "missing";
+    auto failing = reader.read({files.paths[1], missing, files.paths[5]});
+    CR_CHECK(wait_error(failing).find(missing.string()) != std::string::npos);
+    auto directory = reader.read({files.dir});
+    CR_CHECK(wait_error(directory).find("failed to read") != std::string::npos);
+
+    // destroyed while reading
+    for (int i = 0; i < 8; i++) {
+        auto unwaited = reader.read(files.paths);
+    }
+    std::cout << "file:            batches read through " << mode << std::endl;
+}
+
+void file_test() {
+    thread_pool pool({2});
+    test_files files;
+    whole_files(files);
+    batches(pool, files, true);
+    batches(pool, files, false);
+}
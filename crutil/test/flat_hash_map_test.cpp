@@ -0,0 +1,155 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/flat_hash_map.h"
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using namespace cr::util;
+
+namespace {
+
+// few distinct hashes, so probing runs over full groups and tombstones
+struct colliding_hash {
+    size_t operator()(int key) const { return size_t(key % 37); }
+};
+
+struct throwing_value {
+    static inline bool fail = false;
+
+    int value;
+
+    explicit throwing_value(int value) : value(value) {
+        if (fail) {
+            throw std::runtime_error("value failed");
+        }
+    }
+};
+
+template<typename Map>
+bool same(const Map& map, const std::unordered_map<int, std::string>& ref) {
+    if (map.size() != ref.size()) {
+        return false;
+    }
+    size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        auto it = ref.find(key);
+        if (it == ref.end() || it->second != value) {
+            return false;
+        }
+        visited++;
+    }
+    return visited == ref.size();
+}
+
+}// namespace
+
+// random operations on a flat_hash_map and a std::unordered_map have to leave both with the same entries
+template<typename Hash>
+static void differential(const char* name) {
+    std::mt19937 rng(4321);
+    constexpr int steps = 200000;
+    flat_hash_map<int, std::string, Hash> map;
+    std::unordered_map<int, std::string> ref;
+    for (int step = 0; step < steps; step++) {
+        int key = int(rng() % 2000);
+        auto value = std::to_string(rng() % 100);
+        switch (rng() % 10) {
+            case 0:
+            case 1: {
+                auto [it, inserted] = map.try_emplace(key, value);
+                auto [ref_it, ref_inserted] = ref.try_emplace(key, value);
+                CR_CHECK(inserted == ref_inserted && it->second == ref_it->second);
+                break;
+            }
+            case 2:
+                map.insert_or_assign(key, value);
+                ref.insert_or_assign(key, value);
+                break;
+            case 3:
+                map[key] += value;
+                ref[key] += value;
+                break;
+            case 4:
+            case 5:
+                CR_CHECK(map.erase(key) == ref.erase(key));
+                break;
+            case 6:
+                if (auto it = map.find(key); it != map.end()) {
+                    map.erase(it);
+                    ref.erase(key);
+                }
+                break;
+            case 7:
+                CR_CHECK(map.contains(key) == ref.contains(key));
+                CR_CHECK(map.count(key) == ref.count(key));
+                if (ref.contains(key)) {
+                    CR_CHECK(map.at(key) == ref.at(key));
+                }
+                break;
+            case 8:
+                if (rng() % 64 == 0) {
+                    flat_hash_map<int, std::string, Hash> copy(map);
+                    CR_CHECK(same(copy, ref));
+                    flat_hash_map<int, std::string, Hash> moved(std::move(copy));
+                    map = moved;
+                    map.swap(moved);
+                    map = std::move(moved);
+                }
+                break;
+            case 9:
+                if (rng() % 1024 == 0) {
+                    map.clear();
+                    ref.clear();
+                } else if (rng() % 64 == 0) {
+                    map.reserve(rng() % 4096);
+                }
+                break;
+        }
+        CR_CHECK(map.size() == ref.size());
+    }
+    CR_CHECK(same(map, ref));
+    std::cout << "flat_hash_map:   " << steps << " operations match std::unordered_map (" << name << ")" << std::endl;
+}
+
+// a value constructor that throws leaves no half inserted entry behind
+static void throwing_value_ctor() {
+    flat_hash_map<int, throwing_value> map;
+    for (int i = 0; i < 100; i++) {
+        map.try_emplace(i, i);
+    }
+    throwing_value::fail = true;
+    for (int i = 100; i < 200; i++) {
+        bool threw = false;
+        try {
+            map.try_emplace(i, i);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CR_CHECK(threw);
+        CR_CHECK(!map.contains(i));
+    }
+    throwing_value::fail = false;
+    CR_CHECK(map.size() == 100);
+    size_t visited = 0;
+    for (const auto& [key, value] : map) {
+        CR_CHECK(key == value.value && key < 100);
+        visited++;
+    }
+    CR_CHECK(visited == 100);
+    for (int i = 100; i < 200; i++) {
+        CR_CHECK(map.try_emplace(i, i).second);
+    }
+    CR_CHECK(map.size() == 200);
+    std::cout << "flat_hash_map:   throwing value constructor leaves no entry" << std::endl;
+}
+
+void flat_hash_map_test() {
+    differential<std::hash<int>>("std::hash");
+    differential<colliding_hash>("colliding hash");
+    throwing_value_ctor();
+}
@@ -0,0 +1,156 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/ring.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace cr::util;
+
+// values come out in order, single and span push/pop mixed, with a move only type
+static void spsc_order() {
+    constexpr size_t items = 500000;
+    spsc_ring<std::unique_ptr<size_t>> ring(64);
+    CR_CHECK(ring.capacity() == 64);
+    std::thread producer([&] {
+        std::vector<std::unique_ptr<size_t>> batch;
+        size_t next = 0;
+        while (next < items) {
+            if (next % 2 == 0) {
+                if (ring.try_push(std::make_unique<size_t>(next))) {
+                    next++;
+                } else {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+            batch.clear();
+            for (size_t i = next; i < std::min(items, next + 7); i++) {
+                batch.push_back(std::make_unique<size_t>(i));
+            }
+            size_t pushed = ring.try_push(std::span(batch));
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            next += pushed;
+        }
+    });
+    size_t expected = 0;
+    std::vector<std::unique_ptr<size_t>> out(5);
+    while (expected < items) {
+        if (expected % 3 == 0) {
+            if (auto value = ring.try_pop()) {
+                CR_CHECK(**value == expected);
+                expected++;
+            } else {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+        size_t count = ring.try_pop(std::span(out));
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; i++) {
+            CR_CHECK(*out[i] == expected);
+            expected++;
+        }
+    }
+    producer.join();
+    CR_CHECK(ring.empty());
+    std::cout << "spsc_ring:       " << items << " values in order" << std::endl;
+}
+
+// every value comes out exactly once, and values of one producer reach a consumer in the order they were pushed
+static void mpmc_exactly_once() {
+    constexpr size_t producers = 3;
+    constexpr size_t consumers = 3;
+    constexpr size_t per_producer = 100000;
+    mpmc_queue<size_t> queue(128);
+    std::vector<std::atomic<int>> taken(producers * per_producer);
+    std::atomic<size_t> consumed{0};
+    std::atomic<bool> order_ok{true};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&, p] {
+            for (size_t i = 0; i < per_producer; i++) {
+                while (!queue.try_push(p * per_producer + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; c++) {
+        threads.emplace_back([&] {
+            std::vector<size_t> last(producers, 0);
+            std::vector<bool> seen(producers, false);
+            while (consumed.load(std::memory_order_relaxed) < producers * per_producer) {
+                auto value = queue.try_pop();
+                if (!value) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                size_t producer = *value / per_producer;
+                if (seen[producer] && *value <= last[producer]) {
+                    order_ok.store(false, std::memory_order_relaxed);
+                }
+                seen[producer] = true;
+                last[producer] = *value;
+                taken[*value].fetch_add(1, std::memory_order_relaxed);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CR_CHECK(order_ok.load());
+    for (auto& count : taken) {
+        CR_CHECK(count.load() == 1);
+    }
+    CR_CHECK(queue.empty());
+    std::cout << "mpmc_queue:      " << producers * per_producer << " values taken once" << std::endl;
+}
+
+// a value constructor that throws must not claim a cell
+static void mpmc_throwing_emplace() {
+    struct value {
+        std::string text;
+
+        explicit value(int i) : text(std::to_string(i)) {
+            if (i < 0) {
+                throw std::runtime_error("value failed");
+            }
+        }
+    };
+    mpmc_queue<value> queue(4);
+    CR_CHECK(queue.try_emplace(1));
+    CR_CHECK(queue.try_emplace(2));
+    bool threw = false;
+    try {
+        queue.try_emplace(-1);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CR_CHECK(threw);
+    CR_CHECK(queue.size() == 2);
+    CR_CHECK(queue.try_emplace(3));
+    for (const char* expected : {"1", "2", "3"}) {
+        auto v = queue.try_pop();
+        CR_CHECK(v && v->text == expected);
+    }
+    CR_CHECK(!queue.try_pop() && queue.empty());
+    std::cout << "mpmc_queue:      throwing emplace leaves the queue usable" << std::endl;
+}
+
+void ring_test() {
+    spsc_order();
+    mpmc_exactly_once();
+    mpmc_throwing_emplace();
+}
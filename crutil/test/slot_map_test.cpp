@@ -0,0 +1,122 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/slot_map.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace cr::util;
+
+// erase moves the last value into the gap, handles of moved values stay valid and stale handles fail
+static void swap_with_last() {
+    slot_map<int> map;
+    auto a = map.insert(1);
+    auto b = map.insert(2);
+    auto c = map.insert(3);
+    auto d = map.insert(4);
+    CR_CHECK(map.erase(b));
+    CR_CHECK(!map.erase(b));
+    CR_CHECK(!map.contains(b) && map.get(b) == nullptr);
+    CR_CHECK((std::vector<int>(map.begin(), map.end()) == std::vector<int>{1, 4, 3}));
+    CR_CHECK(map[a] == 1 && map[c] == 3 && map[d] == 4);
+    CR_CHECK(map.handle_at(1) == d);
+    // the freed slot is reused with a new generation, the old handle stays invalid
+    auto e = map.insert(5);
+    CR_CHECK(e.index == b.index && e.generation != b.generation);
+    CR_CHECK(!map.contains(b) && map[e] == 5);
+    CR_CHECK(!map.contains(slot_handle<int>{}));
+    CR_CHECK(map.take(a) == 1 && map.size() == 3);
+    map.clear();
+    CR_CHECK(map.empty() && !map.contains(c) && !map.contains(d) && !map.contains(e));
+    std::cout << "slot_map:        erase moves the last value, handles follow" << std::endl;
+}
+
+// random inserts and erases, every live handle finds its value and every erased one fails
+static void random_handles() {
+    std::mt19937 rng(99);
+    slot_map<int> map;
+    std::vector<std::pair<slot_handle<int>, int>> live;
+    std::vector<slot_handle<int>> dead;
+    for (int step = 0; step < 100000; step++) {
+        if (live.empty() || rng() % 3 != 0) {
+            int value = int(rng());
+            live.emplace_back(map.insert(value), value);
+        } else {
+            size_t i = rng() % live.size();
+            CR_CHECK(map.erase(live[i].first));
+            dead.push_back(live[i].first);
+            live[i] = live.back();
+            live.pop_back();
+        }
+        if (step % 1000 == 0) {
+            CR_CHECK(map.size() == live.size());
+            for (auto& [h, value] : live) {
+                CR_CHECK(map.get(h) != nullptr && *map.get(h) == value);
+            }
+            for (auto h : dead) {
+                CR_CHECK(!map.contains(h));
+            }
+            for (size_t i = 0; i < map.size(); i++) {
+                CR_CHECK(map[map.handle_at(i)] == map.values()[i]);
+            }
+        }
+    }
+    std::cout << "slot_map:        " << live.size() << " live and " << dead.size() << " erased handles checked"
+              << std::endl;
+}
+
+// a slot whose generation wraps around is retired, so no handle of it can become valid again
+static void generation_wrap() {
+    slot_map<int, uint8_t> map;
+    std::vector<slot_handle<int, uint8_t>> old;
+    for (int i = 0; i < 255; i++) {
+        auto h = map.insert(i);
+        CR_CHECK(h.index == 0 && h.generation == i + 1);
+        old.push_back(h);
+        map.erase(h);
+    }
+    auto fresh = map.insert(255);
+    CR_CHECK(fresh.index == 1 && fresh.generation == 1);
+    for (auto h : old) {
+        CR_CHECK(!map.contains(h));
+    }
+    std::cout << "slot_map:        wrapped slot is retired" << std::endl;
+}
+
+// a throwing constructor takes no slot
+static void throwing_emplace() {
+    struct value {
+        explicit value(bool fail) {
+            if (fail) {
+                throw std::runtime_error("value failed");
+            }
+        }
+    };
+    slot_map<value> map;
+    auto h = map.emplace(false);
+    map.erase(h);
+    for (int i = 0; i < 20; i++) {
+        bool threw = false;
+        try {
+            map.emplace(true);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CR_CHECK(threw && map.empty());
+    }
+    auto reused = map.emplace(false);
+    CR_CHECK(reused.index == h.index && reused.generation == h.generation + 1);
+    auto next = map.emplace(false);
+    CR_CHECK(next.index == 1 && map.size() == 2);
+    std::cout << "slot_map:        throwing emplace takes no slot" << std::endl;
+}
+
+void slot_map_test() {
+    swap_with_last();
+    random_handles();
+    generation_wrap();
+    throwing_emplace();
+}
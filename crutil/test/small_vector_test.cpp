@@ -0,0 +1,163 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/small_vector.h"
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace cr::util;
+
+namespace {
+
+// counts live instances so leaks and double destroys show up, copies throw on request
+struct tracked {
+    static inline int live = 0;
+    static inline int copies_until_throw = -1;
+
+    int value;
+
+    explicit tracked(int value) : value(value) { live++; }
+    tracked(const tracked& other) : value(other.value) {
+        if (copies_until_throw == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        if (copies_until_throw > 0) {
+            copies_until_throw--;
+        }
+        live++;
+    }
+    // not noexcept, so growing copies like std::vector does
+    tracked(tracked&& other) : value(other.value) { live++; }
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&) = default;
+    ~tracked() { live--; }
+
+    bool operator==(const tracked&) const = default;
+};
+
+template<typename A, typename B>
+bool same(const A& a, const B& b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+}// namespace
+
+// random operations on a small_vector and a std::vector have to leave both with the same elements
+static void differential() {
+    std::mt19937 rng(1234);
+    constexpr int steps = 200000;
+    {
+        small_vector<tracked, 4> vec;
+        std::vector<tracked> ref;
+        for (int step = 0; step < steps; step++) {
+            int value = int(rng() % 1000);
+            switch (rng() % 12) {
+                case 0:
+                case 1:
+                    vec.emplace_back(value);
+                    ref.emplace_back(value);
+                    break;
+                case 2:
+                    if (!ref.empty()) {
+                        // may alias an element while growing
+                        vec.push_back(vec[0]);
+                        ref.push_back(ref[0]);
+                    }
+                    break;
+                case 3:
+                    if (!ref.empty()) {
+                        vec.pop_back();
+                        ref.pop_back();
+                    }
+                    break;
+                case 4: {
+                    size_t pos = ref.empty() ? 0 : rng() % (ref.size() + 1);
+                    vec.insert(vec.begin() + pos, tracked(value));
+                    ref.insert(ref.begin() + std::ptrdiff_t(pos), tracked(value));
+                    break;
+                }
+                case 5:
+                    if (!ref.empty()) {
+                        size_t pos = rng() % ref.size();
+                        vec.erase(vec.begin() + pos);
+                        ref.erase(ref.begin() + std::ptrdiff_t(pos));
+                    }
+                    break;
+                case 6:
+                    if (!ref.empty()) {
+                        size_t first = rng() % ref.size();
+                        size_t last = first + rng() % (ref.size() - first + 1);
+                        vec.erase(vec.begin() + first, vec.begin() + last);
+                        ref.erase(ref.begin() + std::ptrdiff_t(first), ref.begin() + std::ptrdiff_t(last));
+                    }
+                    break;
+                case 7: {
+                    size_t n = rng() % 24;
+                    vec.resize(n, tracked(value));
+                    ref.resize(n, tracked(value));
+                    break;
+                }
+                case 8: {
+                    small_vector<tracked, 4> copy(vec);
+                    CR_CHECK(copy == vec);
+                    small_vector<tracked, 4> moved(std::move(copy));
+                    vec = std::move(moved);
+                    break;
+                }
+                case 9: {
+                    small_vector<tracked, 4> other;
+                    other = vec;
+                    vec = other;
+                    break;
+                }
+                case 10:
+                    vec.reserve(rng() % 32);
+                    break;
+                case 11:
+                    if (rng() % 16 == 0) {
+                        vec.clear();
+                        ref.clear();
+                    }
+                    break;
+            }
+            CR_CHECK(same(vec, ref));
+            CR_CHECK(vec.is_inline() == (vec.capacity() == 4));
+        }
+        CR_CHECK(tracked::live == int(vec.size() + ref.size()));
+    }
+    CR_CHECK(tracked::live == 0);
+    std::cout << "small_vector:    " << steps << " operations match std::vector" << std::endl;
+}
+
+// a copy that throws while growing leaves the vector as it was and leaks nothing
+static void throwing_growth() {
+    {
+        small_vector<tracked, 2> vec;
+        vec.emplace_back(1);
+        vec.emplace_back(2);
+        tracked extra(3);
+        // the new element is copied first, the second copy of an old element throws
+        tracked::copies_until_throw = 2;
+        bool threw = false;
+        try {
+            vec.push_back(extra);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        tracked::copies_until_throw = -1;
+        CR_CHECK(threw);
+        CR_CHECK(vec.size() == 2 && vec[0].value == 1 && vec[1].value == 2);
+        CR_CHECK(vec.is_inline());
+        CR_CHECK(tracked::live == 3);
+    }
+    CR_CHECK(tracked::live == 0);
+    std::cout << "small_vector:    throwing growth leaves no trace" << std::endl;
+}
+
+void small_vector_test() {
+    differential();
+    throwing_growth();
+}
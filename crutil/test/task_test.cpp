@@ -0,0 +1,158 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/task.h"
+#include <chrono>
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+
+using namespace cr::util;
+
+namespace {
+
+struct flag {
+    int polls_left;
+
+    bool ready() {
+        return --polls_left <= 0;
+    }
+};
+
+task<long> depth(long n) {
+    if (n == 0) {
+        co_return 0;
+    }
+    co_return 1 + co_await depth(n - 1);
+}
+
+task<> deep_chain(long n, long& out) {
+    out = co_await depth(n);
+}
+
+task<int> fails(const char* message) {
+    throw std::runtime_error(message);
+    co_return 0;
+}
+
+task<> catches(std::string& out) {
+    try {
+        co_await fails("inner");
+    } catch (const std::runtime_error& e) {
+        out = e.what();
+    }
+}
+
+task<> fails_after_until(scheduler& sched, flag& f) {
+    co_await sched.until(f);
+    co_await fails("after until");
+}
+
+task<> offload_value(scheduler& sched, thread_pool& pool, int& out) {
+    out = co_await sched.offload(pool, [] { return 42; });
+    co_await sched.schedule();
+    co_await sched.offload(pool, [&out] { out++; });
+}
+
+task<> offload_caught(scheduler& sched, thread_pool& pool, std::string& out) {
+    try {
+        co_await sched.offload(pool, []() -> int { throw std::runtime_error("offloaded"); });
+    } catch (const std::runtime_error& e) {
+        out = e.what();
+    }
+}
+
+task<> offload_uncaught(scheduler& sched, thread_pool& pool) {
+    co_await sched.offload(pool, [] { throw std::runtime_error("offloaded uncaught"); });
+}
+
+task<> offload_slow(scheduler& sched, thread_pool& pool, bool& resumed) {
+    co_await sched.offload(pool, [] { std::this_thread::sleep_for(std::chrono::milliseconds(50)); });
+    resumed = true;
+}
+
+task<> untracked() {
+    co_await std::suspend_always{};
+}
+
+// rethrows what the scheduler throws, for CR_CHECK
+template<typename F>
+std::string thrown(F f) {
+    try {
+        f();
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return {};
+}
+
+}// namespace
+
+// each await is a tail call into the awaited task and back, so a deep chain needs no deep stack. GCC only emits those
+// tail calls from -O2 on and never with sanitizers, elsewhere the chain stays shallow enough for the stack
+static void symmetric_transfer() {
+#if defined(NDEBUG) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+    constexpr long n = 1'000'000;
+#else
+    constexpr long n = 10'000;
+#endif
+    scheduler sched;
+    long out = -1;
+    sched.spawn(deep_chain(n, out));
+    sched.run();
+    CR_CHECK(out == n);
+    std::cout << "task:            " << n << " nested awaits" << std::endl;
+}
+
+static void exceptions() {
+    scheduler sched;
+    std::string caught;
+    sched.spawn(catches(caught));
+    sched.run();
+    CR_CHECK(caught == "inner");
+
+    // through root, after until()
+    flag f{3};
+    sched.spawn(fails_after_until(sched, f));
+    CR_CHECK(thrown([&] { sched.run(); }) == "after until");
+    CR_CHECK(sched.pending() == 0);
+
+    // through offload()
+    thread_pool pool({2});
+    sched.spawn(offload_caught(sched, pool, caught));
+    sched.run();
+    CR_CHECK(caught == "offloaded");
+    sched.spawn(offload_uncaught(sched, pool));
+    CR_CHECK(thrown([&] { sched.run(); }) == "offloaded uncaught");
+
+    int value = 0;
+    sched.spawn(offload_value(sched, pool, value));
+    sched.run();
+    CR_CHECK(value == 43);
+
+    // nothing tracked can resume the task
+    sched.spawn(untracked());
+    CR_CHECK(!thrown([&] { sched.run(); }).empty());
+    std::cout << "task:            exceptions reach the awaiting task and run()" << std::endl;
+}
+
+// destroying the scheduler waits for the offloaded function, then destroys the suspended task
+static void destroy_with_offloaded() {
+    thread_pool pool({1});
+    bool resumed = false;
+    {
+        scheduler sched;
+        sched.spawn(offload_slow(sched, pool, resumed));
+        CR_CHECK(sched.poll());
+    }
+    CR_CHECK(!resumed);
+    std::cout << "task:            destroyed with offloaded work pending" << std::endl;
+}
+
+void task_test() {
+    symmetric_transfer();
+    exceptions();
+    destroy_with_offloaded();
+}
@@ -0,0 +1,90 @@
+//
+// Created by nudelerde on 18.10.26.
+//
+
+#include "check.h"
+#include "crutil/thread_pool.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace cr::util;
+
+// the owner pushes and pops while thieves steal, every item has to come out exactly once
+static void deque_stress() {
+    constexpr int64_t items = 200000;
+    impl::work_stealing_deque<int64_t> deque(4);
+    std::vector<std::atomic<int>> taken(items);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; i++) {
+        thieves.emplace_back([&] {
+            int64_t item;
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (deque.steal(item)) {
+                    taken[size_t(item)].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    int64_t item;
+    for (int64_t i = 0; i < items; i++) {
+        deque.push(i);
+        if (i % 3 == 0 && deque.pop(item)) {
+            taken[size_t(item)].fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    while (deque.pop(item)) {
+        taken[size_t(item)].fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+    for (auto& count : taken) {
+        CR_CHECK(count.load() == 1);
+    }
+    std::cout << "deque:           " << items << " items taken once" << std::endl;
+}
+
+static void parallel_for_coverage() {
+    thread_pool pool({4});
+    constexpr size_t count = 1'000'000;
+    std::vector<std::atomic<uint8_t>> visits(count);
+    parallel_for(pool, 0, count, 1000, [&](size_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+    for (auto& v : visits) {
+        CR_CHECK(v.load() == 1);
+    }
+
+    // nested, every outer index runs an inner parallel_for from inside a task
+    std::atomic<size_t> inner{0};
+    parallel_for(pool, 0, 64, 1, [&](size_t) {
+        parallel_for(pool, 0, 1000, 10, [&](size_t first, size_t last) {
+            inner.fetch_add(last - first, std::memory_order_relaxed);
+        });
+    });
+    CR_CHECK(inner.load() == 64 * 1000);
+
+    task_group group(pool);
+    for (int i = 0; i < 100; i++) {
+        group.run([i] {
+            if (i == 42) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }
+    bool threw = false;
+    try {
+        group.wait();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CR_CHECK(threw);
+    std::cout << "parallel_for:    " << count << " indices visited once" << std::endl;
+}
+
+void thread_pool_test() {
+    deque_stress();
+    parallel_for_coverage();
+}
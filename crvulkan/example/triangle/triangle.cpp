@@ -8,10 +8,11 @@ constexpr auto MAX_FRAMES_IN_FLIGHT = 2;
 
 #include "crmath/geometry.h"
 #include "crmath/matrix.h"
+#include "crmath/mesh.h"
+#include "crutil/file.h"
 #include "crvulkan/vulkan.h"
 #include "crvulkan/window.h"
 #include <chrono>
-#include <fstream>
 
 struct Uniform {
     cr::math::matrix<float, 4, 4> model;
@@ -53,12 +54,10 @@ int main() {
                                                     swapChainInfo.choosePresentMode(),
                                                     swapChainInfo.chooseSurfaceFormat(),
                                                     swapChainInfo.capabilities.minImageCount + 1);
-    std::ifstream vert_file("./triangle_vert.spv", std::ios::binary);
-    std::ifstream frag_file("./triangle_frag.spv", std::ios::binary);
-    std::vector<char> vert_code((std::istreambuf_iterator<char>(vert_file)), std::istreambuf_iterator<char>());
-    std::vector<char> frag_code((std::istreambuf_iterator<char>(frag_file)), std::istreambuf_iterator<char>());
-    auto vert_shader_module = logicalDevice->createShaderModule(vert_code);
-    auto frag_shader_module = logicalDevice->createShaderModule(frag_code);
+    cr::util::mapped_file vert_code("./triangle_vert.spv");
+    cr::util::mapped_file frag_code("./triangle_frag.spv");
+    auto vert_shader_module = logicalDevice->createShaderModule(vert_code.bytes());
+    auto frag_shader_module = logicalDevice->createShaderModule(frag_code.bytes());
 
     auto attributeDescription = Vertex::getAttributeDescriptions();
     auto bindingDescription = std::array<cr::vulkan::VertexInputBindingDescription, 1>{Vertex::getBindingDescription()};
@@ -77,15 +76,20 @@ int main() {
     auto framebuffers = logicalDevice->createFramebuffers(swapChain, pipeline);
     auto commandPool = logicalDevice->createCommandPool(logicalDevice->graphicsQueue);
 
-    std::array<Vertex, 6> vertexData{
+    // a triangle soup as it would come from a tool, deduplicated and ordered for the vertex cache
+    std::array<Vertex, 6> soup{
             Vertex{cr::math::cvector<float, 2>{-0.5f, -0.5f}, cr::math::cvector<float, 3>{0.0f, 0.0f, 0.0f}},
             Vertex{cr::math::cvector<float, 2>{0.5f, -0.5f}, cr::math::cvector<float, 3>{1.0f, 0.0f, 0.0f}},
             Vertex{cr::math::cvector<float, 2>{-0.5f, 0.5f}, cr::math::cvector<float, 3>{0.0f, 1.0f, 0.0f}},
             Vertex{cr::math::cvector<float, 2>{0.5f, 0.5f}, cr::math::cvector<float, 3>{1.0f, 1.0f, 0.0f}},
+            Vertex{cr::math::cvector<float, 2>{-0.5f, 0.5f}, cr::math::cvector<float, 3>{0.0f, 1.0f, 0.0f}},
+            Vertex{cr::math::cvector<float, 2>{0.5f, -0.5f}, cr::math::cvector<float, 3>{1.0f, 0.0f, 0.0f}},
     };
-
-    std::array<uint32_t, 6> indexData{
-            0, 1, 2, 3, 2, 1};
+    auto mesh = cr::math::deduplicate(std::span<const Vertex>(soup));
+    cr::math::optimize_vertex_cache(mesh.indices, mesh.vertices.size());
+    cr::math::optimize_vertex_fetch(mesh);
+    auto& vertexData = mesh.vertices;
+    auto indexData = cr::math::compact_indices(mesh.indices).value();
 
     struct Pixel {
         char r;
@@ -144,7 +148,8 @@ int main() {
         uniformPool->bindSampler(sampler, image, setIndex, 0, 1);
         buffer.reset();
         cr::vulkan::prepareCommandBuffer(buffer, pipeline, swapChain, framebuffers->getFramebuffer(imageIndex),
-                                         indexData.size(), vertexBuffers, indexBuffer, uniformPool->getSet(setIndex));
+                                         indexData.size(), vertexBuffers, indexBuffer, uniformPool->getSet(setIndex),
+                                         vk::IndexType::eUint16);
         return res;
     };
     auto recreatePipeline = [&]() {
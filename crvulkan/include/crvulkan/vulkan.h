@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "crutil/slot_map.h"
+#include "crutil/trace.h"
 #include <functional>
 #include <memory>
 #include <optional>
@@ -43,6 +45,32 @@ constexpr auto eUIntVec3 = vk::Format::eR32G32B32Uint;
 constexpr auto eUIntVec4 = vk::Format::eR32G32B32A32Uint;
 }// namespace VertexAttributeFormat
 
+/*
+ * Handle based resources, an alternative to the shared_ptr objects for code that references many of them per frame.
+ * They are owned by their LogicalDevice and live until LogicalDevice::destroy or the end of the device. A handle is
+ * 8 bytes and copies without refcounting, LogicalDevice::get detects handles of destroyed resources.
+ * Creating, destroying and resolving handles is not thread safe.
+ */
+struct BufferResource {
+    vk::Buffer buffer;
+    vk::DeviceMemory memory;
+    vk::DeviceSize size{};
+};
+
+struct ImageResource {
+    vk::Image image;
+    vk::ImageView imageView;
+    vk::DeviceMemory memory;
+    size_t width{};
+    size_t height{};
+    vk::Format format{};
+};
+
+using BufferHandle = cr::util::slot_handle<BufferResource>;
+using ImageHandle = cr::util::slot_handle<ImageResource>;
+using FenceHandle = cr::util::slot_handle<vk::Fence>;
+using SemaphoreHandle = cr::util::slot_handle<vk::Semaphore>;
+
 struct StagingBufferUpload {
     std::shared_ptr<Buffer> stagingBuffer{};
     std::shared_ptr<CommandPool> commandPool{};
@@ -57,6 +85,11 @@ struct StagingBufferUpload {
     ~StagingBufferUpload();
     void wait();
 
+    /**
+     * @brief true once the upload finished on the GPU, does not block, so it can be awaited with cr::util::scheduler::until
+     */
+    [[nodiscard]] bool ready() const;
+
     static void waitAll(const std::span<std::shared_ptr<StagingBufferUpload>>& uploads);
 };
 
@@ -107,6 +140,9 @@ struct Fence {
 
     void wait();
 
+    // true once the fence is signaled, does not block
+    [[nodiscard]] bool ready() const;
+
     void reset();
 
     vk::Fence fence;
@@ -432,6 +468,12 @@ struct LogicalDevice : public std::enable_shared_from_this<LogicalDevice> {
 
     std::shared_ptr<ShaderModule> createShaderModule(const std::vector<char>& bytecode);
 
+    /**
+     * @brief creates a shader module straight from SPIR-V in memory, e.g. a cr::util::mapped_file
+     * @details bytecode has to be 4 byte aligned and a multiple of 4 bytes long
+     */
+    std::shared_ptr<ShaderModule> createShaderModule(std::span<const std::byte> bytecode);
+
     std::shared_ptr<Pipeline> createPipeline(std::span<ShaderDescriptor> shaders,
                                              vk::PrimitiveTopology topology,
                                              vk::Format format,
@@ -456,6 +498,33 @@ struct LogicalDevice : public std::enable_shared_from_this<LogicalDevice> {
 
     std::shared_ptr<UniformPool> createUniformPool(uint32_t uniforms, uint32_t samplers, uint32_t poolSize, const std::shared_ptr<Pipeline>& pipeline);
 
+    BufferHandle createBufferHandle(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties);
+    ImageHandle createImageHandle(size_t width, size_t height, vk::Format format, vk::ImageTiling tiling,
+                                  vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties);
+    FenceHandle createFenceHandle(bool signaled = false);
+    SemaphoreHandle createSemaphoreHandle();
+
+    // destroying a null or already destroyed handle does nothing
+    void destroy(BufferHandle handle);
+    void destroy(ImageHandle handle);
+    void destroy(FenceHandle handle);
+    void destroy(SemaphoreHandle handle);
+
+    // throw std::runtime_error for a null or destroyed handle
+    [[nodiscard]] const BufferResource& get(BufferHandle handle) const;
+    [[nodiscard]] const ImageResource& get(ImageHandle handle) const;
+    [[nodiscard]] vk::Fence get(FenceHandle handle) const;
+    [[nodiscard]] vk::Semaphore get(SemaphoreHandle handle) const;
+
+    void copyToBuffer(BufferHandle handle, std::span<const std::byte> data);
+
+    void waitForFences(std::span<const FenceHandle> fences);
+
+    void resetFences(std::span<const FenceHandle> fences);
+
+    void submit(const Queue& queue, CommandBuffer commandBuffer, SemaphoreHandle waitSemaphore,
+                SemaphoreHandle signalSemaphore, FenceHandle fence) const;
+
     void waitIdle() const;
 
     void recreateSwapChain(std::shared_ptr<SwapChain>& swapChain, std::shared_ptr<Framebuffers>& framebuffers,
@@ -464,6 +533,11 @@ struct LogicalDevice : public std::enable_shared_from_this<LogicalDevice> {
                            uint32_t bufferCount);
 
     std::shared_ptr<PhysicalDevice> physicalDevice;
+
+    cr::util::slot_map<BufferResource> bufferResources;
+    cr::util::slot_map<ImageResource> imageResources;
+    cr::util::slot_map<vk::Fence> fenceResources;
+    cr::util::slot_map<vk::Semaphore> semaphoreResources;
 };
 
 struct PhysicalDevice : public std::enable_shared_from_this<PhysicalDevice> {
@@ -532,7 +606,16 @@ void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_
                           const std::shared_ptr<SwapChain>& swapChain, vk::Framebuffer& framebuffer,
                           size_t count, const std::span<std::shared_ptr<Buffer>>& vertexBuffers = {},
                           const std::shared_ptr<Buffer>& indexBuffer = nullptr,
-                          vk::DescriptorSet descriptorSet = nullptr);
+                          vk::DescriptorSet descriptorSet = nullptr,
+                          vk::IndexType indexType = vk::IndexType::eUint32);
+
+// the buffers are resolved through pipeline->logicalDevice
+void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_ptr<Pipeline>& pipeline,
+                          const std::shared_ptr<SwapChain>& swapChain, vk::Framebuffer& framebuffer,
+                          size_t count, std::span<const BufferHandle> vertexBuffers,
+                          BufferHandle indexBuffer = {},
+                          vk::DescriptorSet descriptorSet = nullptr,
+                          vk::IndexType indexType = vk::IndexType::eUint32);
 
 template<size_t InFlightCount = 1>
 struct InFlightSwap {
@@ -578,9 +661,18 @@ struct InFlightSwap {
     ~InFlightSwap() = default;
 
     void update(bool resized = false) {
+        CR_TRACE_FRAME();
+        CR_TRACE_SCOPE("InFlightSwap::update");
         int index = currentFrame % InFlightCount;
-        inFlightFences[index]->wait();
-        auto image_opt = swapChain->acquireNextImage(imageAvailableSemaphores[index]);
+        {
+            CR_TRACE_SCOPE("wait for frame in flight");
+            inFlightFences[index]->wait();
+        }
+        std::optional<uint32_t> image_opt;
+        {
+            CR_TRACE_SCOPE("acquire image");
+            image_opt = swapChain->acquireNextImage(imageAvailableSemaphores[index]);
+        }
         if (!image_opt) {
             recreateSwapChainCallback();
             return;
@@ -603,14 +695,25 @@ struct InFlightSwap {
             }
             return {commandBufferArray.data(), count};
         };
-        auto resultCommandBuffers = recordCommandBufferCallback(func, *image_opt, uniformPool, index);
-        for (auto command : resultCommandBuffers) {
-            swapChain->logicalDevice->graphicsQueue->submit(command,
-                                                            imageAvailableSemaphores[index],
-                                                            renderFinishedSemaphores[index],
-                                                            inFlightFences[index]);
+        std::span<CommandBuffer> resultCommandBuffers;
+        {
+            CR_TRACE_SCOPE("record");
+            resultCommandBuffers = recordCommandBufferCallback(func, *image_opt, uniformPool, index);
+        }
+        {
+            CR_TRACE_SCOPE("submit");
+            for (auto command : resultCommandBuffers) {
+                swapChain->logicalDevice->graphicsQueue->submit(command,
+                                                                imageAvailableSemaphores[index],
+                                                                renderFinishedSemaphores[index],
+                                                                inFlightFences[index]);
+            }
+        }
+        bool success;
+        {
+            CR_TRACE_SCOPE("present");
+            success = swapChain->present(renderFinishedSemaphores[index], image_opt.value());
         }
-        auto success = swapChain->present(renderFinishedSemaphores[index], image_opt.value());
         if (!success || resized) {
             recreateSwapChainCallback();
         }
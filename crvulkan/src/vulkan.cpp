@@ -5,10 +5,13 @@
 #include "vulkan.h"
 #include "GLFW/glfw3.h"
 #include "crutil/comptime.h"
+#include "crutil/file.h"
+#include "crutil/flat_hash_map.h"
+#include "crutil/hashed_string.h"
+#include "crutil/small_vector.h"
 #include "window.h"
 #include <iostream>
 #include <limits>
-#include <map>
 #include <set>
 
 static constexpr std::array<const char*, 1> validationLayers = {
@@ -23,16 +26,17 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(VkDebugUtilsMessageSeverityF
     return VK_FALSE;
 }
 
-static std::map<std::string, void (*)()> functionPointers;
+static cr::util::flat_hash_map<cr::util::hashed_string, PFN_vkVoidFunction> functionPointers;
 
 template<typename Res = void, typename... Args>
-Res proxyCall(const cr::vulkan::Instance& instance, const char* funcName, Args... args) {
-    if (functionPointers.find(funcName) == functionPointers.end()) {
-        functionPointers[funcName] = vkGetInstanceProcAddr(instance.instance, funcName);
+Res proxyCall(const cr::vulkan::Instance& instance, cr::util::hashed_string funcName, Args... args) {
+    auto [it, inserted] = functionPointers.try_emplace(funcName);
+    if (inserted) {
+        it->second = vkGetInstanceProcAddr(instance.instance, funcName.c_str());
     }
-    auto func = reinterpret_cast<Res (*)(Args...)>(functionPointers[funcName]);
+    auto func = reinterpret_cast<Res (*)(Args...)>(it->second);
     if (func == nullptr) {
-        throw std::runtime_error("Failed to load function pointer for " + std::string(funcName));
+        throw std::runtime_error("Failed to load function pointer for " + std::string(funcName.view()));
     }
     return func(args...);
 }
@@ -218,6 +222,15 @@ std::string PhysicalDevice::getDeviceName() const {
 }
 
 LogicalDevice::~LogicalDevice() {
+    // resources still held by handles may be in use by command buffers in flight
+    if (device && !(bufferResources.empty() && imageResources.empty() && fenceResources.empty() &&
+                    semaphoreResources.empty())) {
+        device.waitIdle();
+    }
+    while (!bufferResources.empty()) destroy(bufferResources.handle_at(0));
+    while (!imageResources.empty()) destroy(imageResources.handle_at(0));
+    while (!fenceResources.empty()) destroy(fenceResources.handle_at(0));
+    while (!semaphoreResources.empty()) destroy(semaphoreResources.handle_at(0));
     if (device)
         device.destroy();
 }
@@ -246,11 +259,16 @@ ShaderModule::~ShaderModule() {
 }
 
 std::shared_ptr<ShaderModule> LogicalDevice::createShaderModule(const std::vector<char>& bytecode) {
+    return createShaderModule(std::as_bytes(std::span(bytecode)));
+}
+
+std::shared_ptr<ShaderModule> LogicalDevice::createShaderModule(std::span<const std::byte> bytecode) {
+    auto code = cr::util::view_as<uint32_t>(bytecode);
     auto shaderModule = std::make_shared<ShaderModule>();
     shaderModule->logicalDevice = shared_from_this();
     vk::ShaderModuleCreateInfo createInfo;
-    createInfo.codeSize = bytecode.size();
-    createInfo.pCode = reinterpret_cast<const uint32_t*>(bytecode.data());
+    createInfo.codeSize = code.size_bytes();
+    createInfo.pCode = code.data();
     auto res = device.createShaderModule(&createInfo, nullptr, &shaderModule->shaderModule);
     if (res != vk::Result::eSuccess) {
         throw std::runtime_error("failed to create shader module!");
@@ -358,53 +376,49 @@ void CommandPool::freeCommandBuffer(CommandBuffer& commandBuffer) {
     logicalDevice->device.freeCommandBuffers(commandPool, commandBuffer);
 }
 
-void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_ptr<Pipeline>& pipeline,
-                          const std::shared_ptr<SwapChain>& swapChain, vk::Framebuffer& framebuffer,
-                          size_t count, const std::span<std::shared_ptr<Buffer>>& vertexBuffers,
-                          const std::shared_ptr<Buffer>& indexBuffer, vk::DescriptorSet descriptorSet) {
+static void recordCommandBuffer(const CommandBuffer& commandBuffer, const Pipeline& pipeline,
+                                const SwapChain& swapChain, vk::Framebuffer& framebuffer, size_t count,
+                                std::span<const vk::Buffer> vertexBuffers, vk::Buffer indexBuffer,
+                                vk::DescriptorSet descriptorSet, vk::IndexType indexType) {
     vk::CommandBufferBeginInfo beginInfo;
     beginInfo.flags = vk::CommandBufferUsageFlagBits(0);
     beginInfo.pInheritanceInfo = nullptr;
 
     commandBuffer.begin(beginInfo);
     vk::RenderPassBeginInfo renderPassInfo;
-    renderPassInfo.renderPass = pipeline->renderPass;
+    renderPassInfo.renderPass = pipeline.renderPass;
     renderPassInfo.framebuffer = framebuffer;
     renderPassInfo.renderArea.offset = vk::Offset2D(0, 0);
-    renderPassInfo.renderArea.extent = swapChain->extent;
+    renderPassInfo.renderArea.extent = swapChain.extent;
     vk::ClearValue clearColor;
     clearColor.color = {0.0f, 0.0f, 0.0f, 1.0f};
     renderPassInfo.clearValueCount = 1;
     renderPassInfo.pClearValues = &clearColor;
     commandBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
-    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->pipeline);
+    commandBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline.pipeline);
     vk::Viewport viewport;
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = (float) swapChain->extent.width;
-    viewport.height = (float) swapChain->extent.height;
+    viewport.width = (float) swapChain.extent.width;
+    viewport.height = (float) swapChain.extent.height;
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
     commandBuffer.setViewport(0, viewport);
     vk::Rect2D scissor;
     scissor.offset = vk::Offset2D(0, 0);
-    scissor.extent = swapChain->extent;
+    scissor.extent = swapChain.extent;
     commandBuffer.setScissor(0, scissor);
 
     if (descriptorSet) {
-        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->pipelineLayout, 0, descriptorSet, nullptr);
+        commandBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline.pipelineLayout, 0, descriptorSet, nullptr);
     }
 
     if (!vertexBuffers.empty()) {
-        std::vector<vk::DeviceSize> offsets(vertexBuffers.size(), 0);
-        std::vector<vk::Buffer> buffers(vertexBuffers.size());
-        for (size_t i = 0; i < vertexBuffers.size(); i++) {
-            buffers[i] = vertexBuffers[i]->buffer;
-        }
-        commandBuffer.bindVertexBuffers(0, buffers, offsets);
+        cr::util::small_vector<vk::DeviceSize, 8> offsets(vertexBuffers.size(), 0);
+        commandBuffer.bindVertexBuffers(0, uint32_t(vertexBuffers.size()), vertexBuffers.data(), offsets.data());
     }
     if (indexBuffer) {
-        commandBuffer.bindIndexBuffer(indexBuffer->buffer, 0, vk::IndexType::eUint32);
+        commandBuffer.bindIndexBuffer(indexBuffer, 0, indexType);
         commandBuffer.drawIndexed(count, 1, 0, 0, 0);
     } else {
         commandBuffer.draw(count, 1, 0, 0);
@@ -413,6 +427,32 @@ void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_
     commandBuffer.end();
 }
 
+void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_ptr<Pipeline>& pipeline,
+                          const std::shared_ptr<SwapChain>& swapChain, vk::Framebuffer& framebuffer,
+                          size_t count, const std::span<std::shared_ptr<Buffer>>& vertexBuffers,
+                          const std::shared_ptr<Buffer>& indexBuffer, vk::DescriptorSet descriptorSet,
+                          vk::IndexType indexType) {
+    cr::util::small_vector<vk::Buffer, 8> buffers;
+    for (const auto& vertexBuffer : vertexBuffers) {
+        buffers.push_back(vertexBuffer->buffer);
+    }
+    recordCommandBuffer(commandBuffer, *pipeline, *swapChain, framebuffer, count, buffers,
+                        indexBuffer ? indexBuffer->buffer : nullptr, descriptorSet, indexType);
+}
+
+void prepareCommandBuffer(const CommandBuffer& commandBuffer, const std::shared_ptr<Pipeline>& pipeline,
+                          const std::shared_ptr<SwapChain>& swapChain, vk::Framebuffer& framebuffer,
+                          size_t count, std::span<const BufferHandle> vertexBuffers, BufferHandle indexBuffer,
+                          vk::DescriptorSet descriptorSet, vk::IndexType indexType) {
+    const auto& logicalDevice = *pipeline->logicalDevice;
+    cr::util::small_vector<vk::Buffer, 8> buffers;
+    for (auto vertexBuffer : vertexBuffers) {
+        buffers.push_back(logicalDevice.get(vertexBuffer).buffer);
+    }
+    recordCommandBuffer(commandBuffer, *pipeline, *swapChain, framebuffer, count, buffers,
+                        indexBuffer ? logicalDevice.get(indexBuffer).buffer : nullptr, descriptorSet, indexType);
+}
+
 Semaphore::~Semaphore() {
     logicalDevice->device.destroySemaphore(semaphore);
 }
@@ -440,11 +480,70 @@ std::shared_ptr<Semaphore> LogicalDevice::createSemaphore() {
     return semaphore;
 }
 
+FenceHandle LogicalDevice::createFenceHandle(bool signaled) {
+    vk::FenceCreateInfo fenceInfo;
+    fenceInfo.flags = signaled ? vk::FenceCreateFlagBits::eSignaled : vk::FenceCreateFlagBits(0);
+    return fenceResources.insert(device.createFence(fenceInfo));
+}
+
+SemaphoreHandle LogicalDevice::createSemaphoreHandle() {
+    return semaphoreResources.insert(device.createSemaphore(vk::SemaphoreCreateInfo()));
+}
+
+void LogicalDevice::destroy(FenceHandle handle) {
+    if (auto* fence = fenceResources.get(handle)) {
+        device.destroyFence(*fence);
+        fenceResources.erase(handle);
+    }
+}
+
+void LogicalDevice::destroy(SemaphoreHandle handle) {
+    if (auto* semaphore = semaphoreResources.get(handle)) {
+        device.destroySemaphore(*semaphore);
+        semaphoreResources.erase(handle);
+    }
+}
+
+vk::Fence LogicalDevice::get(FenceHandle handle) const {
+    auto* fence = fenceResources.get(handle);
+    if (fence == nullptr) throw std::runtime_error("invalid fence handle");
+    return *fence;
+}
+
+vk::Semaphore LogicalDevice::get(SemaphoreHandle handle) const {
+    auto* semaphore = semaphoreResources.get(handle);
+    if (semaphore == nullptr) throw std::runtime_error("invalid semaphore handle");
+    return *semaphore;
+}
+
+void LogicalDevice::waitForFences(std::span<const FenceHandle> fences) {
+    if (fences.empty()) return;
+    cr::util::small_vector<vk::Fence, 8> raw;
+    for (auto fence : fences) {
+        raw.push_back(get(fence));
+    }
+    auto res = device.waitForFences(uint32_t(raw.size()), raw.data(), true, UINT64_MAX);
+    if (res != vk::Result::eSuccess) throw std::runtime_error("failed to wait for fences");
+}
+
+void LogicalDevice::resetFences(std::span<const FenceHandle> fences) {
+    if (fences.empty()) return;
+    cr::util::small_vector<vk::Fence, 8> raw;
+    for (auto fence : fences) {
+        raw.push_back(get(fence));
+    }
+    device.resetFences(uint32_t(raw.size()), raw.data());
+}
+
 void Fence::wait() {
     auto res = logicalDevice->device.waitForFences(fence, true, UINT64_MAX);
     if (res != vk::Result::eSuccess) throw std::runtime_error("failed to wait for fence");
 }
 
+bool Fence::ready() const {
+    return logicalDevice->device.getFenceStatus(fence) == vk::Result::eSuccess;
+}
+
 void Fence::reset() {
     logicalDevice->device.resetFences(fence);
 }
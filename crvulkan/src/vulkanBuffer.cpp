@@ -3,30 +3,71 @@
 //
 
 #include "vulkan.h"
+#include "crutil/small_vector.h"
 
 namespace cr::vulkan {
 
-std::shared_ptr<Buffer> LogicalDevice::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
-    auto buffer = std::make_shared<Buffer>();
-    buffer->logicalDevice = shared_from_this();
+static BufferResource allocateBuffer(LogicalDevice& logicalDevice, vk::DeviceSize size, vk::BufferUsageFlags usage,
+                                     vk::MemoryPropertyFlags properties) {
+    auto& device = logicalDevice.device;
+    BufferResource resource;
     vk::BufferCreateInfo bufferInfo;
     bufferInfo.size = size;
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = vk::SharingMode::eExclusive;
-    auto b = device.createBuffer(bufferInfo);
-    buffer->buffer = b;
-    buffer->size = size;
+    resource.buffer = device.createBuffer(bufferInfo);
+    resource.size = size;
 
-    auto memRequirements = device.getBufferMemoryRequirements(buffer->buffer);
+    auto memRequirements = device.getBufferMemoryRequirements(resource.buffer);
     vk::MemoryAllocateInfo allocInfo;
     allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-    auto m = device.allocateMemory(allocInfo);
-    buffer->memory = m;
-    device.bindBufferMemory(buffer->buffer, buffer->memory, 0);
+    allocInfo.memoryTypeIndex = logicalDevice.findMemoryType(memRequirements.memoryTypeBits, properties);
+    resource.memory = device.allocateMemory(allocInfo);
+    device.bindBufferMemory(resource.buffer, resource.memory, 0);
+    return resource;
+}
+
+static void copyToMemory(const vk::Device& device, vk::DeviceMemory memory, std::span<const std::byte> data) {
+    void* ptr = nullptr;
+    auto res = device.mapMemory(memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags(), &ptr);
+    if (res != vk::Result::eSuccess) throw std::runtime_error("failed to map memory");
+    memcpy(ptr, data.data(), data.size());
+    device.flushMappedMemoryRanges(vk::MappedMemoryRange(memory, 0, VK_WHOLE_SIZE));
+    device.unmapMemory(memory);
+}
+
+std::shared_ptr<Buffer> LogicalDevice::createBuffer(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
+    auto buffer = std::make_shared<Buffer>();
+    buffer->logicalDevice = shared_from_this();
+    auto resource = allocateBuffer(*this, size, usage, properties);
+    buffer->buffer = resource.buffer;
+    buffer->memory = resource.memory;
+    buffer->size = resource.size;
     return buffer;
 }
 
+BufferHandle LogicalDevice::createBufferHandle(vk::DeviceSize size, vk::BufferUsageFlags usage, vk::MemoryPropertyFlags properties) {
+    return bufferResources.insert(allocateBuffer(*this, size, usage, properties));
+}
+
+void LogicalDevice::destroy(BufferHandle handle) {
+    if (auto* resource = bufferResources.get(handle)) {
+        device.destroyBuffer(resource->buffer);
+        device.freeMemory(resource->memory);
+        bufferResources.erase(handle);
+    }
+}
+
+const BufferResource& LogicalDevice::get(BufferHandle handle) const {
+    auto* resource = bufferResources.get(handle);
+    if (resource == nullptr) throw std::runtime_error("invalid buffer handle");
+    return *resource;
+}
+
+void LogicalDevice::copyToBuffer(BufferHandle handle, std::span<const std::byte> data) {
+    copyToMemory(device, get(handle).memory, data);
+}
+
 //----------------------------------------------------------------------
 
 Buffer::~Buffer() {
@@ -35,15 +76,12 @@ Buffer::~Buffer() {
 }
 
 void Buffer::copyToBuffer(const std::span<const std::byte>& data) {
-    void* ptr = nullptr;
-    auto res = logicalDevice->device.mapMemory(memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags(), &ptr);
-    if (res != vk::Result::eSuccess) throw std::runtime_error("failed to map memory");
-    memcpy(ptr, data.data(), data.size());
-    logicalDevice->device.flushMappedMemoryRanges(vk::MappedMemoryRange(memory, 0, VK_WHOLE_SIZE));
-    logicalDevice->device.unmapMemory(memory);
+    copyToMemory(logicalDevice->device, memory, data);
 }
 
 std::shared_ptr<StagingBufferUpload> Buffer::copyToBufferUsingStagingBuffer(const std::span<const std::byte>& data, const std::shared_ptr<CommandPool>& commandPool) {
+    CR_TRACE_SCOPE("Buffer::copyToBufferUsingStagingBuffer");
+    CR_TRACE_COUNTER("staging upload bytes", data.size());
     auto stagingBuffer = logicalDevice->createBuffer(data.size(), vk::BufferUsageFlagBits::eTransferSrc,
                                                      vk::MemoryPropertyFlagBits::eHostVisible |
                                                              vk::MemoryPropertyFlagBits::eHostCoherent);
@@ -101,16 +139,23 @@ StagingBufferUpload::~StagingBufferUpload() {
     commandPool->freeCommandBuffer(commandBuffer);
 }
 void StagingBufferUpload::wait() {
+    CR_TRACE_SCOPE("StagingBufferUpload::wait");
     fence->wait();
 }
 
+bool StagingBufferUpload::ready() const {
+    return fence->ready();
+}
+
 void StagingBufferUpload::waitAll(const std::span<std::shared_ptr<cr::vulkan::StagingBufferUpload>>& uploads) {
     if (uploads.empty()) return;
-    std::vector<vk::Fence> fences;
+    CR_TRACE_SCOPE("StagingBufferUpload::waitAll");
+    cr::util::small_vector<vk::Fence, 8> fences;
     for (auto& upload : uploads) {
         fences.push_back(upload->fence->fence);
     }
-    auto res = uploads[0]->commandPool->logicalDevice->device.waitForFences(fences, true, UINT64_MAX);
+    auto res = uploads[0]->commandPool->logicalDevice->device.waitForFences(uint32_t(fences.size()), fences.data(), true,
+                                                                            UINT64_MAX);
     if (res != vk::Result::eSuccess) throw std::runtime_error("failed to wait for fences");
 }
 
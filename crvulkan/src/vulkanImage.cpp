@@ -6,13 +6,13 @@
 
 namespace cr::vulkan {
 
-std::shared_ptr<Image> LogicalDevice::createImage(size_t width, size_t height, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties) {
-    auto image = std::make_shared<Image>();
-    image->logicalDevice = shared_from_this();
-
-    image->width = width;
-    image->height = height;
-    image->format = format;
+static ImageResource allocateImage(LogicalDevice& logicalDevice, size_t width, size_t height, vk::Format format,
+                                   vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties) {
+    auto& device = logicalDevice.device;
+    ImageResource resource;
+    resource.width = width;
+    resource.height = height;
+    resource.format = format;
 
     vk::ImageCreateInfo imageInfo;
     imageInfo.imageType = vk::ImageType::e2D;
@@ -28,17 +28,17 @@ std::shared_ptr<Image> LogicalDevice::createImage(size_t width, size_t height, v
     imageInfo.sharingMode = vk::SharingMode::eExclusive;
     imageInfo.samples = vk::SampleCountFlagBits::e1;
     imageInfo.flags = vk::ImageCreateFlags();
-    image->image = device.createImage(imageInfo);
+    resource.image = device.createImage(imageInfo);
 
-    vk::MemoryRequirements memRequirements = device.getImageMemoryRequirements(image->image);
+    vk::MemoryRequirements memRequirements = device.getImageMemoryRequirements(resource.image);
     vk::MemoryAllocateInfo allocInfo;
     allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-    image->memory = device.allocateMemory(allocInfo);
-    device.bindImageMemory(image->image, image->memory, 0);
+    allocInfo.memoryTypeIndex = logicalDevice.findMemoryType(memRequirements.memoryTypeBits, properties);
+    resource.memory = device.allocateMemory(allocInfo);
+    device.bindImageMemory(resource.image, resource.memory, 0);
 
     vk::ImageViewCreateInfo viewInfo;
-    viewInfo.image = image->image;
+    viewInfo.image = resource.image;
     viewInfo.viewType = vk::ImageViewType::e2D;
     viewInfo.format = format;
     viewInfo.subresourceRange.aspectMask = vk::ImageAspectFlagBits::eColor;
@@ -46,11 +46,44 @@ std::shared_ptr<Image> LogicalDevice::createImage(size_t width, size_t height, v
     viewInfo.subresourceRange.levelCount = 1;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
-    image->imageView = device.createImageView(viewInfo);
+    resource.imageView = device.createImageView(viewInfo);
 
+    return resource;
+}
+
+std::shared_ptr<Image> LogicalDevice::createImage(size_t width, size_t height, vk::Format format, vk::ImageTiling tiling, vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties) {
+    auto image = std::make_shared<Image>();
+    image->logicalDevice = shared_from_this();
+    auto resource = allocateImage(*this, width, height, format, tiling, usage, properties);
+    image->image = resource.image;
+    image->imageView = resource.imageView;
+    image->memory = resource.memory;
+    image->width = resource.width;
+    image->height = resource.height;
+    image->format = resource.format;
     return image;
 }
 
+ImageHandle LogicalDevice::createImageHandle(size_t width, size_t height, vk::Format format, vk::ImageTiling tiling,
+                                             vk::ImageUsageFlags usage, vk::MemoryPropertyFlags properties) {
+    return imageResources.insert(allocateImage(*this, width, height, format, tiling, usage, properties));
+}
+
+void LogicalDevice::destroy(ImageHandle handle) {
+    if (auto* resource = imageResources.get(handle)) {
+        device.destroyImageView(resource->imageView);
+        device.destroyImage(resource->image);
+        device.freeMemory(resource->memory);
+        imageResources.erase(handle);
+    }
+}
+
+const ImageResource& LogicalDevice::get(ImageHandle handle) const {
+    auto* resource = imageResources.get(handle);
+    if (resource == nullptr) throw std::runtime_error("invalid image handle");
+    return *resource;
+}
+
 //----------------------------------------------------------------------
 
 Image::~Image() {
@@ -60,6 +93,8 @@ Image::~Image() {
 }
 
 std::shared_ptr<StagingBufferUpload> Image::upload(const std::span<const std::byte>& data, const std::shared_ptr<CommandPool>& commandPool) {
+    CR_TRACE_SCOPE("Image::upload");
+    CR_TRACE_COUNTER("staging upload bytes", data.size());
     auto upload = std::make_shared<StagingBufferUpload>();
 
     auto commandBuffer = commandPool->createCommandBuffer();
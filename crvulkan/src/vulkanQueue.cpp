@@ -8,18 +8,31 @@ namespace cr::vulkan {
 
 //----------------------------------------------------------------------
 
-void Queue::submit(CommandBuffer commandBuffer, const std::shared_ptr<Semaphore>& waitSemaphore,
-                   const std::shared_ptr<Semaphore>& signalSemaphore, const std::shared_ptr<Fence>& fence) const {
+static void submitCommandBuffer(const vk::Queue& queue, CommandBuffer commandBuffer, vk::Semaphore waitSemaphore,
+                                vk::Semaphore signalSemaphore, vk::Fence fence) {
     vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput};
     vk::SubmitInfo submitInfo;
     submitInfo.waitSemaphoreCount = waitSemaphore ? 1 : 0;
-    submitInfo.pWaitSemaphores = waitSemaphore ? &waitSemaphore->semaphore : nullptr;
+    submitInfo.pWaitSemaphores = waitSemaphore ? &waitSemaphore : nullptr;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
     submitInfo.signalSemaphoreCount = signalSemaphore ? 1 : 0;
-    submitInfo.pSignalSemaphores = signalSemaphore ? &signalSemaphore->semaphore : nullptr;
-    queue.submit(submitInfo, fence ? fence->fence : nullptr);
+    submitInfo.pSignalSemaphores = signalSemaphore ? &signalSemaphore : nullptr;
+    queue.submit(submitInfo, fence);
+}
+
+void Queue::submit(CommandBuffer commandBuffer, const std::shared_ptr<Semaphore>& waitSemaphore,
+                   const std::shared_ptr<Semaphore>& signalSemaphore, const std::shared_ptr<Fence>& fence) const {
+    submitCommandBuffer(queue, commandBuffer, waitSemaphore ? waitSemaphore->semaphore : nullptr,
+                        signalSemaphore ? signalSemaphore->semaphore : nullptr, fence ? fence->fence : nullptr);
+}
+
+void LogicalDevice::submit(const Queue& queue, CommandBuffer commandBuffer, SemaphoreHandle waitSemaphore,
+                           SemaphoreHandle signalSemaphore, FenceHandle fence) const {
+    // null handles mean no semaphore or fence, like nullptr for the shared_ptr version
+    submitCommandBuffer(queue.queue, commandBuffer, waitSemaphore ? get(waitSemaphore) : nullptr,
+                        signalSemaphore ? get(signalSemaphore) : nullptr, fence ? get(fence) : nullptr);
 }
 
 void Queue::transferBuffer(const std::shared_ptr<Buffer>& from, const std::shared_ptr<Buffer>& to,